@@ -94,12 +94,21 @@ IF EXIST .\lib\win32\image.o              del .\lib\win32\image.o
 IF EXIST .\lib\win32\init.o               del .\lib\win32\init.o
 IF EXIST .\lib\win32\input.o              del .\lib\win32\input.o
 IF EXIST .\lib\win32\joystick.o           del .\lib\win32\joystick.o
+IF EXIST .\lib\win32\lockstat.o           del .\lib\win32\lockstat.o
+IF EXIST .\lib\win32\pack.o               del .\lib\win32\pack.o
+IF EXIST .\lib\win32\pool.o               del .\lib\win32\pool.o
+IF EXIST .\lib\win32\queue.o              del .\lib\win32\queue.o
+IF EXIST .\lib\win32\rwlock.o             del .\lib\win32\rwlock.o
+IF EXIST .\lib\win32\sync.o               del .\lib\win32\sync.o
+IF EXIST .\lib\win32\prefetch.o           del .\lib\win32\prefetch.o
 IF EXIST .\lib\win32\stream.o             del .\lib\win32\stream.o
 IF EXIST .\lib\win32\tga.o                del .\lib\win32\tga.o
 IF EXIST .\lib\win32\thread.o             del .\lib\win32\thread.o
+IF EXIST .\lib\win32\atomic.o             del .\lib\win32\atomic.o
 IF EXIST .\lib\win32\time.o               del .\lib\win32\time.o
 IF EXIST .\lib\win32\window.o             del .\lib\win32\window.o
 IF EXIST .\lib\win32\win32_enable.o       del .\lib\win32\win32_enable.o
+IF EXIST .\lib\win32\win32_file.o         del .\lib\win32\win32_file.o
 IF EXIST .\lib\win32\win32_fullscreen.o   del .\lib\win32\win32_fullscreen.o
 IF EXIST .\lib\win32\win32_glext.o        del .\lib\win32\win32_glext.o
 IF EXIST .\lib\win32\win32_init.o         del .\lib\win32\win32_init.o
@@ -115,13 +124,22 @@ IF EXIST .\lib\win32\image_dll.o          del .\lib\win32\image_dll.o
 IF EXIST .\lib\win32\init_dll.o           del .\lib\win32\init_dll.o
 IF EXIST .\lib\win32\input_dll.o          del .\lib\win32\input_dll.o
 IF EXIST .\lib\win32\joystick_dll.o       del .\lib\win32\joystick_dll.o
+IF EXIST .\lib\win32\lockstat_dll.o       del .\lib\win32\lockstat_dll.o
+IF EXIST .\lib\win32\pack_dll.o           del .\lib\win32\pack_dll.o
+IF EXIST .\lib\win32\pool_dll.o           del .\lib\win32\pool_dll.o
+IF EXIST .\lib\win32\queue_dll.o          del .\lib\win32\queue_dll.o
+IF EXIST .\lib\win32\rwlock_dll.o         del .\lib\win32\rwlock_dll.o
+IF EXIST .\lib\win32\sync_dll.o           del .\lib\win32\sync_dll.o
+IF EXIST .\lib\win32\prefetch_dll.o       del .\lib\win32\prefetch_dll.o
 IF EXIST .\lib\win32\stream_dll.o         del .\lib\win32\stream_dll.o
 IF EXIST .\lib\win32\tga_dll.o            del .\lib\win32\tga_dll.o
 IF EXIST .\lib\win32\thread_dll.o         del .\lib\win32\thread_dll.o
+IF EXIST .\lib\win32\atomic_dll.o         del .\lib\win32\atomic_dll.o
 IF EXIST .\lib\win32\time_dll.o           del .\lib\win32\time_dll.o
 IF EXIST .\lib\win32\window_dll.o         del .\lib\win32\window_dll.o
 IF EXIST .\lib\win32\win32_dllmain_dll.o    del .\lib\win32\win32_dllmain_dll.o
 IF EXIST .\lib\win32\win32_enable_dll.o     del .\lib\win32\win32_enable_dll.o
+IF EXIST .\lib\win32\win32_file_dll.o       del .\lib\win32\win32_file_dll.o
 IF EXIST .\lib\win32\win32_fullscreen_dll.o del .\lib\win32\win32_fullscreen_dll.o
 IF EXIST .\lib\win32\win32_glext_dll.o      del .\lib\win32\win32_glext_dll.o
 IF EXIST .\lib\win32\win32_init_dll.o       del .\lib\win32\win32_init_dll.o
@@ -137,12 +155,21 @@ IF EXIST .\lib\win32\image.obj            del .\lib\win32\image.obj
 IF EXIST .\lib\win32\init.obj             del .\lib\win32\init.obj
 IF EXIST .\lib\win32\input.obj            del .\lib\win32\input.obj
 IF EXIST .\lib\win32\joystick.obj         del .\lib\win32\joystick.obj
+IF EXIST .\lib\win32\lockstat.obj         del .\lib\win32\lockstat.obj
+IF EXIST .\lib\win32\pack.obj             del .\lib\win32\pack.obj
+IF EXIST .\lib\win32\pool.obj             del .\lib\win32\pool.obj
+IF EXIST .\lib\win32\queue.obj            del .\lib\win32\queue.obj
+IF EXIST .\lib\win32\rwlock.obj           del .\lib\win32\rwlock.obj
+IF EXIST .\lib\win32\sync.obj             del .\lib\win32\sync.obj
+IF EXIST .\lib\win32\prefetch.obj         del .\lib\win32\prefetch.obj
 IF EXIST .\lib\win32\stream.obj           del .\lib\win32\stream.obj
 IF EXIST .\lib\win32\tga.obj              del .\lib\win32\tga.obj
 IF EXIST .\lib\win32\thread.obj           del .\lib\win32\thread.obj
+IF EXIST .\lib\win32\atomic.obj           del .\lib\win32\atomic.obj
 IF EXIST .\lib\win32\time.obj             del .\lib\win32\time.obj
 IF EXIST .\lib\win32\window.obj           del .\lib\win32\window.obj
 IF EXIST .\lib\win32\win32_enable.obj     del .\lib\win32\win32_enable.obj
+IF EXIST .\lib\win32\win32_file.obj       del .\lib\win32\win32_file.obj
 IF EXIST .\lib\win32\win32_fullscreen.obj del .\lib\win32\win32_fullscreen.obj
 IF EXIST .\lib\win32\win32_glext.obj      del .\lib\win32\win32_glext.obj
 IF EXIST .\lib\win32\win32_init.obj       del .\lib\win32\win32_init.obj
@@ -158,13 +185,22 @@ IF EXIST .\lib\win32\image_dll.obj        del .\lib\win32\image_dll.obj
 IF EXIST .\lib\win32\init_dll.obj         del .\lib\win32\init_dll.obj
 IF EXIST .\lib\win32\input_dll.obj        del .\lib\win32\input_dll.obj
 IF EXIST .\lib\win32\joystick_dll.obj     del .\lib\win32\joystick_dll.obj
+IF EXIST .\lib\win32\lockstat_dll.obj     del .\lib\win32\lockstat_dll.obj
+IF EXIST .\lib\win32\pack_dll.obj         del .\lib\win32\pack_dll.obj
+IF EXIST .\lib\win32\pool_dll.obj         del .\lib\win32\pool_dll.obj
+IF EXIST .\lib\win32\queue_dll.obj        del .\lib\win32\queue_dll.obj
+IF EXIST .\lib\win32\rwlock_dll.obj       del .\lib\win32\rwlock_dll.obj
+IF EXIST .\lib\win32\sync_dll.obj         del .\lib\win32\sync_dll.obj
+IF EXIST .\lib\win32\prefetch_dll.obj     del .\lib\win32\prefetch_dll.obj
 IF EXIST .\lib\win32\stream_dll.obj       del .\lib\win32\stream_dll.obj
 IF EXIST .\lib\win32\tga_dll.obj          del .\lib\win32\tga_dll.obj
 IF EXIST .\lib\win32\thread_dll.obj       del .\lib\win32\thread_dll.obj
+IF EXIST .\lib\win32\atomic_dll.obj       del .\lib\win32\atomic_dll.obj
 IF EXIST .\lib\win32\time_dll.obj         del .\lib\win32\time_dll.obj
 IF EXIST .\lib\win32\window_dll.obj       del .\lib\win32\window_dll.obj
 IF EXIST .\lib\win32\win32_dllmain_dll.obj    del .\lib\win32\win32_dllmain_dll.obj
 IF EXIST .\lib\win32\win32_enable_dll.obj     del .\lib\win32\win32_enable_dll.obj
+IF EXIST .\lib\win32\win32_file_dll.obj       del .\lib\win32\win32_file_dll.obj
 IF EXIST .\lib\win32\win32_fullscreen_dll.obj del .\lib\win32\win32_fullscreen_dll.obj
 IF EXIST .\lib\win32\win32_glext_dll.obj      del .\lib\win32\win32_glext_dll.obj
 IF EXIST .\lib\win32\win32_init_dll.obj       del .\lib\win32\win32_init_dll.obj
@@ -232,6 +268,7 @@ IF EXIST .\tests\fsaa.exe                 del .\tests\fsaa.exe
 IF EXIST .\tests\fsinput.exe              del .\tests\fsinput.exe
 IF EXIST .\tests\iconify.exe              del .\tests\iconify.exe
 IF EXIST .\tests\joysticks.exe            del .\tests\joysticks.exe
+IF EXIST .\tests\pacing.exe               del .\tests\pacing.exe
 IF EXIST .\tests\peter.exe                del .\tests\peter.exe
 IF EXIST .\tests\reopen.exe               del .\tests\reopen.exe
 IF EXIST .\tests\tearing.exe              del .\tests\tearing.exe
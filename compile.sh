@@ -364,6 +364,166 @@ EOF
 fi
 
 
+##########################################################################
+# Check for thread-local storage (__thread) support
+##########################################################################
+if [ "x$has_pthread" = xyes ]; then
+
+  echo -n "Checking for __thread support... " 1>&6
+  echo "$self: Checking for __thread support" >&5
+  has_tls=no
+
+  cat > conftest.c <<EOF
+static __thread int tls_value = -1;
+int main() {tls_value = 0; return tls_value;}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_tls=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  echo "$has_tls" 1>&6
+
+  if [ "x$has_tls" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_TLS"
+  fi
+
+fi
+
+
+##########################################################################
+# Check for futex support (Linux)
+##########################################################################
+if [ "x$has_pthread" = xyes ]; then
+
+  echo -n "Checking for futex support... " 1>&6
+  echo "$self: Checking for futex support" >&5
+  has_futex=no
+
+  cat > conftest.c <<EOF
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+int main() {int word = 0; return syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0) < 0;}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_futex=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  echo "$has_futex" 1>&6
+
+  if [ "x$has_futex" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_FUTEX"
+  fi
+
+fi
+
+
+##########################################################################
+# Check for ucontext support (used for fibers)
+##########################################################################
+echo -n "Checking for ucontext support... " 1>&6
+echo "$self: Checking for ucontext support" >&5
+has_ucontext=no
+
+cat > conftest.c <<EOF
+#include <ucontext.h>
+static ucontext_t main_context, fiber_context;
+static char stack[65536];
+static void fiber(void) {swapcontext(&fiber_context, &main_context);}
+int main() {
+  getcontext(&fiber_context);
+  fiber_context.uc_stack.ss_sp = stack;
+  fiber_context.uc_stack.ss_size = sizeof(stack);
+  fiber_context.uc_link = 0;
+  makecontext(&fiber_context, fiber, 0);
+  return swapcontext(&main_context, &fiber_context);
+}
+EOF
+
+if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+  rm -f conftest*
+  has_ucontext=yes
+else
+  echo "$self: failed program was:" >&5
+  cat conftest.c >&5
+fi
+
+echo "$has_ucontext" 1>&6
+
+if [ "x$has_ucontext" = xyes ]; then
+  GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_UCONTEXT"
+fi
+
+
+##########################################################################
+# Check for prctl support (used for naming threads)
+##########################################################################
+echo -n "Checking for prctl support... " 1>&6
+echo "$self: Checking for prctl support" >&5
+has_prctl=no
+
+cat > conftest.c <<EOF
+#include <sys/prctl.h>
+int main() {return prctl(PR_SET_NAME, (unsigned long) "conftest", 0, 0, 0);}
+EOF
+
+if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+  rm -f conftest*
+  has_prctl=yes
+else
+  echo "$self: failed program was:" >&5
+  cat conftest.c >&5
+fi
+
+echo "$has_prctl" 1>&6
+
+if [ "x$has_prctl" = xyes ]; then
+  GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_PRCTL"
+fi
+
+
+##########################################################################
+# Check for per-thread sched_setaffinity support (Linux)
+##########################################################################
+if [ "x$has_pthread" = xyes ]; then
+
+  echo -n "Checking for sched_setaffinity support... " 1>&6
+  echo "$self: Checking for sched_setaffinity support" >&5
+  has_setaffinity=no
+
+  cat > conftest.c <<EOF
+#include <sys/syscall.h>
+#include <unistd.h>
+int main() {unsigned long mask[16] = {1}; return syscall(SYS_sched_setaffinity, syscall(SYS_gettid), sizeof(mask), mask) < 0;}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_setaffinity=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  echo "$has_setaffinity" 1>&6
+
+  if [ "x$has_setaffinity" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_SCHED_SETAFFINITY"
+  fi
+
+fi
+
+
 ##########################################################################
 # Check for clock_gettime support
 ##########################################################################
@@ -416,6 +576,114 @@ if [ "x$has_clock_gettime" = xyes ]; then
 fi
 
 
+##########################################################################
+# Check for monotonic timed waits (pthread_condattr_setclock and
+# clock_nanosleep)
+##########################################################################
+if [ "x$has_pthread" = xyes ] && [ "x$has_clock_gettime" = xyes ]; then
+
+  echo -n "Checking for monotonic timed waits... " 1>&6
+  echo "$self: Checking for monotonic timed waits" >&5
+  has_monotonic_wait=no
+
+  LFLAGS_OLD="$GLFW_LFLAGS"
+  GLFW_LFLAGS="$GLFW_LFLAGS $LFLAGS_CLOCK"
+
+  cat > conftest.c <<EOF
+#include <pthread.h>
+#include <time.h>
+int main() {pthread_condattr_t attr; struct timespec ts = {0, 0}; pthread_condattr_init(&attr); pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_monotonic_wait=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  GLFW_LFLAGS="$LFLAGS_OLD"
+
+  echo "$has_monotonic_wait" 1>&6
+
+  if [ "x$has_monotonic_wait" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_MONOTONIC_WAIT"
+  fi
+
+fi
+
+
+##########################################################################
+# Check for per-thread CPU-time clocks (pthread_getcpuclockid)
+##########################################################################
+if [ "x$has_pthread" = xyes ] && [ "x$has_clock_gettime" = xyes ]; then
+
+  echo -n "Checking for per-thread CPU-time clocks... " 1>&6
+  echo "$self: Checking for per-thread CPU-time clocks" >&5
+  has_thread_cputime=no
+
+  LFLAGS_OLD="$GLFW_LFLAGS"
+  GLFW_LFLAGS="$GLFW_LFLAGS $LFLAGS_CLOCK"
+
+  cat > conftest.c <<EOF
+#include <pthread.h>
+#include <time.h>
+int main() {clockid_t clock; struct timespec ts; if (pthread_getcpuclockid(pthread_self(), &clock) != 0) return 1; return clock_gettime(clock, &ts);}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_thread_cputime=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  GLFW_LFLAGS="$LFLAGS_OLD"
+
+  echo "$has_thread_cputime" 1>&6
+
+  if [ "x$has_thread_cputime" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_THREAD_CPUTIME"
+  fi
+
+fi
+
+
+##########################################################################
+# Check for kernel thread IDs (Linux), used to find a thread's entry in
+# /proc
+##########################################################################
+if [ "x$has_pthread" = xyes ]; then
+
+  echo -n "Checking for gettid support... " 1>&6
+  echo "$self: Checking for gettid support" >&5
+  has_gettid=no
+
+  cat > conftest.c <<EOF
+#include <sys/syscall.h>
+#include <unistd.h>
+int main() {return syscall(SYS_gettid) < 0;}
+EOF
+
+  if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+    rm -f conftest*
+    has_gettid=yes
+  else
+    echo "$self: failed program was:" >&5
+    cat conftest.c >&5
+  fi
+
+  echo "$has_gettid" 1>&6
+
+  if [ "x$has_gettid" = xyes ]; then
+    GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_GETTID"
+  fi
+
+fi
+
+
 ##########################################################################
 # Check for glXGetProcAddressXXX availability
 ##########################################################################
@@ -615,6 +883,38 @@ if [ "x$has_sysctl" = xyes ]; then
 fi
 
 
+##########################################################################
+# Check for io_uring support (Linux)
+##########################################################################
+echo -n "Checking for io_uring... " 1>&6
+echo "$self: Checking for io_uring" >&5
+has_io_uring=no
+
+cat > conftest.c <<EOF
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#ifndef __NR_io_uring_setup
+#error io_uring system calls not available
+#endif
+int main() {struct io_uring_params p; return IORING_OP_OPENAT + IORING_OP_READ + (int) sizeof(p);}
+EOF
+
+if { (eval echo $self: \"$link\") 1>&5; (eval $link) 2>&5; }; then
+  rm -rf conftest*
+  has_io_uring=yes
+else
+  echo "$self: failed program was:" >&5
+  cat conftest.c >&5
+fi
+rm -f conftest*
+
+echo "$has_io_uring" 1>&6
+
+if [ "x$has_io_uring" = xyes ]; then
+  GLFW_LIB_CFLAGS="$GLFW_LIB_CFLAGS -D_GLFW_HAS_IO_URING"
+fi
+
+
 ##########################################################################
 # Last chance to change the flags before file generation
 ##########################################################################
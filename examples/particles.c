@@ -98,11 +98,8 @@ int multithreading;
 struct {
     double    t;         // Time (s)
     float     dt;        // Time since last frame (s)
-    int       p_frame;   // Particle physics frame number
-    int       d_frame;   // Particle draw frame number
-    GLFWcond  p_done;    // Condition: particle physics done
-    GLFWcond  d_done;    // Condition: particle draw done
-    GLFWmutex particles_lock; // Particles data sharing mutex
+    GLFWsemaphore p_done; // Posted when particle physics is done
+    GLFWsemaphore d_done; // Posted when particle drawing is done
 } thread_sync;
 
 
@@ -456,19 +453,14 @@ void DrawParticles( double t, float dt )
     if( multithreading )
     {
         // Wait for particle physics thread to be done
-        glfwLockMutex( thread_sync.particles_lock );
-        while( running && thread_sync.p_frame <= thread_sync.d_frame )
+        while( running && !glfwWaitSemaphore( thread_sync.p_done, 0.1 ) )
         {
-            glfwWaitCond( thread_sync.p_done, thread_sync.particles_lock,
-                          0.1 );
+            // Check now and then whether the program is about to end
         }
 
         // Store the frame time and delta time for the physics thread
         thread_sync.t  = t;
         thread_sync.dt = dt;
-
-        // Update frame counter
-        thread_sync.d_frame ++;
     }
     else
     {
@@ -559,12 +551,10 @@ void DrawParticles( double t, float dt )
         pptr ++;
     }
 
-    // We are done with the particle data: Unlock mutex and signal physics
-    // thread
+    // We are done with the particle data: Let the physics thread go on
     if( multithreading )
     {
-        glfwUnlockMutex( thread_sync.particles_lock );
-        glfwSignalCond( thread_sync.d_done );
+        glfwPostSemaphore( thread_sync.d_done, 1 );
     }
 
     // Draw final batch of particles (if any)
@@ -937,14 +927,10 @@ void GLFWCALL PhysicsThreadFun( void *arg )
 {
     while( running )
     {
-        // Lock mutex
-        glfwLockMutex( thread_sync.particles_lock );
-
         // Wait for particle drawing to be done
-        while( running && thread_sync.p_frame > thread_sync.d_frame )
+        if( !glfwWaitSemaphore( thread_sync.d_done, 0.1 ) )
         {
-            glfwWaitCond( thread_sync.d_done, thread_sync.particles_lock,
-                          0.1 );
+            continue;
         }
 
         // No longer running?
@@ -956,12 +942,8 @@ void GLFWCALL PhysicsThreadFun( void *arg )
         // Update particles
         ParticleEngine( thread_sync.t, thread_sync.dt );
 
-        // Update frame counter
-        thread_sync.p_frame ++;
-
-        // Unlock mutex and signal drawing thread
-        glfwUnlockMutex( thread_sync.particles_lock );
-        glfwSignalCond( thread_sync.p_done );
+        // Signal drawing thread
+        glfwPostSemaphore( thread_sync.p_done, 1 );
     }
 }
 
@@ -1097,11 +1079,9 @@ int main( int argc, char **argv )
     // Init threading
     if( multithreading )
     {
-        thread_sync.p_frame = 0;
-        thread_sync.d_frame = 0;
-        thread_sync.particles_lock = glfwCreateMutex();
-        thread_sync.p_done = glfwCreateCond();
-        thread_sync.d_done = glfwCreateCond();
+        // Let the physics thread go first
+        thread_sync.p_done = glfwCreateSemaphore( 0 );
+        thread_sync.d_done = glfwCreateSemaphore( 1 );
         physics_thread = glfwCreateThread( PhysicsThreadFun, NULL );
     }
 
@@ -362,11 +362,27 @@ extern "C" {
 #define GLFW_SYSTEM_KEYS          0x00030004
 #define GLFW_KEY_REPEAT           0x00030005
 #define GLFW_AUTO_POLL_EVENTS     0x00030006
+#define GLFW_LOCK_PROFILING       0x00030007
 
 /* glfwWaitThread wait modes */
 #define GLFW_WAIT                 0x00040001
 #define GLFW_NOWAIT               0x00040002
 
+/* glfwCreateQueue modes */
+#define GLFW_QUEUE_SPSC           0x00060001
+#define GLFW_QUEUE_MPMC           0x00060002
+
+/* glfwCreateMutexEx modes */
+#define GLFW_MUTEX_ADAPTIVE       0x00070001
+#define GLFW_MUTEX_SYSTEM         0x00070002
+
+/* GLFWlockstats types */
+#define GLFW_LOCK_MUTEX           0x00080001
+#define GLFW_LOCK_COND            0x00080002
+
+/* Number of wait time ranges in GLFWlockstats histograms */
+#define GLFW_LOCK_HISTOGRAM_SIZE  24
+
 /* glfwGetJoystickParam tokens */
 #define GLFW_PRESENT              0x00050001
 #define GLFW_AXES                 0x00050002
@@ -377,6 +393,14 @@ extern "C" {
 #define GLFW_ORIGIN_UL_BIT        0x00000002
 #define GLFW_BUILD_MIPMAPS_BIT    0x00000004 /* Only for glfwLoadTexture2D */
 #define GLFW_ALPHA_MAP_BIT        0x00000008
+#define GLFW_EDGE_BLEED_BIT       0x00000010 /* Only for glfwBuildTextureAtlas */
+#define GLFW_SUBSAMPLE_2_BIT      0x00000020
+#define GLFW_SUBSAMPLE_4_BIT      0x00000040
+#define GLFW_SUBSAMPLE_8_BIT      0x00000080
+#define GLFW_PREFETCH_DECODE_BIT  0x00000100 /* Only for glfwPrefetchImages */
+
+/* Pack creation flags */
+#define GLFW_COMPRESS_BIT         0x00000001 /* Only for glfwCreatePack */
 
 /* Time spans longer than this (seconds) are considered to be infinity */
 #define GLFW_INFINITY 100000.0
@@ -400,6 +424,59 @@ typedef struct {
     unsigned char *Data;
 } GLFWimage;
 
+/* Texture atlas sub-image placement */
+typedef struct {
+    int X, Y, Width, Height;
+    float S0, T0, S1, T1;
+} GLFWatlasrect;
+
+/* Texture atlas information */
+typedef struct {
+    int Width, Height;
+    int Format;
+    int Count;
+    GLFWatlasrect *Rects;
+} GLFWatlas;
+
+/* Logical processor information */
+typedef struct {
+    int ID;
+    int Core, Package, Node;
+    int L2Group, L3Group;
+} GLFWprocessor;
+
+/* CPU topology information */
+typedef struct {
+    int Count;
+    int Cores, Packages, Nodes;
+    int L2Groups, L3Groups;
+    int Quota;
+    GLFWprocessor *Processors;
+} GLFWcputopology;
+
+/* Thread creation attributes */
+typedef struct {
+    int StackSize;
+    int Priority;
+    int Realtime;
+    int AffinityCount;
+    const int *Affinity;
+    const char *Name;
+} GLFWthreadattribs;
+
+/* Lock profiling statistics */
+typedef struct {
+    void *Lock;
+    int Type;
+    char Name[ 32 ];
+    int Acquisitions;
+    int Contended;
+    int Histogram[ GLFW_LOCK_HISTOGRAM_SIZE ];
+} GLFWlockstats;
+
+/* Image opened for reading tiles */
+typedef void * GLFWtiledimage;
+
 /* Thread ID */
 typedef int GLFWthread;
 
@@ -409,6 +486,30 @@ typedef void * GLFWmutex;
 /* Condition variable object */
 typedef void * GLFWcond;
 
+/* Thread pool object */
+typedef void * GLFWpool;
+
+/* Counter object */
+typedef void * GLFWcounter;
+
+/* Task graph object */
+typedef void * GLFWtaskgraph;
+
+/* Queue object */
+typedef void * GLFWqueue;
+
+/* Reader-writer lock object */
+typedef void * GLFWrwlock;
+
+/* Sequence lock object */
+typedef void * GLFWseqlock;
+
+/* Semaphore object */
+typedef void * GLFWsemaphore;
+
+/* Barrier object */
+typedef void * GLFWbarrier;
+
 /* Function pointer types */
 typedef void (GLFWCALL * GLFWwindowsizefun)(int,int);
 typedef int  (GLFWCALL * GLFWwindowclosefun)(void);
@@ -419,6 +520,22 @@ typedef void (GLFWCALL * GLFWmousewheelfun)(int);
 typedef void (GLFWCALL * GLFWkeyfun)(int,int);
 typedef void (GLFWCALL * GLFWcharfun)(int,int);
 typedef void (GLFWCALL * GLFWthreadfun)(void *);
+typedef void (GLFWCALL * GLFWjobfun)(void *);
+typedef void (GLFWCALL * GLFWforfun)(int,int,void *);
+typedef long (GLFWCALL * GLFWstreamreadfun)(void *,void *,long);
+typedef int  (GLFWCALL * GLFWstreamseekfun)(void *,long long,int);
+typedef long long (GLFWCALL * GLFWstreamtellfun)(void *);
+typedef void (GLFWCALL * GLFWstreamclosefun)(void *);
+typedef const void * (GLFWCALL * GLFWstreamborrowfun)(void *,long);
+
+/* User supplied stream I/O functions (Close and Borrow may be NULL) */
+typedef struct {
+    GLFWstreamreadfun   Read;
+    GLFWstreamseekfun   Seek;
+    GLFWstreamtellfun   Tell;
+    GLFWstreamclosefun  Close;
+    GLFWstreamborrowfun Borrow;
+} GLFWstreamfuns;
 
 
 /*************************************************************************
@@ -475,6 +592,8 @@ GLFWAPI int GLFWAPIENTRY glfwGetJoystickButtons( int joy, unsigned char *buttons
 GLFWAPI double GLFWAPIENTRY glfwGetTime( void );
 GLFWAPI void   GLFWAPIENTRY glfwSetTime( double time );
 GLFWAPI void   GLFWAPIENTRY glfwSleep( double time );
+GLFWAPI void   GLFWAPIENTRY glfwSleepPrecise( double time );
+GLFWAPI void   GLFWAPIENTRY glfwSleepUntil( double time );
 
 /* Extension support */
 GLFWAPI int   GLFWAPIENTRY glfwExtensionSupported( const char *extension );
@@ -483,19 +602,95 @@ GLFWAPI void  GLFWAPIENTRY glfwGetGLVersion( int *major, int *minor, int *rev );
 
 /* Threading support */
 GLFWAPI GLFWthread GLFWAPIENTRY glfwCreateThread( GLFWthreadfun fun, void *arg );
+GLFWAPI GLFWthread GLFWAPIENTRY glfwCreateThreadEx( GLFWthreadfun fun, void *arg, const GLFWthreadattribs *attribs );
 GLFWAPI void GLFWAPIENTRY glfwDestroyThread( GLFWthread ID );
 GLFWAPI int  GLFWAPIENTRY glfwWaitThread( GLFWthread ID, int waitmode );
 GLFWAPI GLFWthread GLFWAPIENTRY glfwGetThreadID( void );
+GLFWAPI double GLFWAPIENTRY glfwGetThreadCPUTime( GLFWthread ID );
+GLFWAPI int  GLFWAPIENTRY glfwGetThreadContextSwitches( GLFWthread ID, int *voluntary, int *involuntary );
 GLFWAPI GLFWmutex GLFWAPIENTRY glfwCreateMutex( void );
+GLFWAPI GLFWmutex GLFWAPIENTRY glfwCreateMutexEx( int mode );
 GLFWAPI void GLFWAPIENTRY glfwDestroyMutex( GLFWmutex mutex );
 GLFWAPI void GLFWAPIENTRY glfwLockMutex( GLFWmutex mutex );
 GLFWAPI void GLFWAPIENTRY glfwUnlockMutex( GLFWmutex mutex );
 GLFWAPI GLFWcond GLFWAPIENTRY glfwCreateCond( void );
 GLFWAPI void GLFWAPIENTRY glfwDestroyCond( GLFWcond cond );
 GLFWAPI void GLFWAPIENTRY glfwWaitCond( GLFWcond cond, GLFWmutex mutex, double timeout );
+GLFWAPI void GLFWAPIENTRY glfwWaitCondUntil( GLFWcond cond, GLFWmutex mutex, double time );
 GLFWAPI void GLFWAPIENTRY glfwSignalCond( GLFWcond cond );
 GLFWAPI void GLFWAPIENTRY glfwBroadcastCond( GLFWcond cond );
+GLFWAPI void GLFWAPIENTRY glfwSetMutexName( GLFWmutex mutex, const char *name );
+GLFWAPI void GLFWAPIENTRY glfwSetCondName( GLFWcond cond, const char *name );
+GLFWAPI int  GLFWAPIENTRY glfwGetLockStats( GLFWlockstats *list, int maxcount );
 GLFWAPI int  GLFWAPIENTRY glfwGetNumberOfProcessors( void );
+GLFWAPI int  GLFWAPIENTRY glfwGetCPUTopology( GLFWcputopology *topology );
+GLFWAPI void GLFWAPIENTRY glfwFreeCPUTopology( GLFWcputopology *topology );
+
+/* Atomic operations */
+GLFWAPI int  GLFWAPIENTRY glfwAtomicLoad( volatile int *p );
+GLFWAPI void GLFWAPIENTRY glfwAtomicStore( volatile int *p, int value );
+GLFWAPI int  GLFWAPIENTRY glfwAtomicAdd( volatile int *p, int value );
+GLFWAPI int  GLFWAPIENTRY glfwAtomicExchange( volatile int *p, int value );
+GLFWAPI int  GLFWAPIENTRY glfwAtomicCompareExchange( volatile int *p, int expected, int desired );
+GLFWAPI long long GLFWAPIENTRY glfwAtomicLoad64( volatile long long *p );
+GLFWAPI void GLFWAPIENTRY glfwAtomicStore64( volatile long long *p, long long value );
+GLFWAPI long long GLFWAPIENTRY glfwAtomicAdd64( volatile long long *p, long long value );
+GLFWAPI long long GLFWAPIENTRY glfwAtomicExchange64( volatile long long *p, long long value );
+GLFWAPI int  GLFWAPIENTRY glfwAtomicCompareExchange64( volatile long long *p, long long expected, long long desired );
+GLFWAPI void* GLFWAPIENTRY glfwAtomicLoadPtr( void * volatile *p );
+GLFWAPI void GLFWAPIENTRY glfwAtomicStorePtr( void * volatile *p, void *value );
+GLFWAPI void* GLFWAPIENTRY glfwAtomicExchangePtr( void * volatile *p, void *value );
+GLFWAPI int  GLFWAPIENTRY glfwAtomicCompareExchangePtr( void * volatile *p, void *expected, void *desired );
+GLFWAPI void GLFWAPIENTRY glfwAtomicFence( void );
+GLFWAPI void GLFWAPIENTRY glfwAtomicFenceAcquire( void );
+GLFWAPI void GLFWAPIENTRY glfwAtomicFenceRelease( void );
+
+/* Thread pools */
+GLFWAPI GLFWpool GLFWAPIENTRY glfwCreateThreadPool( int threads );
+GLFWAPI void GLFWAPIENTRY glfwDestroyThreadPool( GLFWpool pool );
+GLFWAPI int  GLFWAPIENTRY glfwSubmitJob( GLFWpool pool, GLFWjobfun fun, void *arg );
+GLFWAPI void GLFWAPIENTRY glfwWaitJobs( GLFWpool pool );
+GLFWAPI void GLFWAPIENTRY glfwParallelFor( GLFWpool pool, int begin, int end, int grain, GLFWforfun fun, void *arg );
+GLFWAPI GLFWtaskgraph GLFWAPIENTRY glfwCreateTaskGraph( void );
+GLFWAPI void GLFWAPIENTRY glfwDestroyTaskGraph( GLFWtaskgraph graph );
+GLFWAPI int  GLFWAPIENTRY glfwAddTask( GLFWtaskgraph graph, GLFWjobfun fun, void *arg );
+GLFWAPI int  GLFWAPIENTRY glfwAddTaskDependency( GLFWtaskgraph graph, int task, int dependency );
+GLFWAPI int  GLFWAPIENTRY glfwLaunchTaskGraph( GLFWtaskgraph graph, GLFWpool pool );
+GLFWAPI void GLFWAPIENTRY glfwWaitTaskGraph( GLFWtaskgraph graph );
+GLFWAPI GLFWcounter GLFWAPIENTRY glfwCreateCounter( int value );
+GLFWAPI void GLFWAPIENTRY glfwDestroyCounter( GLFWcounter counter );
+GLFWAPI int  GLFWAPIENTRY glfwAddCounter( GLFWcounter counter, int delta );
+GLFWAPI void GLFWAPIENTRY glfwWaitCounter( GLFWcounter counter );
+GLFWAPI void GLFWAPIENTRY glfwYieldFiber( void );
+
+/* Queues */
+GLFWAPI GLFWqueue GLFWAPIENTRY glfwCreateQueue( int capacity, int elemSize, int mode );
+GLFWAPI void GLFWAPIENTRY glfwDestroyQueue( GLFWqueue queue );
+GLFWAPI int  GLFWAPIENTRY glfwTryPushQueue( GLFWqueue queue, const void *elem );
+GLFWAPI int  GLFWAPIENTRY glfwTryPopQueue( GLFWqueue queue, void *elem );
+GLFWAPI int  GLFWAPIENTRY glfwPushQueue( GLFWqueue queue, const void *elem, double timeout );
+GLFWAPI int  GLFWAPIENTRY glfwPopQueue( GLFWqueue queue, void *elem, double timeout );
+
+/* Reader-writer and sequence locks */
+GLFWAPI GLFWrwlock GLFWAPIENTRY glfwCreateRWLock( void );
+GLFWAPI void GLFWAPIENTRY glfwDestroyRWLock( GLFWrwlock rwlock );
+GLFWAPI void GLFWAPIENTRY glfwLockRWLockRead( GLFWrwlock rwlock );
+GLFWAPI void GLFWAPIENTRY glfwUnlockRWLockRead( GLFWrwlock rwlock );
+GLFWAPI void GLFWAPIENTRY glfwLockRWLockWrite( GLFWrwlock rwlock );
+GLFWAPI void GLFWAPIENTRY glfwUnlockRWLockWrite( GLFWrwlock rwlock );
+GLFWAPI GLFWseqlock GLFWAPIENTRY glfwCreateSeqLock( int size );
+GLFWAPI void GLFWAPIENTRY glfwDestroySeqLock( GLFWseqlock seqlock );
+GLFWAPI void GLFWAPIENTRY glfwWriteSeqLock( GLFWseqlock seqlock, const void *data );
+GLFWAPI void GLFWAPIENTRY glfwReadSeqLock( GLFWseqlock seqlock, void *data );
+
+/* Semaphores and barriers */
+GLFWAPI GLFWsemaphore GLFWAPIENTRY glfwCreateSemaphore( int count );
+GLFWAPI void GLFWAPIENTRY glfwDestroySemaphore( GLFWsemaphore semaphore );
+GLFWAPI void GLFWAPIENTRY glfwPostSemaphore( GLFWsemaphore semaphore, int count );
+GLFWAPI int  GLFWAPIENTRY glfwWaitSemaphore( GLFWsemaphore semaphore, double timeout );
+GLFWAPI GLFWbarrier GLFWAPIENTRY glfwCreateBarrier( int count );
+GLFWAPI void GLFWAPIENTRY glfwDestroyBarrier( GLFWbarrier barrier );
+GLFWAPI int  GLFWAPIENTRY glfwWaitBarrier( GLFWbarrier barrier );
 
 /* Enable/disable functions */
 GLFWAPI void GLFWAPIENTRY glfwEnable( int token );
@@ -504,10 +699,28 @@ GLFWAPI void GLFWAPIENTRY glfwDisable( int token );
 /* Image/texture I/O support */
 GLFWAPI int  GLFWAPIENTRY glfwReadImage( const char *name, GLFWimage *img, int flags );
 GLFWAPI int  GLFWAPIENTRY glfwReadMemoryImage( const void *data, long size, GLFWimage *img, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwReadStreamImage( const GLFWstreamfuns *funs, void *user, GLFWimage *img, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwReadImageRegion( const char *name, int x, int y, int width, int height, GLFWimage *img, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwReadImages( const char **names, int count, GLFWimage *images, int flags );
+GLFWAPI void GLFWAPIENTRY glfwPrefetchImages( const char **names, int count, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwReadImageShared( const char *name, GLFWimage *img, int flags, int *handle );
+GLFWAPI int  GLFWAPIENTRY glfwMapSharedImage( int handle, GLFWimage *img );
 GLFWAPI void GLFWAPIENTRY glfwFreeImage( GLFWimage *img );
+GLFWAPI GLFWtiledimage GLFWAPIENTRY glfwOpenImageTiles( const char *name, int *width, int *height, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwReadImageTile( GLFWtiledimage image, int x, int y, int width, int height, GLFWimage *img );
+GLFWAPI void GLFWAPIENTRY glfwCloseImageTiles( GLFWtiledimage image );
 GLFWAPI int  GLFWAPIENTRY glfwLoadTexture2D( const char *name, int flags );
 GLFWAPI int  GLFWAPIENTRY glfwLoadMemoryTexture2D( const void *data, long size, int flags );
 GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwBuildTextureAtlas( const char **names, int count, int maxsize, int padding, int flags, GLFWatlas *atlas );
+GLFWAPI void GLFWAPIENTRY glfwFreeTextureAtlas( GLFWatlas *atlas );
+GLFWAPI int  GLFWAPIENTRY glfwLoadTextureArray( const char **names, int count, int flags );
+GLFWAPI int  GLFWAPIENTRY glfwLoadTextureCube( const char **names, int flags );
+
+/* Asset packs */
+GLFWAPI int  GLFWAPIENTRY glfwMountPack( const char *name );
+GLFWAPI void GLFWAPIENTRY glfwUnmountPack( const char *name );
+GLFWAPI int  GLFWAPIENTRY glfwCreatePack( const char *name, const char **files, int count, int flags );
 
 
 #ifdef __cplusplus
@@ -0,0 +1,238 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+//========================================================================
+// Description:
+//
+// Atomic operations on int, long long and pointer variables, for code
+// that shares data between threads without mutexes. These are thin
+// wrappers around the platform's atomic builtins. They need no state, so
+// unlike most GLFW functions they may be called before glfwInit.
+//
+// Loads have acquire semantics and stores release semantics. The
+// read-modify-write operations (add, exchange and compare-and-exchange)
+// are full barriers.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                    GLFW user functions                         ****
+//************************************************************************
+
+//========================================================================
+// Load an int
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicLoad( volatile int *p )
+{
+    return _glfwAtomicLoad( p );
+}
+
+
+//========================================================================
+// Store an int
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicStore( volatile int *p, int value )
+{
+    _glfwAtomicStore( p, value );
+}
+
+
+//========================================================================
+// Add to an int and return its previous value
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicAdd( volatile int *p, int value )
+{
+    return _glfwAtomicAdd( p, value );
+}
+
+
+//========================================================================
+// Replace an int and return its previous value
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicExchange( volatile int *p, int value )
+{
+    return _glfwAtomicExchange( p, value );
+}
+
+
+//========================================================================
+// Replace an int if it holds the expected value. Returns GL_TRUE if the
+// value was replaced.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicCompareExchange( volatile int *p,
+                                                    int expected,
+                                                    int desired )
+{
+    return _glfwAtomicCompareExchange( p, expected, desired ) ? GL_TRUE
+                                                              : GL_FALSE;
+}
+
+
+//========================================================================
+// Load a long long
+//========================================================================
+
+GLFWAPI long long GLFWAPIENTRY glfwAtomicLoad64( volatile long long *p )
+{
+    return _glfwAtomicLoad64( p );
+}
+
+
+//========================================================================
+// Store a long long
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicStore64( volatile long long *p,
+                                             long long value )
+{
+    _glfwAtomicStore64( p, value );
+}
+
+
+//========================================================================
+// Add to a long long and return its previous value
+//========================================================================
+
+GLFWAPI long long GLFWAPIENTRY glfwAtomicAdd64( volatile long long *p,
+                                                long long value )
+{
+    return _glfwAtomicAdd64( p, value );
+}
+
+
+//========================================================================
+// Replace a long long and return its previous value
+//========================================================================
+
+GLFWAPI long long GLFWAPIENTRY glfwAtomicExchange64( volatile long long *p,
+                                                     long long value )
+{
+    return _glfwAtomicExchange64( p, value );
+}
+
+
+//========================================================================
+// Replace a long long if it holds the expected value. Returns GL_TRUE if
+// the value was replaced.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicCompareExchange64( volatile long long *p,
+                                                      long long expected,
+                                                      long long desired )
+{
+    return _glfwAtomicCompareExchange64( p, expected, desired ) ? GL_TRUE
+                                                                : GL_FALSE;
+}
+
+
+//========================================================================
+// Load a pointer
+//========================================================================
+
+GLFWAPI void * GLFWAPIENTRY glfwAtomicLoadPtr( void * volatile *p )
+{
+    return _glfwAtomicLoadPtr( p );
+}
+
+
+//========================================================================
+// Store a pointer
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicStorePtr( void * volatile *p,
+                                              void *value )
+{
+    _glfwAtomicStorePtr( p, value );
+}
+
+
+//========================================================================
+// Replace a pointer and return its previous value
+//========================================================================
+
+GLFWAPI void * GLFWAPIENTRY glfwAtomicExchangePtr( void * volatile *p,
+                                                   void *value )
+{
+    return _glfwAtomicExchangePtr( p, value );
+}
+
+
+//========================================================================
+// Replace a pointer if it holds the expected value. Returns GL_TRUE if
+// the value was replaced.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAtomicCompareExchangePtr( void * volatile *p,
+                                                       void *expected,
+                                                       void *desired )
+{
+    return _glfwAtomicCompareExchangePtr( p, expected, desired ) ? GL_TRUE
+                                                                 : GL_FALSE;
+}
+
+
+//========================================================================
+// Full memory barrier: no loads or stores move across it
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicFence( void )
+{
+    _glfwAtomicFence();
+}
+
+
+//========================================================================
+// Acquire barrier: loads before it are ordered before all loads and
+// stores after it
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicFenceAcquire( void )
+{
+    _glfwAtomicFenceAcquire();
+}
+
+
+//========================================================================
+// Release barrier: all loads and stores before it are ordered before
+// stores after it
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwAtomicFenceRelease( void )
+{
+    _glfwAtomicFenceRelease();
+}
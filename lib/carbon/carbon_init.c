@@ -70,6 +70,11 @@ static void _glfwInitThreads( void )
     _glfwThrd.First.PosixID  = pthread_self();
     _glfwThrd.First.Previous = NULL;
     _glfwThrd.First.Next     = NULL;
+
+    // Remember the main thread's ID for glfwGetThreadID
+    (void) pthread_key_create( &_glfwThrd.IDKey, NULL );
+    (void) pthread_key_create( &_glfwThrd.DataKey, NULL );
+    _glfwSetThreadID( _glfwThrd.First.ID );
 }
 
 #define NO_BUNDLE_MESSAGE \
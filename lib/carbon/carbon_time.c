@@ -31,6 +31,10 @@
 
 #include "internal.h"
 
+#include <errno.h>
+#include <time.h>
+
+
 //************************************************************************
 //****               Platform implementation functions                ****
 //************************************************************************
@@ -67,47 +71,41 @@ void _glfwPlatformSetTime( double time )
 
 void _glfwPlatformSleep( double time )
 {
-    if( time == 0.0 )
+    struct timespec wait;
+
+    if( time <= 0.0 )
     {
-	sched_yield();
-	return;
+        sched_yield();
+        return;
     }
 
-    struct timeval  currenttime;
-    struct timespec wait;
-    pthread_mutex_t mutex;
-    pthread_cond_t  cond;
-    long dt_sec, dt_usec;
-
-    // Not all pthread implementations have a pthread_sleep() function. We
-    // do it the portable way, using a timed wait for a condition that we
-    // will never signal. NOTE: The unistd functions sleep/usleep suspends
-    // the entire PROCESS, not a signle thread, which is why we can not
-    // use them to implement glfwSleep.
-
-    // Set timeout time, relatvie to current time
-    gettimeofday( &currenttime, NULL );
-    dt_sec  = (long) time;
-    dt_usec = (long) ((time - (double)dt_sec) * 1000000.0);
-    wait.tv_nsec = (currenttime.tv_usec + dt_usec) * 1000L;
-    if( wait.tv_nsec > 1000000000L )
+    // Unlike sleep and usleep, nanosleep is required to suspend only the
+    // calling thread, and it needs no mutex or condition variable to do so
+    wait.tv_sec  = (time_t) time;
+    wait.tv_nsec = (long) ((time - (double) wait.tv_sec) * 1e9);
+
+    while( nanosleep( &wait, &wait ) == -1 && errno == EINTR )
     {
-        wait.tv_nsec -= 1000000000L;
-        dt_sec ++;
     }
-    wait.tv_sec  = currenttime.tv_sec + dt_sec;
+}
 
-    // Initialize condition and mutex objects
-    pthread_mutex_init( &mutex, NULL );
-    pthread_cond_init( &cond, NULL );
 
-    // Do a timed wait
-    pthread_mutex_lock( &mutex );
-    pthread_cond_timedwait( &cond, &mutex, &wait );
-    pthread_mutex_unlock( &mutex );
+//========================================================================
+// Make sleeps of the calling thread as precise as possible. Mac OS X has
+// no per-thread timer slack to tighten, so there is nothing to do here.
+//========================================================================
 
-    // Destroy condition and mutex objects
-    pthread_mutex_destroy( &mutex );
-    pthread_cond_destroy( &cond );
+int _glfwPlatformBeginPreciseSleep( void )
+{
+    return 0;
 }
 
+
+//========================================================================
+// Undo _glfwPlatformBeginPreciseSleep
+//========================================================================
+
+void _glfwPlatformEndPreciseSleep( int state )
+{
+    (void) state;
+}
@@ -244,12 +244,23 @@ struct _GLFWthread_struct {
     // Pointer to previous and next threads in linked list
     _GLFWthread   *Previous, *Next;
 
+    // Next thread in the same thread table bucket
+    _GLFWthread   *HashNext;
+
     // GLFW user side thread information
     GLFWthread    ID;
     GLFWthreadfun Function;
+    void          *Arg;
 
     // System side thread information
     pthread_t     PosixID;
+
+    // Attributes left for the new thread to apply, if any
+    GLFWthreadattribs *Attribs;
+
+    // Set when the thread function has returned; the thread stays in the
+    // thread list until _glfwPlatformWaitThread has joined it
+    int           Finished;
 };
 
 // General thread information
@@ -264,6 +275,12 @@ GLFWGLOBAL struct {
     // First thread in linked list (always the main thread)
     _GLFWthread      First;
 
+    // Key for the calling thread's GLFW ID plus one
+    pthread_key_t    IDKey;
+
+    // Key for the calling thread's internal data
+    pthread_key_t    DataKey;
+
 } _glfwThrd;
 
 
@@ -326,10 +343,53 @@ pthread_mutex_lock( &_glfwThrd.CriticalSection );
 pthread_mutex_unlock( &_glfwThrd.CriticalSection );
 
 
+//========================================================================
+// Atomic operations (GCC style builtins). The plain variants work on int
+// and pointer sized variables, the 64 variants on long long variables;
+// loads acquire, stores release and the read-modify-write operations are
+// full barriers.
+//========================================================================
+
+#define _glfwAtomicLoad( p )                __atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define _glfwAtomicLoadRelaxed( p )         __atomic_load_n( (p), __ATOMIC_RELAXED )
+#define _glfwAtomicStore( p, v )            __atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+#define _glfwAtomicStoreRelaxed( p, v )     __atomic_store_n( (p), (v), __ATOMIC_RELAXED )
+#define _glfwAtomicAdd( p, v )              __sync_fetch_and_add( (p), (v) )
+#define _glfwAtomicExchange( p, v )         __atomic_exchange_n( (p), (v), __ATOMIC_SEQ_CST )
+#define _glfwAtomicCompareExchange( p, e, d ) \
+        __sync_bool_compare_and_swap( (p), (e), (d) )
+#define _glfwAtomicLoadPtr( p )             _glfwAtomicLoad( p )
+#define _glfwAtomicStorePtr( p, v )         _glfwAtomicStore( p, v )
+#define _glfwAtomicCompareExchangePtr( p, e, d ) \
+        _glfwAtomicCompareExchange( p, e, d )
+#define _glfwAtomicExchangePtr( p, v )      _glfwAtomicExchange( p, v )
+#define _glfwAtomicLoad64( p )              _glfwAtomicLoad( p )
+#define _glfwAtomicStore64( p, v )          _glfwAtomicStore( p, v )
+#define _glfwAtomicAdd64( p, v )            _glfwAtomicAdd( p, v )
+#define _glfwAtomicExchange64( p, v )       _glfwAtomicExchange( p, v )
+#define _glfwAtomicCompareExchange64( p, e, d ) \
+        _glfwAtomicCompareExchange( p, e, d )
+#define _glfwAtomicFence()                  __sync_synchronize()
+#define _glfwAtomicFenceAcquire()           __atomic_thread_fence( __ATOMIC_ACQUIRE )
+#define _glfwAtomicFenceRelease()           __atomic_thread_fence( __ATOMIC_RELEASE )
+
+// Spin-wait hint
+#if defined(__i386__) || defined(__x86_64__)
+ #define _glfwAtomicPause()                 __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+ #define _glfwAtomicPause()                 __asm__ __volatile__( "yield" )
+#else
+ #define _glfwAtomicPause()
+#endif
+
+
 //========================================================================
 // Prototypes for platform specific internal functions
 //========================================================================
 
+// Threads
+void _glfwSetThreadID( GLFWthread ID );
+
 void  _glfwChangeToResourcesDirectory( void );
 void  _glfwSaveDesktopMode( void );
 
@@ -0,0 +1,258 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Cocoa/NSOpenGL
+// API Version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2009-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+//************************************************************************
+//****               Platform implementation functions                ****
+//************************************************************************
+
+//========================================================================
+// Map a whole file into memory for reading
+//========================================================================
+
+void * _glfwPlatformMapFile( const char *name, _GLFWoffset *size )
+{
+    struct stat st;
+    void *data;
+    int fd;
+
+    fd = open( name, O_RDONLY );
+    if( fd < 0 )
+    {
+        return NULL;
+    }
+
+    if( fstat( fd, &st ) != 0 || st.st_size <= 0 ||
+        (_GLFWoffset) (size_t) st.st_size != (_GLFWoffset) st.st_size )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    data = mmap( NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+    // The mapping stays valid after the descriptor is closed
+    close( fd );
+
+    if( data == MAP_FAILED )
+    {
+        return NULL;
+    }
+
+    *size = (_GLFWoffset) st.st_size;
+    return data;
+}
+
+
+//========================================================================
+// Unmap a file mapped with _glfwPlatformMapFile
+//========================================================================
+
+void _glfwPlatformUnmapFile( void *data, _GLFWoffset size )
+{
+    munmap( data, (size_t) size );
+}
+
+
+//========================================================================
+// Create a queue for reading whole files concurrently (not supported on
+// this platform, so image batches fall back on blocking reads)
+//========================================================================
+
+_GLFWfilequeue * _glfwPlatformOpenFileQueue( int depth )
+{
+    return NULL;
+}
+
+
+//========================================================================
+// Queue a whole file for reading
+//========================================================================
+
+int _glfwPlatformQueueFileRead( _GLFWfilequeue *queue, const char *name,
+                                int index )
+{
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Wait for any queued file to finish
+//========================================================================
+
+int _glfwPlatformWaitFileRead( _GLFWfilequeue *queue, int *index,
+                               void **data, _GLFWoffset *size )
+{
+    *index = -1;
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Destroy a file queue
+//========================================================================
+
+void _glfwPlatformCloseFileQueue( _GLFWfilequeue *queue )
+{
+}
+
+
+//========================================================================
+// Ask the system to start reading a file into the buffer cache
+//========================================================================
+
+void _glfwPlatformPrefetchFile( const char *name )
+{
+    struct radvisory advice;
+    struct stat st;
+    int fd;
+
+    fd = open( name, O_RDONLY );
+    if( fd < 0 )
+    {
+        return;
+    }
+
+    // The advisory count is an int, so very large files are only partly
+    // read ahead
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        advice.ra_offset = 0;
+        advice.ra_count  = st.st_size > 0x7fffffff ? 0x7fffffff :
+                                                     (int) st.st_size;
+        fcntl( fd, F_RDADVISE, &advice );
+    }
+
+    close( fd );
+}
+
+
+//========================================================================
+// Create a block of memory that can be shared with other processes
+// through the returned file descriptor
+//========================================================================
+
+void * _glfwPlatformCreateSharedMemory( size_t size, int *handle )
+{
+    static unsigned int counter = 0;
+    char name[ 64 ];
+    void *data;
+    int fd, tries;
+
+    // Create a uniquely named object, and unlink it right away so that
+    // only the descriptor refers to it
+    fd = -1;
+    for( tries = 0;  fd < 0 && tries < 16;  tries ++ )
+    {
+        sprintf( name, "/glfw-%d-%u", (int) getpid(), counter ++ );
+        fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+    }
+    if( fd < 0 )
+    {
+        return NULL;
+    }
+    shm_unlink( name );
+
+    if( ftruncate( fd, (off_t) size ) != 0 )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    data = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( data == MAP_FAILED )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    *handle = fd;
+    return data;
+}
+
+
+//========================================================================
+// Map shared memory created by another process
+//========================================================================
+
+void * _glfwPlatformMapSharedMemory( int handle, size_t *size )
+{
+    struct stat st;
+    void *data;
+
+    if( fstat( handle, &st ) != 0 || st.st_size <= 0 )
+    {
+        return NULL;
+    }
+
+    // Prefer a copy on write mapping, but not all kinds of shared memory
+    // objects support one
+    data = mmap( NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE, handle, 0 );
+    if( data == MAP_FAILED )
+    {
+        data = mmap( NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, handle, 0 );
+        if( data == MAP_FAILED )
+        {
+            return NULL;
+        }
+    }
+
+    *size = (size_t) st.st_size;
+    return data;
+}
+
+
+//========================================================================
+// Unmap shared memory
+//========================================================================
+
+void _glfwPlatformUnmapSharedMemory( void *data, size_t size )
+{
+    munmap( data, size );
+}
+
+
+//========================================================================
+// Close a shared memory handle
+//========================================================================
+
+void _glfwPlatformCloseSharedMemory( int handle )
+{
+    close( handle );
+}
@@ -31,38 +31,92 @@
 
 #include <sys/time.h>
 #include <sys/sysctl.h>
+#include <mach/mach.h>
 
 
 //************************************************************************
 //****                  GLFW internal functions                       ****
 //************************************************************************
 
+//========================================================================
+// _glfwSetThreadID() - Set the GLFW ID of the calling thread. The ID is
+// stored offset by one, so that the key's initial NULL value reads back
+// as -1.
+//========================================================================
+
+void _glfwSetThreadID( GLFWthread ID )
+{
+    (void) pthread_setspecific( _glfwThrd.IDKey, (void *) (ID + 1L) );
+}
+
+
+//========================================================================
+// ApplyThreadAttribs() - Apply the attributes a thread was created with
+// to the calling thread. Mac OS X has neither per-thread nice values nor
+// processor affinity, so those are ignored.
+//========================================================================
+
+static void ApplyThreadAttribs( const GLFWthreadattribs *attribs )
+{
+    struct sched_param param;
+    int                low, high;
+
+#if defined(MAC_OS_X_VERSION_10_6) && \
+    MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_6
+    if( attribs->Name != NULL )
+    {
+        (void) pthread_setname_np( attribs->Name );
+    }
+#endif
+
+    if( attribs->Realtime )
+    {
+        low  = sched_get_priority_min( SCHED_FIFO );
+        high = sched_get_priority_max( SCHED_FIFO );
+
+        param.sched_priority = attribs->Priority;
+        if( param.sched_priority < low )
+        {
+            param.sched_priority = low;
+        }
+        if( param.sched_priority > high )
+        {
+            param.sched_priority = high;
+        }
+
+        (void) pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+    }
+}
+
+
 //========================================================================
 // _glfwNewThread() - This is simply a "wrapper" for calling the user
 // thread function.
 //========================================================================
 
-void * _glfwNewThread( void * arg )
+static void * _glfwNewThread( void * arg )
 {
-    GLFWthreadfun threadfun;
-    _GLFWthread   *t;
+    _GLFWthread *t = (_GLFWthread *) arg;
 
-    // Get pointer to thread information for current thread
-    t = _glfwGetThreadPointer( glfwGetThreadID() );
-    if( t == NULL )
+    // Publish our GLFW ID before any user code can ask for it
+    _glfwSetThreadID( t->ID );
+
+    // Apply any attributes before the user function runs
+    if( t->Attribs != NULL )
     {
-        return 0;
+        ApplyThreadAttribs( t->Attribs );
+        free( t->Attribs );
+        t->Attribs = NULL;
     }
 
-    // Get user thread function pointer
-    threadfun = t->Function;
-
     // Call the user thread function
-    threadfun( arg );
+    t->Function( t->Arg );
 
-    // Remove thread from thread list
+    // Mark the thread as finished, but leave it in the thread list, as it
+    // has to be joined for its stack to be freed (the creating thread
+    // holds the critical section until the thread has been appended)
     ENTER_THREAD_CRITICAL_SECTION
-        _glfwRemoveThread( t );
+        t->Finished = GL_TRUE;
     LEAVE_THREAD_CRITICAL_SECTION
 
     // When the thread function returns, the thread will die...
@@ -70,6 +124,35 @@ void * _glfwNewThread( void * arg )
 }
 
 
+//========================================================================
+// Threads waiting on an address sleep on one of a small set of
+// condition variables, chosen by hashing the address
+//========================================================================
+
+#define _GLFW_WAIT_BUCKETS 16
+
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+} _glfwWaitBuckets[ _GLFW_WAIT_BUCKETS ];
+
+static pthread_once_t _glfwWaitBucketsOnce = PTHREAD_ONCE_INIT;
+
+static void InitWaitBuckets( void )
+{
+    int i;
+
+    for( i = 0;  i < _GLFW_WAIT_BUCKETS;  i ++ )
+    {
+        (void) pthread_mutex_init( &_glfwWaitBuckets[ i ].mutex, NULL );
+        (void) pthread_cond_init( &_glfwWaitBuckets[ i ].cond, NULL );
+    }
+}
+
+#define WAIT_BUCKET( address ) \
+    (&_glfwWaitBuckets[ ((size_t) (address) >> 2) % _GLFW_WAIT_BUCKETS ])
+
+
 //************************************************************************
 //****               Platform implementation functions                ****
 //************************************************************************
@@ -78,11 +161,13 @@ void * _glfwNewThread( void * arg )
 // _glfwPlatformCreateThread() - Create a new thread
 //========================================================================
 
-GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
+GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg,
+                                      const GLFWthreadattribs *attribs )
 {
-    GLFWthread  ID;
-    _GLFWthread *t;
-    int         result;
+    GLFWthread     ID;
+    _GLFWthread    *t;
+    pthread_attr_t attr;
+    int            result;
 
     // Enter critical section
     ENTER_THREAD_CRITICAL_SECTION
@@ -101,19 +186,40 @@ GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
 
     // Store thread information in the thread list
     t->Function = fun;
+    t->Arg      = arg;
     t->ID       = ID;
+    t->Attribs  = NULL;
+    t->Finished = GL_FALSE;
+
+    (void) pthread_attr_init( &attr );
+
+    if( attribs != NULL )
+    {
+        // The stack size is the only attribute that has to be given to
+        // pthread_create; the thread applies the rest itself
+        if( attribs->StackSize > 0 )
+        {
+            (void) pthread_attr_setstacksize( &attr,
+                ((size_t) attribs->StackSize + 4095) & ~(size_t) 4095 );
+        }
+
+        t->Attribs = _glfwCopyThreadAttribs( attribs );
+    }
 
     // Create thread
     result = pthread_create(
                             &t->PosixID,      // Thread handle
-                            NULL,             // Default thread attributes
+                            &attr,            // Thread attributes
                             _glfwNewThread,   // Thread function (a wrapper function)
-                            (void *)arg       // Argument to thread is user argument
+                            (void *)t         // Argument to thread is its own information
                             );
 
+    (void) pthread_attr_destroy( &attr );
+
     // Did the thread creation fail?
     if( result != 0 )
     {
+        free( t->Attribs );
         free( (void *) t );
         LEAVE_THREAD_CRITICAL_SECTION
         return -1;
@@ -184,8 +290,8 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
         return GL_TRUE;
     }
 
-    // If got this far, the thread is alive => polling returns FALSE
-    if( waitmode == GLFW_NOWAIT )
+    // A thread that is still running makes polling return FALSE
+    if( waitmode == GLFW_NOWAIT && !t->Finished )
     {
         LEAVE_THREAD_CRITICAL_SECTION
         return GL_FALSE;
@@ -197,9 +303,18 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
     // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
 
-    // Wait for thread to die
+    // Wait for thread to die, which also frees its stack
     (void) pthread_join( thread, NULL );
 
+    // Only now that it has been joined is the thread forgotten
+    ENTER_THREAD_CRITICAL_SECTION
+    t = _glfwGetThreadPointer( ID );
+    if( t != NULL )
+    {
+        _glfwRemoveThread( t );
+    }
+    LEAVE_THREAD_CRITICAL_SECTION
+
     return GL_TRUE;
 }
 
@@ -211,32 +326,64 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
 
 GLFWthread _glfwPlatformGetThreadID( void )
 {
-    _GLFWthread *t;
-    GLFWthread  ID = -1;
-    pthread_t   posixID;
+    return (GLFWthread) ((long) pthread_getspecific( _glfwThrd.IDKey ) - 1);
+}
 
-    // Get current thread ID
-    posixID = pthread_self();
 
-    // Enter critical section
+//========================================================================
+// _glfwPlatformGetThreadCPUTime() - Return the processor time used by a
+// thread, in seconds, or a negative value if it is not available
+//========================================================================
+
+double _glfwPlatformGetThreadCPUTime( GLFWthread ID )
+{
+    _GLFWthread              *t;
+    mach_port_t              port;
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t   count = THREAD_BASIC_INFO_COUNT;
+    kern_return_t            result;
+
+    // Threads remove themselves from the list before they exit, so the
+    // thread can not go away while we hold the critical section
     ENTER_THREAD_CRITICAL_SECTION
 
-    // Loop through entire list of threads to find the matching POSIX
-    // thread ID
-    for( t = &_glfwThrd.First; t != NULL; t = t->Next )
+    t = _glfwGetThreadPointer( ID );
+    if( t == NULL )
     {
-        if( t->PosixID == posixID )
-        {
-            ID = t->ID;
-            break;
-        }
+        LEAVE_THREAD_CRITICAL_SECTION
+        return -1.0;
     }
 
-    // Leave critical section
+    port = pthread_mach_thread_np( t->PosixID );
+    result = thread_info( port, THREAD_BASIC_INFO,
+                          (thread_info_t) &info, &count );
+
     LEAVE_THREAD_CRITICAL_SECTION
 
-    // Return the found GLFW thread identifier
-    return ID;
+    if( result != KERN_SUCCESS )
+    {
+        return -1.0;
+    }
+
+    return (double) info.user_time.seconds +
+           (double) info.user_time.microseconds * 1e-6 +
+           (double) info.system_time.seconds +
+           (double) info.system_time.microseconds * 1e-6;
+}
+
+
+//========================================================================
+// _glfwPlatformGetThreadContextSwitches() - Get the number of voluntary
+// and involuntary context switches of a thread. Mach does not count
+// these per thread, only per task.
+//========================================================================
+
+int _glfwPlatformGetThreadContextSwitches( GLFWthread ID, int *voluntary,
+                                           int *involuntary )
+{
+    (void) ID;
+    *voluntary = *involuntary = 0;
+    return GL_FALSE;
 }
 
 
@@ -244,10 +391,13 @@ GLFWthread _glfwPlatformGetThreadID( void )
 // _glfwPlatformCreateMutex() - Create a mutual exclusion object
 //========================================================================
 
-GLFWmutex _glfwPlatformCreateMutex( void )
+GLFWmutex _glfwPlatformCreateMutex( int mode )
 {
     pthread_mutex_t *mutex;
 
+    // All mutexes are plain pthread mutexes here
+    (void) mode;
+
     // Allocate memory for mutex
     mutex = (pthread_mutex_t *) malloc( sizeof( pthread_mutex_t ) );
     if( !mutex )
@@ -299,6 +449,16 @@ void _glfwPlatformUnlockMutex( GLFWmutex mutex )
 }
 
 
+//========================================================================
+// _glfwPlatformTryLockMutex() - Lock a mutex if it is free
+//========================================================================
+
+int _glfwPlatformTryLockMutex( GLFWmutex mutex )
+{
+    return pthread_mutex_trylock( (pthread_mutex_t *) mutex ) == 0;
+}
+
+
 //========================================================================
 // _glfwPlatformCreateCond() - Create a new condition variable object
 //========================================================================
@@ -343,9 +503,7 @@ void _glfwPlatformDestroyCond( GLFWcond cond )
 void _glfwPlatformWaitCond( GLFWcond cond, GLFWmutex mutex,
                             double timeout )
 {
-    struct timeval  currenttime;
     struct timespec wait;
-    long dt_sec, dt_usec;
 
     // Select infinite or timed wait
     if( timeout >= GLFW_INFINITY )
@@ -356,21 +514,21 @@ void _glfwPlatformWaitCond( GLFWcond cond, GLFWmutex mutex,
     }
     else
     {
-        // Set timeout time, relatvie to current time
-        gettimeofday( &currenttime, NULL );
-        dt_sec  = (long) timeout;
-        dt_usec = (long) ((timeout - (double)dt_sec) * 1000000.0);
-        wait.tv_nsec = (currenttime.tv_usec + dt_usec) * 1000L;
-        if( wait.tv_nsec > 1000000000L )
+        if( timeout < 0.0 )
         {
-            wait.tv_nsec -= 1000000000L;
-            dt_sec ++;
+            timeout = 0.0;
         }
-        wait.tv_sec  = currenttime.tv_sec + dt_sec;
+
+        // Mac OS X has no monotonic clock for condition variables, but it
+        // does have a relative timed wait, which setting the wall clock
+        // does not affect
+        wait.tv_sec  = (time_t) timeout;
+        wait.tv_nsec = (long) ((timeout - (double) wait.tv_sec) * 1e9);
 
         // Wait for condition (timed wait)
-        (void) pthread_cond_timedwait( (pthread_cond_t *) cond,
-                                       (pthread_mutex_t *) mutex, &wait );
+        (void) pthread_cond_timedwait_relative_np( (pthread_cond_t *) cond,
+                                                   (pthread_mutex_t *) mutex,
+                                                   &wait );
     }
 }
 
@@ -412,3 +570,130 @@ int _glfwPlatformGetNumberOfProcessors( void )
     return n;
 }
 
+
+//========================================================================
+// _glfwPlatformGetCPUTopology() - Get the processors the process may run
+// on, and what they share. Mac OS X does not tell which logical processor
+// belongs to which core, so this is left to the generic fallback.
+//========================================================================
+
+int _glfwPlatformGetCPUTopology( GLFWcputopology *topology )
+{
+    (void) topology;
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// _glfwPlatformWaitAddress() - Wait until the int at the given address
+// no longer holds the given value (or until woken, or the timeout
+// expires)
+//========================================================================
+
+void _glfwPlatformWaitAddress( volatile int *address, int value,
+                               double timeout )
+{
+    (void) pthread_once( &_glfwWaitBucketsOnce, InitWaitBuckets );
+
+    pthread_mutex_lock( &WAIT_BUCKET( address )->mutex );
+    if( *address == value )
+    {
+        _glfwPlatformWaitCond( (GLFWcond) &WAIT_BUCKET( address )->cond,
+                               (GLFWmutex) &WAIT_BUCKET( address )->mutex,
+                               timeout );
+    }
+    pthread_mutex_unlock( &WAIT_BUCKET( address )->mutex );
+}
+
+
+//========================================================================
+// _glfwPlatformWakeAddress() - Wake up threads waiting on the given address
+//========================================================================
+
+void _glfwPlatformWakeAddress( volatile int *address, int count )
+{
+    (void) pthread_once( &_glfwWaitBucketsOnce, InitWaitBuckets );
+
+    // Other addresses may share the bucket, so everyone must be woken
+    pthread_mutex_lock( &WAIT_BUCKET( address )->mutex );
+    (void) pthread_cond_broadcast( &WAIT_BUCKET( address )->cond );
+    pthread_mutex_unlock( &WAIT_BUCKET( address )->mutex );
+}
+
+
+//========================================================================
+// _glfwPlatformSetThreadData() - Set the internal data pointer of the
+// calling thread
+//========================================================================
+
+void _glfwPlatformSetThreadData( void *data )
+{
+    (void) pthread_setspecific( _glfwThrd.DataKey, data );
+}
+
+
+//========================================================================
+// _glfwPlatformGetThreadData() - Return the internal data pointer of the
+// calling thread
+//========================================================================
+
+void * _glfwPlatformGetThreadData( void )
+{
+    return pthread_getspecific( _glfwThrd.DataKey );
+}
+
+
+//========================================================================
+// _glfwPlatformCreateFiber() - Fibers are not supported here (ucontext is
+// deprecated on Mac OS X), so jobs that wait block their worker thread
+//========================================================================
+
+void * _glfwPlatformCreateFiber( void (*fun)( void * ), void *arg,
+                                 size_t stacksize )
+{
+    (void) fun;
+    (void) arg;
+    (void) stacksize;
+    return NULL;
+}
+
+
+//========================================================================
+// _glfwPlatformConvertThreadToFiber() - Fibers are not supported here
+//========================================================================
+
+void * _glfwPlatformConvertThreadToFiber( void )
+{
+    return NULL;
+}
+
+
+//========================================================================
+// _glfwPlatformConvertFiberToThread() - Fibers are not supported here
+//========================================================================
+
+void _glfwPlatformConvertFiberToThread( void *fiber )
+{
+    (void) fiber;
+}
+
+
+//========================================================================
+// _glfwPlatformSwitchFiber() - Fibers are not supported here
+//========================================================================
+
+void _glfwPlatformSwitchFiber( void *from, void *to )
+{
+    (void) from;
+    (void) to;
+}
+
+
+//========================================================================
+// _glfwPlatformDestroyFiber() - Fibers are not supported here
+//========================================================================
+
+void _glfwPlatformDestroyFiber( void *fiber )
+{
+    (void) fiber;
+}
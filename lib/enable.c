@@ -229,6 +229,24 @@ static void disableAutoPollEvents( void )
     _glfwWin.autoPollEvents = 0;
 }
 
+//========================================================================
+// Enable lock profiling
+//========================================================================
+
+static void enableLockProfiling( void )
+{
+    _glfwLockProfiling = 1;
+}
+
+//========================================================================
+// Disable lock profiling (statistics gathered so far are kept)
+//========================================================================
+
+static void disableLockProfiling( void )
+{
+    _glfwLockProfiling = 0;
+}
+
 
 
 //************************************************************************
@@ -267,6 +285,9 @@ GLFWAPI void GLFWAPIENTRY glfwEnable( int token )
         case GLFW_AUTO_POLL_EVENTS:
             enableAutoPollEvents();
             break;
+        case GLFW_LOCK_PROFILING:
+            enableLockProfiling();
+            break;
         default:
             break;
     }
@@ -305,6 +326,9 @@ GLFWAPI void GLFWAPIENTRY glfwDisable( int token )
         case GLFW_AUTO_POLL_EVENTS:
             disableAutoPollEvents();
             break;
+        case GLFW_LOCK_PROFILING:
+            disableLockProfiling();
+            break;
         default:
             break;
     }
@@ -63,6 +63,21 @@
  #define GL_SGIS_generate_mipmap    1
 #endif // GL_SGIS_generate_mipmap
 
+// Cube maps were added to core in version 1.3
+#ifndef GL_VERSION_1_3
+ #define GL_TEXTURE_CUBE_MAP            0x8513
+ #define GL_TEXTURE_CUBE_MAP_POSITIVE_X 0x8515
+#endif // GL_VERSION_1_3
+
+// Texture arrays were added to core in version 3.0
+#ifndef GL_EXT_texture_array
+ #define GL_TEXTURE_2D_ARRAY_EXT        0x8C1A
+#endif // GL_EXT_texture_array
+
+// glTexImage3D is not exported by all OpenGL libraries
+typedef void (APIENTRY * _GLFWteximage3dfun)( GLenum, GLint, GLint,
+    GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid * );
+
 
 //************************************************************************
 //****                  GLFW internal functions                       ****
@@ -213,7 +228,8 @@ static int HalveImage( GLubyte *src, int *width, int *height,
 
 static int RescaleImage( GLFWimage* image )
 {
-    int     width, height, log2, newsize;
+    int     width, height, log2;
+    size_t  newsize;
     unsigned char *data;
 
     // Calculate next larger 2^N width
@@ -240,7 +256,7 @@ static int RescaleImage( GLFWimage* image )
     if( width != image->Width || height != image->Height )
     {
         // Allocate memory for new (upsampled) image data
-        newsize = width * height * image->BytesPerPixel;
+        newsize = (size_t) width * height * image->BytesPerPixel;
         data = (unsigned char *) malloc( newsize );
         if( data == NULL )
         {
@@ -265,57 +281,12 @@ static int RescaleImage( GLFWimage* image )
 }
 
 
-//************************************************************************
-//****                    GLFW user functions                         ****
-//************************************************************************
-
 //========================================================================
-// Read an image from a named file
+// Interpret BytesPerPixel of a loaded image as an OpenGL format
 //========================================================================
 
-GLFWAPI int GLFWAPIENTRY glfwReadImage( const char *name, GLFWimage *img,
-    int flags )
+static void SetImageFormat( GLFWimage *img, int flags )
 {
-    _GLFWstream stream;
-
-    // Is GLFW initialized?
-    if( !_glfwInitialized )
-    {
-        return GL_FALSE;
-    }
-
-    // Start with an empty image descriptor
-    img->Width         = 0;
-    img->Height        = 0;
-    img->BytesPerPixel = 0;
-    img->Data          = NULL;
-
-    // Open file
-    if( !_glfwOpenFileStream( &stream, name, "rb" ) )
-    {
-        return GL_FALSE;
-    }
-
-    // We only support TGA files at the moment
-    if( !_glfwReadTGA( &stream, img, flags ) )
-    {
-        _glfwCloseStream( &stream );
-        return GL_FALSE;
-    }
-
-    // Close stream
-    _glfwCloseStream( &stream );
-
-    // Should we rescale the image to closest 2^N x 2^M resolution?
-    if( !(flags & GLFW_NO_RESCALE_BIT) )
-    {
-        if( !RescaleImage( img ) )
-        {
-            return GL_FALSE;
-        }
-    }
-
-    // Interpret BytesPerPixel as an OpenGL format
     switch( img->BytesPerPixel )
     {
         default:
@@ -336,237 +307,155 @@ GLFWAPI int GLFWAPIENTRY glfwReadImage( const char *name, GLFWimage *img,
             img->Format = GL_RGBA;
             break;
     }
-
-    return GL_TRUE;
 }
 
 
 //========================================================================
-// Read an image file from a memory buffer
+// Get the decode-time subsampling requested by the flags, as a shift
 //========================================================================
 
-GLFWAPI int GLFWAPIENTRY glfwReadMemoryImage( const void *data, long size, GLFWimage *img, int flags )
+static int SubsampleShift( int flags )
 {
-    _GLFWstream stream;
-
-    // Is GLFW initialized?
-    if( !_glfwInitialized )
-    {
-        return GL_FALSE;
-    }
-
-    // Start with an empty image descriptor
-    img->Width         = 0;
-    img->Height        = 0;
-    img->BytesPerPixel = 0;
-    img->Data          = NULL;
-
-    // Open buffer
-    if( !_glfwOpenBufferStream( &stream, (void*) data, size ) )
-    {
-        return GL_FALSE;
-    }
-
-    // We only support TGA files at the moment
-    if( !_glfwReadTGA( &stream, img, flags ) )
+    if( flags & GLFW_SUBSAMPLE_8_BIT )
     {
-        _glfwCloseStream( &stream );
-        return GL_FALSE;
+        return 3;
     }
-
-    // Close stream
-    _glfwCloseStream( &stream );
-
-    // Should we rescale the image to closest 2^N x 2^M resolution?
-    if( !(flags & GLFW_NO_RESCALE_BIT) )
+    if( flags & GLFW_SUBSAMPLE_4_BIT )
     {
-        if( !RescaleImage( img ) )
-        {
-            return GL_FALSE;
-        }
+        return 2;
     }
-
-    // Interpret BytesPerPixel as an OpenGL format
-    switch( img->BytesPerPixel )
+    if( flags & GLFW_SUBSAMPLE_2_BIT )
     {
-        default:
-        case 1:
-            if( flags & GLFW_ALPHA_MAP_BIT )
-            {
-                img->Format = GL_ALPHA;
-            }
-            else
-            {
-                img->Format = GL_LUMINANCE;
-            }
-            break;
-        case 3:
-            img->Format = GL_RGB;
-            break;
-        case 4:
-            img->Format = GL_RGBA;
-            break;
+        return 1;
     }
-
-    return GL_TRUE;
+    return 0;
 }
 
 
 //========================================================================
-// Free allocated memory for an image
+// Decode a region of an image from a stream, subsampling it as requested
+// by the flags. Only the rows of the region are ever decoded into memory,
+// one at a time. A negative width selects the whole image.
 //========================================================================
 
-GLFWAPI void GLFWAPIENTRY glfwFreeImage( GLFWimage *img )
+static int ReadImageRegion( _GLFWstream *s, int x, int y, int width,
+    int height, GLFWimage *img, int flags )
 {
-    // Is GLFW initialized?
-    if( !_glfwInitialized )
+    _GLFWtiles tiles;
+    int result;
+
+    // The tile reader works on a copy of the stream, which is still owned
+    // (and closed) by the caller
+    tiles.stream = *s;
+
+    // We only support TGA files at the moment
+    if( !_glfwOpenTGATiles( &tiles, flags, GL_FALSE ) )
     {
-        return;
+        _glfwCloseTGATiles( &tiles );
+        return GL_FALSE;
     }
 
-    // Free memory
-    if( img->Data != NULL )
+    if( width < 0 )
     {
-        free( img->Data );
-        img->Data = NULL;
+        x      = 0;
+        y      = 0;
+        width  = tiles.width;
+        height = tiles.height;
     }
 
-    // Clear all fields
-    img->Width         = 0;
-    img->Height        = 0;
-    img->Format        = 0;
-    img->BytesPerPixel = 0;
+    result = _glfwReadTGATile( &tiles, x, y, width, height,
+                               SubsampleShift( flags ), img );
+
+    _glfwCloseTGATiles( &tiles );
+
+    return result;
 }
 
 
 //========================================================================
-// Read an image from a file, and upload it to texture memory
+// Read a whole image from an open stream, and close the stream
 //========================================================================
 
-GLFWAPI int GLFWAPIENTRY glfwLoadTexture2D( const char *name, int flags )
+static int ReadImage( _GLFWstream *stream, GLFWimage *img, int flags )
 {
-    GLFWimage img;
+    int result;
 
-    // Is GLFW initialized?
-    if( !_glfwInitialized || !_glfwWin.opened )
+    // Decompress gzip compressed images on the fly
+    if( !_glfwDetectGzipStream( stream ) )
     {
+        _glfwCloseStream( stream );
         return GL_FALSE;
     }
 
-    // Force rescaling if necessary
-    if( !_glfwWin.has_GL_ARB_texture_non_power_of_two )
+    // Subsample while decoding, if requested, so that no full resolution
+    // buffer is needed (we only support TGA files at the moment)
+    if( SubsampleShift( flags ) )
     {
-        flags &= (~GLFW_NO_RESCALE_BIT);
+        result = ReadImageRegion( stream, 0, 0, -1, -1, img, flags );
     }
-
-    // Read image from file
-    if( !glfwReadImage( name, &img, flags ) )
+    else
+    {
+        result = _glfwReadTGA( stream, img, flags );
+    }
+    if( !result )
     {
+        _glfwCloseStream( stream );
         return GL_FALSE;
     }
 
-    if( !glfwLoadTextureImage2D( &img, flags ) )
+    // Close stream
+    _glfwCloseStream( stream );
+
+    // Should we rescale the image to closest 2^N x 2^M resolution?
+    if( !(flags & GLFW_NO_RESCALE_BIT) )
     {
-        return GL_FALSE;
+        if( !RescaleImage( img ) )
+        {
+            return GL_FALSE;
+        }
     }
 
-    // Data buffer is not needed anymore
-    glfwFreeImage( &img );
+    // Interpret BytesPerPixel as an OpenGL format
+    SetImageFormat( img, flags );
 
     return GL_TRUE;
 }
 
 
 //========================================================================
-// Read an image from a buffer, and upload it to texture memory
+// Read an image from a named file (without looking in the prefetch cache)
 //========================================================================
 
-GLFWAPI int  GLFWAPIENTRY glfwLoadMemoryTexture2D( const void *data, long size, int flags )
+int _glfwReadImageFile( const char *name, GLFWimage *img, int flags )
 {
-    GLFWimage img;
-
-    // Is GLFW initialized?
-    if( !_glfwInitialized || !_glfwWin.opened )
-    {
-        return GL_FALSE;
-    }
-
-    // Force rescaling if necessary
-    if( !_glfwWin.has_GL_ARB_texture_non_power_of_two )
-    {
-        flags &= (~GLFW_NO_RESCALE_BIT);
-    }
+    _GLFWstream stream;
 
-    // Read image from file
-    if( !glfwReadMemoryImage( data, size, &img, flags ) )
-    {
-        return GL_FALSE;
-    }
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
 
-    if( !glfwLoadTextureImage2D( &img, flags ) )
+    // Open file
+    if( !_glfwOpenFileStream( &stream, name, "rb" ) )
     {
         return GL_FALSE;
     }
 
-    // Data buffer is not needed anymore
-    glfwFreeImage( &img );
-
-    return GL_TRUE;
+    return ReadImage( &stream, img, flags );
 }
 
 
 //========================================================================
-// Upload an image object to texture memory
+// Upload an image and optionally its mipmaps to the specified texture
+// target (a separate face target is used for cube maps)
 //========================================================================
 
-GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags )
+static void UploadImage( GLenum target, GLenum face, GLFWimage *img,
+    int flags )
 {
     GLint   UnpackAlignment, GenMipMap;
-    int     level, format, AutoGen, newsize, n;
-    unsigned char *data, *dataptr;
-
-    // Is GLFW initialized?
-    if( !_glfwInitialized || !_glfwWin.opened )
-    {
-        return GL_FALSE;
-    }
-
-    // TODO: Use GL_MAX_TEXTURE_SIZE or GL_PROXY_TEXTURE_2D to determine
-    //       whether the image size is valid.
-    // NOTE: May require box filter downsampling routine.
-
-    // Do we need to convert the alpha map to RGBA format (OpenGL 1.0)?
-    if( (_glfwWin.glMajor == 1) && (_glfwWin.glMinor == 0) &&
-        (img->Format == GL_ALPHA) )
-    {
-        // We go to RGBA representation instead
-        img->BytesPerPixel = 4;
-
-        // Allocate memory for new RGBA image data
-        newsize = img->Width * img->Height * img->BytesPerPixel;
-        data = (unsigned char *) malloc( newsize );
-        if( data == NULL )
-        {
-            free( img->Data );
-            return GL_FALSE;
-        }
-
-        // Convert Alpha map to RGBA
-        dataptr = data;
-        for( n = 0; n < (img->Width*img->Height); ++ n )
-        {
-            *dataptr ++ = 255;
-            *dataptr ++ = 255;
-            *dataptr ++ = 255;
-            *dataptr ++ = img->Data[n];
-        }
-
-        // Free memory for old image data (not needed anymore)
-        free( img->Data );
-
-        // Set pointer to new image data
-        img->Data = data;
-    }
+    int     level, format, AutoGen;
 
     // Set unpack alignment to one byte
     glGetIntegerv( GL_UNPACK_ALIGNMENT, &UnpackAlignment );
@@ -579,9 +468,9 @@ GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags )
     // Enable automatic mipmap generation
     if( AutoGen )
     {
-        glGetTexParameteriv( GL_TEXTURE_2D, GL_GENERATE_MIPMAP_SGIS,
+        glGetTexParameteriv( target, GL_GENERATE_MIPMAP_SGIS,
             &GenMipMap );
-        glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP_SGIS,
+        glTexParameteri( target, GL_GENERATE_MIPMAP_SGIS,
             GL_TRUE );
     }
 
@@ -600,7 +489,7 @@ GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags )
     do
     {
         // Upload this mipmap level
-        glTexImage2D( GL_TEXTURE_2D, level, format,
+        glTexImage2D( face, level, format,
             img->Width, img->Height, 0, format,
             GL_UNSIGNED_BYTE, (void*) img->Data );
 
@@ -617,13 +506,1821 @@ GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags )
     // Restore old automatic mipmap generation state
     if( AutoGen )
     {
-        glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP_SGIS,
+        glTexParameteri( target, GL_GENERATE_MIPMAP_SGIS,
             GenMipMap );
     }
 
     // Restore old unpack alignment
     glPixelStorei( GL_UNPACK_ALIGNMENT, UnpackAlignment );
+}
 
-    return GL_TRUE;
+
+//========================================================================
+// Set of images to decode in parallel
+//========================================================================
+
+typedef struct {
+    const char  **names;
+    GLFWimage   *images;
+    int         flags;
+} _GLFWimageset;
+
+
+//========================================================================
+// Image set worker; decodes images until the set is exhausted
+//========================================================================
+
+static void ReadImageSetWorker( _GLFWworkset *work )
+{
+    _GLFWimageset *set = (_GLFWimageset *) work->arg;
+    int i;
+
+    while( (i = _glfwClaimWorkItem( work )) >= 0 )
+    {
+        if( !glfwReadImage( set->names[ i ], &set->images[ i ], set->flags ) )
+        {
+            _glfwFailWorkItem( work );
+        }
+    }
 }
 
+
+//========================================================================
+// Read a set of images, using one thread per processor if possible
+//========================================================================
+
+int _glfwReadImageSet( const char **names, int count, GLFWimage *images,
+    int flags )
+{
+    _GLFWimageset set;
+    _GLFWworkset  work;
+    int           i;
+
+    set.names  = names;
+    set.images = images;
+    set.flags  = flags;
+
+    for( i = 0; i < count; i ++ )
+    {
+        images[ i ].Data = NULL;
+    }
+
+    work.count  = count;
+    work.worker = ReadImageSetWorker;
+    work.arg    = &set;
+
+    if( !_glfwRunWorkset( &work, _glfwGetUsableProcessors() ) )
+    {
+        for( i = 0; i < count; i ++ )
+        {
+            glfwFreeImage( &images[ i ] );
+        }
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Shared state for reading a large batch of image files. Each worker
+// keeps up to _GLFW_READ_DEPTH files in flight through its own file
+// queue and decodes them as they arrive. Without file queues the workers
+// use blocking reads, and more of them are started to keep the device
+// busy.
+//========================================================================
+
+#define _GLFW_READ_DEPTH    32
+#define _GLFW_READ_THREADS  16
+
+typedef struct {
+    const char  **names;
+    GLFWimage   *images;
+    int         flags;
+    int         async;
+
+    // Queue opened by glfwReadImages, taken by the first worker to start
+    _GLFWfilequeue * volatile queue;
+
+    // Number of images read, only accessed atomically
+    int         loaded;
+} _GLFWimagebatch;
+
+
+//========================================================================
+// Image batch worker; reads images until the batch is exhausted, through
+// a file queue of its own if possible
+//========================================================================
+
+static void ReadImageBatchWorker( _GLFWworkset *work )
+{
+    _GLFWimagebatch *batch = (_GLFWimagebatch *) work->arg;
+    _GLFWfilequeue  *queue = NULL;
+    _GLFWstream     stream;
+    _GLFWoffset     size;
+    void            *data;
+    int             i, inflight, loaded;
+
+    if( batch->async )
+    {
+        queue = (_GLFWfilequeue *)
+            _glfwAtomicExchangePtr( &batch->queue, NULL );
+        if( queue == NULL )
+        {
+            queue = _glfwPlatformOpenFileQueue( _GLFW_READ_DEPTH );
+        }
+    }
+
+    loaded   = 0;
+    inflight = 0;
+
+    for( ;; )
+    {
+        // Keep the file queue full
+        while( inflight < (queue ? _GLFW_READ_DEPTH : 1) )
+        {
+            i = _glfwClaimWorkItem( work );
+            if( i < 0 )
+            {
+                break;
+            }
+
+            // Pack entries are already in memory, or mapped
+            if( _glfwTakePrefetchedImage( batch->names[ i ],
+                                          &batch->images[ i ],
+                                          batch->flags ) )
+            {
+                loaded ++;
+            }
+            else if( queue &&
+                     strncmp( batch->names[ i ], "pack:", 5 ) != 0 &&
+                     _glfwPlatformQueueFileRead( queue, batch->names[ i ],
+                                                 i ) )
+            {
+                inflight ++;
+            }
+            else if( _glfwReadImageFile( batch->names[ i ],
+                                         &batch->images[ i ],
+                                         batch->flags ) )
+            {
+                loaded ++;
+            }
+        }
+
+        if( inflight == 0 )
+        {
+            break;
+        }
+
+        // Decode files as they arrive
+        if( _glfwPlatformWaitFileRead( queue, &i, &data, &size ) )
+        {
+            _glfwOpenBufferStream( &stream, data, size );
+            stream.freeData = GL_TRUE;
+            if( ReadImage( &stream, &batch->images[ i ], batch->flags ) )
+            {
+                loaded ++;
+            }
+        }
+        inflight --;
+    }
+
+    if( queue )
+    {
+        _glfwPlatformCloseFileQueue( queue );
+    }
+
+    _glfwAtomicAdd( &batch->loaded, loaded );
+}
+
+
+//========================================================================
+// Shared images. The pixels follow a small header in a block of shared
+// memory, so that another process can map the image given only the
+// handle. Mapped shared images are kept in a list, so that glfwFreeImage
+// can tell them apart from ordinary images.
+//========================================================================
+
+#define _GLFW_SHARED_MAGIC       "GLFWSHIM"
+#define _GLFW_SHARED_HEADER_SIZE 64
+
+typedef struct {
+    char    magic[ 8 ];
+    int     width, height;
+    int     format, bytesPerPixel;
+} _GLFWsharedheader;
+
+typedef struct _GLFWsharedimage_struct _GLFWsharedimage;
+
+struct _GLFWsharedimage_struct {
+    unsigned char    *base;
+    size_t           size;
+    int              handle;    // -1 if the handle belongs to the user
+    _GLFWsharedimage *next;
+};
+
+static _GLFWsharedimage *_glfwSharedImages = NULL;
+
+
+//========================================================================
+// Remember a shared image mapping
+//========================================================================
+
+static int AddSharedImage( unsigned char *base, size_t size, int handle )
+{
+    _GLFWsharedimage *shared;
+
+    shared = (_GLFWsharedimage *) malloc( sizeof(_GLFWsharedimage) );
+    if( shared == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    shared->base   = base;
+    shared->size   = size;
+    shared->handle = handle;
+
+    ENTER_THREAD_CRITICAL_SECTION
+    shared->next = _glfwSharedImages;
+    _glfwSharedImages = shared;
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Unmap a shared image given its pixel data, or return GL_FALSE if the
+// data does not belong to a shared image
+//========================================================================
+
+static int FreeSharedImage( unsigned char *data )
+{
+    _GLFWsharedimage **prev, *shared;
+
+    ENTER_THREAD_CRITICAL_SECTION
+
+    for( prev = &_glfwSharedImages;  *prev;  prev = &(*prev)->next )
+    {
+        if( (*prev)->base + _GLFW_SHARED_HEADER_SIZE == data )
+        {
+            break;
+        }
+    }
+
+    shared = *prev;
+    if( shared )
+    {
+        *prev = shared->next;
+    }
+
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    if( shared == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    _glfwPlatformUnmapSharedMemory( shared->base, shared->size );
+    if( shared->handle >= 0 )
+    {
+        _glfwPlatformCloseSharedMemory( shared->handle );
+    }
+    free( shared );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Create shared memory for an image, and return a pointer to where its
+// pixels go
+//========================================================================
+
+static unsigned char * CreateSharedImage( int width, int height, int bpp,
+    int *handle )
+{
+    unsigned char *base;
+    size_t size;
+
+    size = _GLFW_SHARED_HEADER_SIZE + (size_t) width * height * bpp;
+
+    base = (unsigned char *) _glfwPlatformCreateSharedMemory( size, handle );
+    if( base == NULL )
+    {
+        return NULL;
+    }
+
+    if( !AddSharedImage( base, size, *handle ) )
+    {
+        _glfwPlatformUnmapSharedMemory( base, size );
+        _glfwPlatformCloseSharedMemory( *handle );
+        return NULL;
+    }
+
+    return base + _GLFW_SHARED_HEADER_SIZE;
+}
+
+
+//========================================================================
+// Is this a power of two?
+//========================================================================
+
+static int IsPowerOfTwo( int x )
+{
+    return (x & (x - 1)) == 0;
+}
+
+
+//========================================================================
+// Read an image from an open stream into shared memory, and close the
+// stream. Where possible the image is decoded straight into the shared
+// memory; only images that must be rescaled are copied there
+//========================================================================
+
+static int ReadSharedImage( _GLFWstream *stream, GLFWimage *img, int flags,
+    int *handle )
+{
+    _GLFWsharedheader header;
+    _GLFWtiles    tiles;
+    GLFWimage     tmp;
+    unsigned char *data;
+    int           shift, width, height, result;
+
+    if( !_glfwDetectGzipStream( stream ) )
+    {
+        _glfwCloseStream( stream );
+        return GL_FALSE;
+    }
+
+    // We only support TGA files at the moment
+    tiles.stream = *stream;
+    if( !_glfwOpenTGATiles( &tiles, flags, GL_FALSE ) )
+    {
+        _glfwCloseTGATiles( &tiles );
+        _glfwCloseStream( stream );
+        return GL_FALSE;
+    }
+
+    shift  = SubsampleShift( flags );
+    width  = (tiles.width + (1 << shift) - 1) >> shift;
+    height = (tiles.height + (1 << shift) - 1) >> shift;
+
+    if( !(flags & GLFW_NO_RESCALE_BIT) &&
+        (!IsPowerOfTwo( width ) || !IsPowerOfTwo( height )) )
+    {
+        // Rescaling makes a new buffer anyway, so read the image as usual
+        _glfwCloseTGATiles( &tiles );
+        if( !_glfwSeekStream( stream, 0, SEEK_SET ) )
+        {
+            _glfwCloseStream( stream );
+            return GL_FALSE;
+        }
+        if( !ReadImage( stream, &tmp, flags ) )
+        {
+            return GL_FALSE;
+        }
+
+        data = CreateSharedImage( tmp.Width, tmp.Height, tmp.BytesPerPixel,
+                                  handle );
+        if( data == NULL )
+        {
+            free( tmp.Data );
+            return GL_FALSE;
+        }
+        memcpy( data, tmp.Data,
+                (size_t) tmp.Width * tmp.Height * tmp.BytesPerPixel );
+        free( tmp.Data );
+
+        *img = tmp;
+        img->Data = data;
+    }
+    else
+    {
+        data = CreateSharedImage( width, height, tiles.bpp2, handle );
+        result = GL_FALSE;
+        if( data )
+        {
+            tiles.target = data;
+            result = _glfwReadTGATile( &tiles, 0, 0, tiles.width,
+                                       tiles.height, shift, img );
+        }
+
+        _glfwCloseTGATiles( &tiles );
+        _glfwCloseStream( stream );
+
+        if( !result )
+        {
+            if( data )
+            {
+                FreeSharedImage( data );
+            }
+            return GL_FALSE;
+        }
+
+        SetImageFormat( img, flags );
+    }
+
+    // Describe the image to the receiver
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, _GLFW_SHARED_MAGIC, 8 );
+    header.width         = img->Width;
+    header.height        = img->Height;
+    header.format        = img->Format;
+    header.bytesPerPixel = img->BytesPerPixel;
+    memcpy( img->Data - _GLFW_SHARED_HEADER_SIZE, &header, sizeof(header) );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Find the pixel format that can hold every image of a set without loss.
+// Alpha maps only keep their coverage in a format with alpha, so mixing
+// them with luminance maps gives GL_LUMINANCE_ALPHA, and mixing them with
+// colour images gives GL_RGBA
+//========================================================================
+
+static void GetCommonFormat( const GLFWimage *images, int count, int *bpp,
+    int *format )
+{
+    int i, color, alpha, luminance;
+
+    color = alpha = luminance = 0;
+    for( i = 0; i < count; i ++ )
+    {
+        if( images[ i ].BytesPerPixel > color )
+        {
+            color = images[ i ].BytesPerPixel;
+        }
+        if( images[ i ].Format == GL_ALPHA )
+        {
+            alpha = 1;
+        }
+        else if( images[ i ].BytesPerPixel == 1 )
+        {
+            luminance = 1;
+        }
+    }
+
+    if( color >= 3 )
+    {
+        *bpp = (color == 4 || alpha) ? 4 : 3;
+    }
+    else
+    {
+        *bpp = (color == 2 || (alpha && luminance)) ? 2 : 1;
+    }
+
+    switch( *bpp )
+    {
+        case 1:
+            *format = alpha ? GL_ALPHA : GL_LUMINANCE;
+            break;
+        case 2:
+            *format = GL_LUMINANCE_ALPHA;
+            break;
+        case 3:
+            *format = GL_RGB;
+            break;
+        default:
+            *format = GL_RGBA;
+            break;
+    }
+}
+
+
+//========================================================================
+// Convert an image to the specified pixel format, which must be able to
+// hold it (see GetCommonFormat)
+//========================================================================
+
+static int ExpandImage( GLFWimage *img, int bpp, int format )
+{
+    unsigned char *data, *src, *dst;
+    unsigned char r, g, b, a;
+    int n, count;
+
+    if( img->BytesPerPixel == bpp && img->Format == format )
+    {
+        return GL_TRUE;
+    }
+
+    count = img->Width * img->Height;
+    data = (unsigned char *) malloc( count * bpp );
+    if( data == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    src = img->Data;
+    dst = data;
+
+    for( n = 0; n < count; n ++ )
+    {
+        // Alpha maps become white, and anything without alpha opaque
+        switch( img->BytesPerPixel )
+        {
+            case 1:
+                if( img->Format == GL_ALPHA )
+                {
+                    r = g = b = 255;
+                    a = src[ 0 ];
+                }
+                else
+                {
+                    r = g = b = src[ 0 ];
+                    a = 255;
+                }
+                break;
+            case 2:
+                r = g = b = src[ 0 ];
+                a = src[ 1 ];
+                break;
+            case 3:
+                r = src[ 0 ];
+                g = src[ 1 ];
+                b = src[ 2 ];
+                a = 255;
+                break;
+            default:
+                r = src[ 0 ];
+                g = src[ 1 ];
+                b = src[ 2 ];
+                a = src[ 3 ];
+                break;
+        }
+
+        switch( bpp )
+        {
+            case 1:
+                dst[ 0 ] = (format == GL_ALPHA) ? a : r;
+                break;
+            case 2:
+                dst[ 0 ] = r;
+                dst[ 1 ] = a;
+                break;
+            default:
+                dst[ 0 ] = r;
+                dst[ 1 ] = g;
+                dst[ 2 ] = b;
+                if( bpp == 4 )
+                {
+                    dst[ 3 ] = a;
+                }
+                break;
+        }
+
+        src += img->BytesPerPixel;
+        dst += bpp;
+    }
+
+    free( img->Data );
+    img->Data = data;
+    img->BytesPerPixel = bpp;
+    img->Format = format;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read a set of images that are to be uploaded as layers or faces of a
+// single texture, which requires them to have the same size and format
+//========================================================================
+
+static int ReadImageLayers( const char **names, int count,
+    GLFWimage *images, int flags )
+{
+    int i, bpp, format;
+
+    // Force rescaling if necessary
+    if( !_glfwWin.has_GL_ARB_texture_non_power_of_two )
+    {
+        flags &= (~GLFW_NO_RESCALE_BIT);
+    }
+
+    if( !_glfwReadImageSet( names, count, images, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    for( i = 0; i < count; i ++ )
+    {
+        if( images[ i ].Width != images[ 0 ].Width ||
+            images[ i ].Height != images[ 0 ].Height )
+        {
+            break;
+        }
+    }
+
+    // Mixed pixel formats are converted to one that can hold them all
+    if( i == count )
+    {
+        GetCommonFormat( images, count, &bpp, &format );
+        for( i = 0; i < count; i ++ )
+        {
+            if( !ExpandImage( &images[ i ], bpp, format ) )
+            {
+                break;
+            }
+        }
+    }
+
+    if( i < count )
+    {
+        for( i = 0; i < count; i ++ )
+        {
+            glfwFreeImage( &images[ i ] );
+        }
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Skyline bin packing (bottom-left heuristic)
+//========================================================================
+
+typedef struct {
+    int x, y, width;
+} _GLFWskyline;
+
+static int FitSkyline( const _GLFWskyline *nodes, int count, int index,
+    int binwidth, int binheight, int width, int height )
+{
+    int x, y, left;
+
+    x = nodes[ index ].x;
+    if( x + width > binwidth )
+    {
+        return -1;
+    }
+
+    y = nodes[ index ].y;
+    left = width;
+    while( left > 0 )
+    {
+        if( index >= count )
+        {
+            return -1;
+        }
+
+        if( nodes[ index ].y > y )
+        {
+            y = nodes[ index ].y;
+        }
+        if( y + height > binheight )
+        {
+            return -1;
+        }
+
+        left -= nodes[ index ].width;
+        index ++;
+    }
+
+    return y;
+}
+
+static int PackSkyline( int binwidth, int binheight, const int *widths,
+    const int *heights, const int *order, int count, int *xs, int *ys )
+{
+    _GLFWskyline *nodes;
+    int i, j, n, y, best, bestx, besty, shrink, numnodes;
+
+    // Each placement adds at most one node to the skyline
+    nodes = (_GLFWskyline *) malloc( (count + 1) * sizeof(_GLFWskyline) );
+    if( nodes == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    nodes[ 0 ].x = 0;
+    nodes[ 0 ].y = 0;
+    nodes[ 0 ].width = binwidth;
+    numnodes = 1;
+
+    for( n = 0; n < count; n ++ )
+    {
+        i = order[ n ];
+
+        // Find the position with the lowest resulting top edge
+        best = -1;
+        bestx = besty = 0;
+        for( j = 0; j < numnodes; j ++ )
+        {
+            y = FitSkyline( nodes, numnodes, j, binwidth, binheight,
+                            widths[ i ], heights[ i ] );
+            if( y < 0 )
+            {
+                continue;
+            }
+
+            if( best < 0 || y < besty ||
+                ( y == besty && nodes[ j ].x < bestx ) )
+            {
+                best  = j;
+                bestx = nodes[ j ].x;
+                besty = y;
+            }
+        }
+
+        if( best < 0 )
+        {
+            free( nodes );
+            return GL_FALSE;
+        }
+
+        xs[ i ] = bestx;
+        ys[ i ] = besty;
+
+        // Insert the new skyline segment
+        memmove( nodes + best + 1, nodes + best,
+                 (numnodes - best) * sizeof(_GLFWskyline) );
+        nodes[ best ].x = bestx;
+        nodes[ best ].y = besty + heights[ i ];
+        nodes[ best ].width = widths[ i ];
+        numnodes ++;
+
+        // Trim or remove the segments now covered by the new one
+        for( j = best + 1; j < numnodes; )
+        {
+            shrink = nodes[ j - 1 ].x + nodes[ j - 1 ].width - nodes[ j ].x;
+            if( shrink <= 0 )
+            {
+                break;
+            }
+
+            nodes[ j ].x += shrink;
+            nodes[ j ].width -= shrink;
+            if( nodes[ j ].width > 0 )
+            {
+                break;
+            }
+
+            memmove( nodes + j, nodes + j + 1,
+                     (numnodes - j - 1) * sizeof(_GLFWskyline) );
+            numnodes --;
+        }
+
+        // Merge neighbouring segments of equal height
+        for( j = 0; j < numnodes - 1; )
+        {
+            if( nodes[ j ].y == nodes[ j + 1 ].y )
+            {
+                nodes[ j ].width += nodes[ j + 1 ].width;
+                memmove( nodes + j + 1, nodes + j + 2,
+                         (numnodes - j - 2) * sizeof(_GLFWskyline) );
+                numnodes --;
+            }
+            else
+            {
+                j ++;
+            }
+        }
+    }
+
+    free( nodes );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Copy an image into an atlas, optionally replicating its edge pixels
+// into the surrounding padding
+//========================================================================
+
+static void BlitAtlasImage( unsigned char *atlas, int atlaswidth,
+    const GLFWimage *img, int x, int y, int padding, int bleed )
+{
+    int row, col, srcrow, srccol, bpp, rows, cols, first;
+    const unsigned char *src;
+    unsigned char *dst;
+
+    bpp = img->BytesPerPixel;
+
+    if( bleed )
+    {
+        first = 0;
+        rows  = img->Height + padding * 2;
+        cols  = img->Width + padding * 2;
+    }
+    else
+    {
+        first = padding;
+        rows  = img->Height + padding;
+        cols  = img->Width + padding;
+    }
+
+    for( row = first; row < rows; row ++ )
+    {
+        srcrow = row - padding;
+        if( srcrow < 0 )
+        {
+            srcrow = 0;
+        }
+        else if( srcrow >= img->Height )
+        {
+            srcrow = img->Height - 1;
+        }
+
+        dst = atlas + ((y + row) * atlaswidth + x) * bpp;
+        src = img->Data + srcrow * img->Width * bpp;
+
+        if( !bleed )
+        {
+            memcpy( dst + padding * bpp, src, img->Width * bpp );
+            continue;
+        }
+
+        for( col = 0; col < cols; col ++ )
+        {
+            srccol = col - padding;
+            if( srccol < 0 )
+            {
+                srccol = 0;
+            }
+            else if( srccol >= img->Width )
+            {
+                srccol = img->Width - 1;
+            }
+
+            memcpy( dst + col * bpp, src + srccol * bpp, bpp );
+        }
+    }
+}
+
+
+//========================================================================
+// Pack a set of images into a single texture and upload it
+//========================================================================
+
+static int BuildAtlas( GLFWimage *images, int count, int maxsize,
+    int padding, int flags, GLFWatlas *atlas )
+{
+    GLFWimage     img;
+    GLFWatlasrect *rect;
+    int           *widths, *heights, *order, *xs, *ys;
+    double        area;
+    int           i, j, tmp, width, height, bpp, format, packed, success;
+
+    // All images share a pixel format that can hold any of them
+    GetCommonFormat( images, count, &bpp, &format );
+    for( i = 0; i < count; i ++ )
+    {
+        if( !ExpandImage( &images[ i ], bpp, format ) )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    widths = (int *) malloc( count * 5 * sizeof(int) );
+    if( widths == NULL )
+    {
+        return GL_FALSE;
+    }
+    heights = widths + count;
+    order   = widths + count * 2;
+    xs      = widths + count * 3;
+    ys      = widths + count * 4;
+
+    // Sort the padded images by decreasing height for better packing
+    area = 0;
+    width = height = 1;
+    for( i = 0; i < count; i ++ )
+    {
+        widths[ i ]  = images[ i ].Width + padding * 2;
+        heights[ i ] = images[ i ].Height + padding * 2;
+        order[ i ]   = i;
+        area += (double) widths[ i ] * (double) heights[ i ];
+
+        for( j = i; j > 0 && heights[ order[ j - 1 ] ] < heights[ order[ j ] ]; j -- )
+        {
+            tmp = order[ j ];
+            order[ j ] = order[ j - 1 ];
+            order[ j - 1 ] = tmp;
+        }
+
+        while( width < widths[ i ] )
+        {
+            width <<= 1;
+        }
+        while( height < heights[ i ] )
+        {
+            height <<= 1;
+        }
+    }
+
+    // Start with the smallest 2^N x 2^M bin that could possibly hold all
+    // images and grow it until they fit
+    while( (double) width * (double) height < area &&
+           width <= maxsize && height <= maxsize )
+    {
+        if( height < width )
+        {
+            height <<= 1;
+        }
+        else
+        {
+            width <<= 1;
+        }
+    }
+
+    packed = GL_FALSE;
+    while( width <= maxsize && height <= maxsize )
+    {
+        if( PackSkyline( width, height, widths, heights, order, count,
+                         xs, ys ) )
+        {
+            packed = GL_TRUE;
+            break;
+        }
+
+        if( height < width )
+        {
+            height <<= 1;
+        }
+        else
+        {
+            width <<= 1;
+        }
+    }
+
+    if( !packed )
+    {
+        free( widths );
+        return GL_FALSE;
+    }
+
+    atlas->Rects = (GLFWatlasrect *) malloc( count * sizeof(GLFWatlasrect) );
+    img.Data = (unsigned char *) calloc( width * height, bpp );
+    if( atlas->Rects == NULL || img.Data == NULL )
+    {
+        free( img.Data );
+        free( widths );
+        return GL_FALSE;
+    }
+
+    for( i = 0; i < count; i ++ )
+    {
+        BlitAtlasImage( img.Data, width, &images[ i ], xs[ i ], ys[ i ],
+                        padding, flags & GLFW_EDGE_BLEED_BIT );
+
+        rect = &atlas->Rects[ i ];
+        rect->X      = xs[ i ] + padding;
+        rect->Y      = ys[ i ] + padding;
+        rect->Width  = images[ i ].Width;
+        rect->Height = images[ i ].Height;
+        rect->S0     = (float) rect->X / (float) width;
+        rect->T0     = (float) rect->Y / (float) height;
+        rect->S1     = (float) (rect->X + rect->Width) / (float) width;
+        rect->T1     = (float) (rect->Y + rect->Height) / (float) height;
+    }
+
+    free( widths );
+
+    img.Width         = width;
+    img.Height        = height;
+    img.BytesPerPixel = bpp;
+    img.Format        = format;
+
+    atlas->Width  = width;
+    atlas->Height = height;
+    atlas->Format = img.Format;
+    atlas->Count  = count;
+
+    // The upload may replace the pixel data, so free whatever it leaves
+    success = glfwLoadTextureImage2D( &img, flags );
+    free( img.Data );
+
+    return success;
+}
+
+
+//************************************************************************
+//****                    GLFW user functions                         ****
+//************************************************************************
+
+//========================================================================
+// Read an image from a named file
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadImage( const char *name, GLFWimage *img,
+    int flags )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // The image may already have been decoded by glfwPrefetchImages
+    if( _glfwTakePrefetchedImage( name, img, flags ) )
+    {
+        return GL_TRUE;
+    }
+
+    return _glfwReadImageFile( name, img, flags );
+}
+
+
+//========================================================================
+// Read an image file from a memory buffer
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadMemoryImage( const void *data, long size, GLFWimage *img, int flags )
+{
+    _GLFWstream stream;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    // Open buffer
+    if( !_glfwOpenBufferStream( &stream, (void*) data, size ) )
+    {
+        return GL_FALSE;
+    }
+
+    return ReadImage( &stream, img, flags );
+}
+
+
+//========================================================================
+// Read an image file through user supplied stream I/O functions
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadStreamImage( const GLFWstreamfuns *funs,
+    void *user, GLFWimage *img, int flags )
+{
+    _GLFWstream stream;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    // Open user stream
+    if( !_glfwOpenUserStream( &stream, funs, user ) )
+    {
+        return GL_FALSE;
+    }
+
+    return ReadImage( &stream, img, flags );
+}
+
+
+//========================================================================
+// Read a rectangular region of an image from a named file, without
+// decoding the rest of the image
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadImageRegion( const char *name, int x,
+    int y, int width, int height, GLFWimage *img, int flags )
+{
+    _GLFWstream stream;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    // Open file
+    if( !_glfwOpenFileStream( &stream, name, "rb" ) )
+    {
+        return GL_FALSE;
+    }
+
+    if( !_glfwDetectGzipStream( &stream ) ||
+        !ReadImageRegion( &stream, x, y, width, height, img, flags ) )
+    {
+        _glfwCloseStream( &stream );
+        return GL_FALSE;
+    }
+
+    // Close stream
+    _glfwCloseStream( &stream );
+
+    // Should we rescale the image to closest 2^N x 2^M resolution?
+    if( !(flags & GLFW_NO_RESCALE_BIT) )
+    {
+        if( !RescaleImage( img ) )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    // Interpret BytesPerPixel as an OpenGL format
+    SetImageFormat( img, flags );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read a batch of image files, keeping many file reads in flight at once
+// and decoding the files as they arrive. Returns the number of images
+// that were read successfully
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadImages( const char **names, int count,
+    GLFWimage *images, int flags )
+{
+    _GLFWimagebatch batch;
+    _GLFWworkset    work;
+    int             i, numthreads, perthread;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || count <= 0 )
+    {
+        return 0;
+    }
+
+    // Start with empty image descriptors
+    for( i = 0; i < count; i ++ )
+    {
+        images[ i ].Width         = 0;
+        images[ i ].Height        = 0;
+        images[ i ].BytesPerPixel = 0;
+        images[ i ].Data          = NULL;
+    }
+
+    batch.names  = names;
+    batch.images = images;
+    batch.flags  = flags;
+    batch.loaded = 0;
+
+    // If no file queue can be opened, more threads are needed to keep
+    // enough reads in flight. One that can is handed to a worker rather
+    // than opened again
+    batch.queue = _glfwPlatformOpenFileQueue( _GLFW_READ_DEPTH );
+    batch.async = batch.queue != NULL;
+
+    numthreads = _glfwGetUsableProcessors();
+    if( batch.async )
+    {
+        // Decoding is the bottleneck, so there is no point in having more
+        // threads than processors, or than there are queues to fill
+        perthread = _GLFW_READ_DEPTH;
+    }
+    else
+    {
+        perthread = 1;
+        if( numthreads < _GLFW_READ_THREADS )
+        {
+            numthreads = _GLFW_READ_THREADS;
+        }
+    }
+    if( numthreads > (count + perthread - 1) / perthread )
+    {
+        numthreads = (count + perthread - 1) / perthread;
+    }
+
+    work.count  = count;
+    work.worker = ReadImageBatchWorker;
+    work.arg    = &batch;
+    _glfwRunWorkset( &work, numthreads );
+
+    // The calling thread always runs a worker that takes the queue, but
+    // do not leak it should that ever change
+    if( batch.queue != NULL )
+    {
+        _glfwPlatformCloseFileQueue( batch.queue );
+    }
+
+    return batch.loaded;
+}
+
+
+//========================================================================
+// Read an image from a named file into memory that can be shared with
+// another process through the returned handle
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadImageShared( const char *name,
+    GLFWimage *img, int flags, int *handle )
+{
+    _GLFWstream stream;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    // Open file
+    if( !_glfwOpenFileStream( &stream, name, "rb" ) )
+    {
+        return GL_FALSE;
+    }
+
+    return ReadSharedImage( &stream, img, flags, handle );
+}
+
+
+//========================================================================
+// Map an image shared by another process, without copying its pixels
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwMapSharedImage( int handle, GLFWimage *img )
+{
+    _GLFWsharedheader header;
+    unsigned char *base;
+    size_t size;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    base = (unsigned char *) _glfwPlatformMapSharedMemory( handle, &size );
+    if( base == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // The sender may not be trusted, so check that the header describes
+    // an image that fits in the shared memory
+    if( size >= _GLFW_SHARED_HEADER_SIZE )
+    {
+        memcpy( &header, base, sizeof(header) );
+    }
+    if( size < _GLFW_SHARED_HEADER_SIZE ||
+        memcmp( header.magic, _GLFW_SHARED_MAGIC, 8 ) != 0 ||
+        header.width <= 0 || header.height <= 0 ||
+        header.bytesPerPixel < 1 || header.bytesPerPixel > 4 ||
+        (size - _GLFW_SHARED_HEADER_SIZE) / header.bytesPerPixel /
+            header.height < (size_t) header.width )
+    {
+        _glfwPlatformUnmapSharedMemory( base, size );
+        return GL_FALSE;
+    }
+
+    // The handle still belongs to the caller
+    if( !AddSharedImage( base, size, -1 ) )
+    {
+        _glfwPlatformUnmapSharedMemory( base, size );
+        return GL_FALSE;
+    }
+
+    img->Width         = header.width;
+    img->Height        = header.height;
+    img->Format        = header.format;
+    img->BytesPerPixel = header.bytesPerPixel;
+    img->Data          = base + _GLFW_SHARED_HEADER_SIZE;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Free allocated memory for an image
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwFreeImage( GLFWimage *img )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return;
+    }
+
+    // Free memory (shared images are unmapped instead)
+    if( img->Data != NULL )
+    {
+        if( _glfwSharedImages == NULL || !FreeSharedImage( img->Data ) )
+        {
+            free( img->Data );
+        }
+        img->Data = NULL;
+    }
+
+    // Clear all fields
+    img->Width         = 0;
+    img->Height        = 0;
+    img->Format        = 0;
+    img->BytesPerPixel = 0;
+}
+
+
+//========================================================================
+// Open an image file for reading rectangular tiles from it, without
+// loading all of it into memory
+//========================================================================
+
+GLFWAPI GLFWtiledimage GLFWAPIENTRY glfwOpenImageTiles( const char *name,
+    int *width, int *height, int flags )
+{
+    _GLFWtiles *tiles;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    tiles = (_GLFWtiles *) malloc( sizeof(_GLFWtiles) );
+    if( tiles == NULL )
+    {
+        return NULL;
+    }
+    memset( tiles, 0, sizeof(_GLFWtiles) );
+
+    // Open file
+    if( !_glfwOpenFileStream( &tiles->stream, name, "rb" ) )
+    {
+        free( tiles );
+        return NULL;
+    }
+
+    // We only support (optionally gzip compressed) TGA files at the moment
+    if( !_glfwDetectGzipStream( &tiles->stream ) ||
+        !_glfwOpenTGATiles( tiles, flags, GL_TRUE ) )
+    {
+        _glfwCloseTGATiles( tiles );
+        _glfwCloseStream( &tiles->stream );
+        free( tiles );
+        return NULL;
+    }
+
+    if( width )
+    {
+        *width = tiles->width;
+    }
+    if( height )
+    {
+        *height = tiles->height;
+    }
+
+    return (GLFWtiledimage) tiles;
+}
+
+
+//========================================================================
+// Read a rectangular tile from an image opened with glfwOpenImageTiles
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwReadImageTile( GLFWtiledimage image, int x,
+    int y, int width, int height, GLFWimage *img )
+{
+    _GLFWtiles *tiles = (_GLFWtiles *) image;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || tiles == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // Start with an empty image descriptor
+    img->Width         = 0;
+    img->Height        = 0;
+    img->BytesPerPixel = 0;
+    img->Data          = NULL;
+
+    if( !_glfwReadTGATile( tiles, x, y, width, height,
+                           SubsampleShift( tiles->flags ), img ) )
+    {
+        return GL_FALSE;
+    }
+
+    // Interpret BytesPerPixel as an OpenGL format
+    SetImageFormat( img, tiles->flags );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Close an image opened with glfwOpenImageTiles
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwCloseImageTiles( GLFWtiledimage image )
+{
+    _GLFWtiles *tiles = (_GLFWtiles *) image;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || tiles == NULL )
+    {
+        return;
+    }
+
+    _glfwCloseTGATiles( tiles );
+    _glfwCloseStream( &tiles->stream );
+    free( tiles );
+}
+
+
+//========================================================================
+// Read an image from a file, and upload it to texture memory
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwLoadTexture2D( const char *name, int flags )
+{
+    GLFWimage img;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    // Force rescaling if necessary
+    if( !_glfwWin.has_GL_ARB_texture_non_power_of_two )
+    {
+        flags &= (~GLFW_NO_RESCALE_BIT);
+    }
+
+    // Read image from file
+    if( !glfwReadImage( name, &img, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    if( !glfwLoadTextureImage2D( &img, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    // Data buffer is not needed anymore
+    glfwFreeImage( &img );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read an image from a buffer, and upload it to texture memory
+//========================================================================
+
+GLFWAPI int  GLFWAPIENTRY glfwLoadMemoryTexture2D( const void *data, long size, int flags )
+{
+    GLFWimage img;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    // Force rescaling if necessary
+    if( !_glfwWin.has_GL_ARB_texture_non_power_of_two )
+    {
+        flags &= (~GLFW_NO_RESCALE_BIT);
+    }
+
+    // Read image from file
+    if( !glfwReadMemoryImage( data, size, &img, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    if( !glfwLoadTextureImage2D( &img, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    // Data buffer is not needed anymore
+    glfwFreeImage( &img );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Upload an image object to texture memory
+//========================================================================
+
+GLFWAPI int  GLFWAPIENTRY glfwLoadTextureImage2D( GLFWimage *img, int flags )
+{
+    int     newsize, n;
+    unsigned char *data, *dataptr;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    // TODO: Use GL_MAX_TEXTURE_SIZE or GL_PROXY_TEXTURE_2D to determine
+    //       whether the image size is valid.
+    // NOTE: May require box filter downsampling routine.
+
+    // Do we need to convert the alpha map to RGBA format (OpenGL 1.0)?
+    if( (_glfwWin.glMajor == 1) && (_glfwWin.glMinor == 0) &&
+        (img->Format == GL_ALPHA) )
+    {
+        // We go to RGBA representation instead
+        img->BytesPerPixel = 4;
+
+        // Allocate memory for new RGBA image data
+        newsize = img->Width * img->Height * img->BytesPerPixel;
+        data = (unsigned char *) malloc( newsize );
+        if( data == NULL )
+        {
+            free( img->Data );
+            return GL_FALSE;
+        }
+
+        // Convert Alpha map to RGBA
+        dataptr = data;
+        for( n = 0; n < (img->Width*img->Height); ++ n )
+        {
+            *dataptr ++ = 255;
+            *dataptr ++ = 255;
+            *dataptr ++ = 255;
+            *dataptr ++ = img->Data[n];
+        }
+
+        // Free memory for old image data (not needed anymore)
+        free( img->Data );
+
+        // Set pointer to new image data
+        img->Data = data;
+    }
+
+    UploadImage( GL_TEXTURE_2D, GL_TEXTURE_2D, img, flags );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read a set of images, pack them into a single texture and upload it to
+// texture memory
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwBuildTextureAtlas( const char **names,
+    int count, int maxsize, int padding, int flags, GLFWatlas *atlas )
+{
+    GLFWimage *images;
+    GLint     maxtexsize;
+    int       i, success;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    memset( atlas, 0, sizeof(GLFWatlas) );
+
+    if( count < 1 || padding < 0 )
+    {
+        return GL_FALSE;
+    }
+
+    glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxtexsize );
+    if( maxsize <= 0 || maxsize > maxtexsize )
+    {
+        maxsize = maxtexsize;
+    }
+
+    images = (GLFWimage *) malloc( count * sizeof(GLFWimage) );
+    if( images == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // The atlas is rescaled as a whole, never the individual images
+    if( !_glfwReadImageSet( names, count, images,
+                            flags | GLFW_NO_RESCALE_BIT ) )
+    {
+        free( images );
+        return GL_FALSE;
+    }
+
+    success = BuildAtlas( images, count, maxsize, padding, flags, atlas );
+
+    for( i = 0; i < count; i ++ )
+    {
+        glfwFreeImage( &images[ i ] );
+    }
+    free( images );
+
+    if( !success )
+    {
+        glfwFreeTextureAtlas( atlas );
+    }
+
+    return success;
+}
+
+
+//========================================================================
+// Free the sub-image information of a texture atlas
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwFreeTextureAtlas( GLFWatlas *atlas )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return;
+    }
+
+    if( atlas->Rects != NULL )
+    {
+        free( atlas->Rects );
+    }
+
+    memset( atlas, 0, sizeof(GLFWatlas) );
+}
+
+
+//========================================================================
+// Read a set of images, and upload them as the layers of a 2D array
+// texture
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwLoadTextureArray( const char **names,
+    int count, int flags )
+{
+    _GLFWteximage3dfun TexImage3D;
+    GLFWimage     *images;
+    GLint         UnpackAlignment;
+    unsigned char *data;
+    int           i, level, width, height, bpp, layersize, more;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    // Do we have texture arrays (added to core in version 3.0)?
+    if( _glfwWin.glMajor < 3 &&
+        !glfwExtensionSupported( "GL_EXT_texture_array" ) )
+    {
+        return GL_FALSE;
+    }
+
+    TexImage3D = (_GLFWteximage3dfun) glfwGetProcAddress( "glTexImage3D" );
+    if( TexImage3D == NULL || count < 1 )
+    {
+        return GL_FALSE;
+    }
+
+    images = (GLFWimage *) malloc( count * sizeof(GLFWimage) );
+    if( images == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !ReadImageLayers( names, count, images, flags ) )
+    {
+        free( images );
+        return GL_FALSE;
+    }
+
+    width  = images[ 0 ].Width;
+    height = images[ 0 ].Height;
+    bpp    = images[ 0 ].BytesPerPixel;
+
+    // All layers of a mipmap level are uploaded from one contiguous block
+    data = (unsigned char *) malloc( width * height * bpp * count );
+    if( data == NULL )
+    {
+        for( i = 0; i < count; i ++ )
+        {
+            glfwFreeImage( &images[ i ] );
+        }
+        free( images );
+        return GL_FALSE;
+    }
+
+    // Set unpack alignment to one byte
+    glGetIntegerv( GL_UNPACK_ALIGNMENT, &UnpackAlignment );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    level = 0;
+    do
+    {
+        layersize = width * height * bpp;
+        for( i = 0; i < count; i ++ )
+        {
+            memcpy( data + i * layersize, images[ i ].Data, layersize );
+        }
+
+        // Upload this mipmap level
+        TexImage3D( GL_TEXTURE_2D_ARRAY_EXT, level, images[ 0 ].Format,
+            width, height, count, 0, images[ 0 ].Format,
+            GL_UNSIGNED_BYTE, (void*) data );
+
+        // Build next mipmap level of every layer, if required
+        more = GL_FALSE;
+        if( flags & GLFW_BUILD_MIPMAPS_BIT )
+        {
+            for( i = 0; i < count; i ++ )
+            {
+                more = HalveImage( images[ i ].Data, &images[ i ].Width,
+                                   &images[ i ].Height, bpp );
+            }
+
+            width  = images[ 0 ].Width;
+            height = images[ 0 ].Height;
+        }
+
+        level ++;
+    }
+    while( more );
+
+    // Restore old unpack alignment
+    glPixelStorei( GL_UNPACK_ALIGNMENT, UnpackAlignment );
+
+    free( data );
+    for( i = 0; i < count; i ++ )
+    {
+        glfwFreeImage( &images[ i ] );
+    }
+    free( images );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read six images, and upload them as the faces of a cube map texture
+// (in the order +X, -X, +Y, -Y, +Z, -Z)
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwLoadTextureCube( const char **names,
+    int flags )
+{
+    GLFWimage images[ 6 ];
+    int       i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || !_glfwWin.opened )
+    {
+        return GL_FALSE;
+    }
+
+    // Do we have cube maps (added to core in version 1.3)?
+    if( _glfwWin.glMajor == 1 && _glfwWin.glMinor < 3 &&
+        !glfwExtensionSupported( "GL_ARB_texture_cube_map" ) )
+    {
+        return GL_FALSE;
+    }
+
+    if( !ReadImageLayers( names, 6, images, flags ) )
+    {
+        return GL_FALSE;
+    }
+
+    // Cube map faces must be square
+    if( images[ 0 ].Width != images[ 0 ].Height )
+    {
+        for( i = 0; i < 6; i ++ )
+        {
+            glfwFreeImage( &images[ i ] );
+        }
+        return GL_FALSE;
+    }
+
+    for( i = 0; i < 6; i ++ )
+    {
+        UploadImage( GL_TEXTURE_CUBE_MAP,
+                     GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                     &images[ i ], flags );
+        glfwFreeImage( &images[ i ] );
+    }
+
+    return GL_TRUE;
+}
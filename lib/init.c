@@ -66,6 +66,12 @@ GLFWAPI int GLFWAPIENTRY glfwInit( void )
         return GL_FALSE;
     }
 
+    // Lock profiling may be enabled from the environment
+    _glfwInitLockStats();
+
+    // Packs can be mounted from any thread, so their list needs a lock
+    _glfwInitPacks();
+
     // Form now on, GLFW state is valid
     _glfwInitialized = GL_TRUE;
 
@@ -86,12 +92,23 @@ GLFWAPI void GLFWAPIENTRY glfwTerminate( void )
         return;
     }
 
+    // Stop thread pools and image prefetching (before the threads are
+    // torn down)
+    _glfwTerminatePools();
+    _glfwTerminatePrefetch();
+
     // Platform specific termination
     if( !_glfwPlatformTerminate() )
     {
         return;
     }
 
+    // Unmount any packs still mounted
+    _glfwTerminatePacks();
+
+    // Free lock statistics (no threads are left to update them)
+    _glfwTerminateLockStats();
+
     // GLFW is no longer initialized
     _glfwInitialized = GL_FALSE;
 }
@@ -146,18 +146,104 @@ int _glfwInitialized = 0;
 GLFWGLOBAL int _glfwInitialized;
 #endif
 
+// Flag indicating if mutexes and condition variables are being profiled
+#if defined( _init_c_ )
+int _glfwLockProfiling = 0;
+#else
+GLFWGLOBAL int _glfwLockProfiling;
+#endif
+
+
+//------------------------------------------------------------------------
+// Stream offset (64-bit, as large images do not fit in a long everywhere)
+//------------------------------------------------------------------------
+typedef long long _GLFWoffset;
+
 
 //------------------------------------------------------------------------
 // Abstract data stream (for image I/O)
 //------------------------------------------------------------------------
+typedef struct _GLFWinflater_struct _GLFWinflater;
+typedef struct _GLFWpack_struct _GLFWpack;
+
 typedef struct {
-    FILE*   file;
-    void*   data;
-    long    position;
-    long    size;
+    FILE*       file;
+    void*       data;
+    _GLFWoffset position;
+    _GLFWoffset size;
+    const GLFWstreamfuns *funs;
+    void*       user;
+    int         freeData;
+
+    // Decompression state, for gzip compressed streams
+    _GLFWinflater *inflater;
+
+    // Mounted pack that data points into, kept mapped until closed
+    _GLFWpack   *pack;
 } _GLFWstream;
 
 
+//------------------------------------------------------------------------
+// Image opened for random access to rectangular tiles
+//------------------------------------------------------------------------
+typedef struct {
+    _GLFWstream stream;
+    int         width, height;
+    int         flags;
+
+    // Stored and expanded (colormap looked up) bytes per pixel
+    int         bpp, bpp2;
+
+    // Image origin as stored in the file
+    int         swapx, swapy;
+
+    // Colormap (converted to RGB/RGBA), if any
+    unsigned char *cmap;
+
+    // Pixel data start, and for RLE images the position of the packet
+    // holding the first pixel of each row and how much of it precedes the
+    // row (only when opened for random access)
+    _GLFWoffset dataStart;
+    _GLFWoffset *rowOffset;
+    int         *rowSkip;
+
+    // RLE decoder state (next stored row, and what is left of the current
+    // packet)
+    int         rle;
+    int         nextRow;
+    int         runCount, runRaw;
+    unsigned char runPixel[ 4 ];
+
+    // Scratch buffer for a single stored row
+    unsigned char *row;
+
+    // If set, tiles are decoded into this buffer rather than a new one
+    unsigned char *target;
+} _GLFWtiles;
+
+
+//------------------------------------------------------------------------
+// Queue of whole file reads in flight (platform specific)
+//------------------------------------------------------------------------
+typedef struct _GLFWfilequeue_struct _GLFWfilequeue;
+
+
+//------------------------------------------------------------------------
+// Set of independent work items shared out over several threads
+//------------------------------------------------------------------------
+typedef struct _GLFWworkset_struct _GLFWworkset;
+
+struct _GLFWworkset_struct {
+    int         count;
+    void        (*worker)( _GLFWworkset *work );
+    void        *arg;
+
+    // Next unclaimed item and failure flag, only accessed atomically
+    int         next;
+    int         failed;
+};
+
+
 //========================================================================
 // Prototypes for platform specific implementation functions
 //========================================================================
@@ -184,25 +270,59 @@ int _glfwPlatformGetJoystickPos( int joy, float *pos, int numaxes );
 int _glfwPlatformGetJoystickButtons( int joy, unsigned char *buttons, int numbuttons );
 
 // Threads
-GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg );
+GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg, const GLFWthreadattribs *attribs );
 void _glfwPlatformDestroyThread( GLFWthread ID );
 int _glfwPlatformWaitThread( GLFWthread ID, int waitmode );
 GLFWthread _glfwPlatformGetThreadID( void );
-GLFWmutex _glfwPlatformCreateMutex( void );
+double _glfwPlatformGetThreadCPUTime( GLFWthread ID );
+int _glfwPlatformGetThreadContextSwitches( GLFWthread ID, int *voluntary, int *involuntary );
+GLFWmutex _glfwPlatformCreateMutex( int mode );
 void _glfwPlatformDestroyMutex( GLFWmutex mutex );
 void _glfwPlatformLockMutex( GLFWmutex mutex );
 void _glfwPlatformUnlockMutex( GLFWmutex mutex );
+int  _glfwPlatformTryLockMutex( GLFWmutex mutex );
 GLFWcond _glfwPlatformCreateCond( void );
 void _glfwPlatformDestroyCond( GLFWcond cond );
 void _glfwPlatformWaitCond( GLFWcond cond, GLFWmutex mutex, double timeout );
 void _glfwPlatformSignalCond( GLFWcond cond );
 void _glfwPlatformBroadcastCond( GLFWcond cond );
 int _glfwPlatformGetNumberOfProcessors( void );
+int _glfwPlatformGetCPUTopology( GLFWcputopology *topology );
+void _glfwPlatformWaitAddress( volatile int *address, int value, double timeout );
+void _glfwPlatformWakeAddress( volatile int *address, int count );
+void _glfwPlatformSetThreadData( void *data );
+void * _glfwPlatformGetThreadData( void );
+
+// Fibers
+void * _glfwPlatformCreateFiber( void (*fun)( void * ), void *arg, size_t stacksize );
+void * _glfwPlatformConvertThreadToFiber( void );
+void _glfwPlatformConvertFiberToThread( void *fiber );
+void _glfwPlatformSwitchFiber( void *from, void *to );
+void _glfwPlatformDestroyFiber( void *fiber );
+
+// File mapping
+void * _glfwPlatformMapFile( const char *name, _GLFWoffset *size );
+void _glfwPlatformUnmapFile( void *data, _GLFWoffset size );
+
+// Batched file reading
+_GLFWfilequeue * _glfwPlatformOpenFileQueue( int depth );
+int _glfwPlatformQueueFileRead( _GLFWfilequeue *queue, const char *name, int index );
+int _glfwPlatformWaitFileRead( _GLFWfilequeue *queue, int *index, void **data, _GLFWoffset *size );
+void _glfwPlatformCloseFileQueue( _GLFWfilequeue *queue );
+void _glfwPlatformPrefetchFile( const char *name );
+
+// Shared memory
+void * _glfwPlatformCreateSharedMemory( size_t size, int *handle );
+void * _glfwPlatformMapSharedMemory( int handle, size_t *size );
+void _glfwPlatformUnmapSharedMemory( void *data, size_t size );
+void _glfwPlatformCloseSharedMemory( int handle );
 
 // Time
 double _glfwPlatformGetTime( void );
 void _glfwPlatformSetTime( double time );
 void _glfwPlatformSleep( double time );
+int  _glfwPlatformBeginPreciseSleep( void );
+void _glfwPlatformEndPreciseSleep( int state );
 
 // Window management
 int  _glfwPlatformOpenWindow( int width, int height, const _GLFWwndconfig *wndconfig, const _GLFWfbconfig *fbconfig );
@@ -240,6 +360,18 @@ void _glfwInputMouseClick( int button, int action );
 _GLFWthread * _glfwGetThreadPointer( int ID );
 void _glfwAppendThread( _GLFWthread * t );
 void _glfwRemoveThread( _GLFWthread * t );
+int _glfwGetUsableProcessors( void );
+int _glfwClaimWorkItem( _GLFWworkset *work );
+void _glfwFailWorkItem( _GLFWworkset *work );
+int _glfwRunWorkset( _GLFWworkset *work, int numthreads );
+GLFWthreadattribs * _glfwCopyThreadAttribs( const GLFWthreadattribs *attribs );
+
+// Lock profiling (lockstat.c)
+void _glfwInitLockStats( void );
+void _glfwTerminateLockStats( void );
+void _glfwForgetLockStats( void *lock );
+void _glfwProfileLockMutex( GLFWmutex mutex );
+void _glfwProfileWaitCond( GLFWcond cond, GLFWmutex mutex, double timeout );
 
 // OpenGL extensions (glext.c)
 void _glfwParseGLVersion( int *major, int *minor, int *rev );
@@ -248,14 +380,37 @@ void _glfwRefreshContextParams( void );
 
 // Abstracted data streams (stream.c)
 int _glfwOpenFileStream( _GLFWstream *stream, const char *name, const char *mode );
-int _glfwOpenBufferStream( _GLFWstream *stream, void *data, long size );
-long _glfwReadStream( _GLFWstream *stream, void *data, long size );
-long _glfwTellStream( _GLFWstream *stream );
-int _glfwSeekStream( _GLFWstream *stream, long offset, int whence );
+int _glfwOpenBufferStream( _GLFWstream *stream, void *data, _GLFWoffset size );
+int _glfwOpenUserStream( _GLFWstream *stream, const GLFWstreamfuns *funs, void *user );
+size_t _glfwReadStream( _GLFWstream *stream, void *data, size_t size );
+const void *_glfwBorrowStream( _GLFWstream *stream, size_t size );
+int _glfwDetectGzipStream( _GLFWstream *stream );
+_GLFWoffset _glfwTellStream( _GLFWstream *stream );
+int _glfwSeekStream( _GLFWstream *stream, _GLFWoffset offset, int whence );
 void _glfwCloseStream( _GLFWstream *stream );
 
+// Packs (pack.c)
+int _glfwOpenPackStream( _GLFWstream *stream, const char *name );
+void _glfwReleasePack( _GLFWpack *pack );
+void _glfwInitPacks( void );
+void _glfwTerminatePacks( void );
+
+// Image I/O (image.c)
+int _glfwReadImageFile( const char *name, GLFWimage *img, int flags );
+int _glfwReadImageSet( const char **names, int count, GLFWimage *images, int flags );
+
+// Thread pools (pool.c)
+void _glfwTerminatePools( void );
+
+// Image prefetching (prefetch.c)
+int _glfwTakePrefetchedImage( const char *name, GLFWimage *img, int flags );
+void _glfwTerminatePrefetch( void );
+
 // Targa image I/O (tga.c)
 int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags );
+int _glfwOpenTGATiles( _GLFWtiles *t, int flags, int random );
+int _glfwReadTGATile( _GLFWtiles *t, int x, int y, int width, int height, int shift, GLFWimage *img );
+void _glfwCloseTGATiles( _GLFWtiles *t );
 
 // Framebuffer configs
 const _GLFWfbconfig *_glfwChooseFBConfig( const _GLFWfbconfig *desired,
@@ -0,0 +1,492 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+//========================================================================
+// Description:
+//
+// Lock profiling: counts of how often each mutex is locked and how often
+// it was already held, and how long threads waited for it, plus the same
+// for waits on condition variables.
+//
+// Statistics live in a hash table keyed by the lock handle, so the
+// platform lock objects stay as they are. Entries are only ever added
+// until glfwTerminate, so lookups need no lock. When a lock is destroyed
+// its entry is released, and is reused by the next lock that hashes to
+// the same bucket, so the table only grows with the number of locks that
+// exist at the same time. Adding and releasing entries is serialized by
+// a mutex of its own.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <string.h>
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Number of hash buckets for looking up the statistics of a lock
+#define _GLFW_LOCKSTAT_BUCKETS  256
+
+
+//========================================================================
+// Statistics for a single mutex or condition variable
+//========================================================================
+
+typedef struct _GLFWlockstat_struct _GLFWlockstat;
+
+struct _GLFWlockstat_struct {
+    void * volatile lock;       // NULL while the entry is unused
+    int           type;
+    char          name[ 32 ];
+    volatile int  acquisitions;
+    volatile int  contended;
+    volatile int  histogram[ GLFW_LOCK_HISTOGRAM_SIZE ];
+    _GLFWlockstat *next;        // Set before the entry is published
+};
+
+static _GLFWlockstat * volatile _glfwLockStats[ _GLFW_LOCKSTAT_BUCKETS ];
+
+// Serializes adding and releasing entries
+static GLFWmutex _glfwLockStatMutex = NULL;
+
+
+//========================================================================
+// Return the hash bucket for a lock handle
+//========================================================================
+
+static _GLFWlockstat * volatile * LockStatBucket( void *lock )
+{
+    size_t h = (size_t) lock;
+
+    // Handles are heap pointers, so the low bits carry little information
+    h ^= h >> 4;
+    h ^= h >> 12;
+
+    return &_glfwLockStats[ h % _GLFW_LOCKSTAT_BUCKETS ];
+}
+
+
+//========================================================================
+// Find the statistics of a lock among the entries from the given one on
+//========================================================================
+
+static _GLFWlockstat * FindLockStat( _GLFWlockstat *stat, void *lock )
+{
+    for( ;  stat != NULL;  stat = stat->next )
+    {
+        if( _glfwAtomicLoadPtr( &stat->lock ) == lock )
+        {
+            return stat;
+        }
+    }
+
+    return NULL;
+}
+
+
+//========================================================================
+// Return the statistics of a lock, creating them if needed
+//========================================================================
+
+static _GLFWlockstat * GetLockStat( void *lock, int type )
+{
+    _GLFWlockstat * volatile *bucket;
+    _GLFWlockstat *head, *stat;
+
+    bucket = LockStatBucket( lock );
+
+    head = (_GLFWlockstat *) _glfwAtomicLoadPtr( bucket );
+    stat = FindLockStat( head, lock );
+    if( stat != NULL || _glfwLockStatMutex == NULL )
+    {
+        return stat;
+    }
+
+    _glfwPlatformLockMutex( _glfwLockStatMutex );
+
+    // Another thread may have added the entry while we waited
+    head = (_GLFWlockstat *) _glfwAtomicLoadPtr( bucket );
+    stat = FindLockStat( head, lock );
+    if( stat != NULL )
+    {
+        _glfwPlatformUnlockMutex( _glfwLockStatMutex );
+        return stat;
+    }
+
+    // Reuse the entry of a destroyed lock if there is one, and otherwise
+    // add a new entry in front of the bucket
+    for( stat = head;  stat != NULL;  stat = stat->next )
+    {
+        if( _glfwAtomicLoadPtr( &stat->lock ) == NULL )
+        {
+            break;
+        }
+    }
+
+    if( stat == NULL )
+    {
+        stat = (_GLFWlockstat *) calloc( 1, sizeof(_GLFWlockstat) );
+        if( stat != NULL )
+        {
+            stat->type = type;
+            stat->next = head;
+            _glfwAtomicStorePtr( &stat->lock, lock );
+            _glfwAtomicStorePtr( bucket, stat );
+        }
+    }
+    else
+    {
+        memset( stat->name, 0, sizeof(stat->name) );
+        memset( (void *) stat->histogram, 0, sizeof(stat->histogram) );
+        stat->acquisitions = 0;
+        stat->contended    = 0;
+        stat->type         = type;
+        _glfwAtomicStorePtr( &stat->lock, lock );
+    }
+
+    _glfwPlatformUnlockMutex( _glfwLockStatMutex );
+
+    return stat;
+}
+
+
+//========================================================================
+// Count a wait in the histogram of a lock
+//========================================================================
+
+static void CountLockWait( _GLFWlockstat *stat, double wait )
+{
+    int bucket = 0;
+    double limit = 1e-6;
+
+    while( wait >= limit && bucket < GLFW_LOCK_HISTOGRAM_SIZE - 1 )
+    {
+        limit *= 2.0;
+        bucket ++;
+    }
+
+    (void) _glfwAtomicAdd( &stat->histogram[ bucket ], 1 );
+}
+
+
+//========================================================================
+// Copy the statistics of a lock for reporting
+//========================================================================
+
+static void CopyLockStat( GLFWlockstats *dest, _GLFWlockstat *stat )
+{
+    int i;
+
+    dest->Lock = _glfwAtomicLoadPtr( &stat->lock );
+    dest->Type = stat->type;
+    memcpy( dest->Name, stat->name, sizeof(dest->Name) );
+    dest->Name[ sizeof(dest->Name) - 1 ] = '\0';
+
+    dest->Acquisitions = _glfwAtomicLoadRelaxed( &stat->acquisitions );
+    dest->Contended    = _glfwAtomicLoadRelaxed( &stat->contended );
+    for( i = 0;  i < GLFW_LOCK_HISTOGRAM_SIZE;  i ++ )
+    {
+        dest->Histogram[ i ] = _glfwAtomicLoadRelaxed( &stat->histogram[ i ] );
+    }
+}
+
+
+//========================================================================
+// Sort lock statistics with the most contended first
+//========================================================================
+
+static int CompareLockStats( const void *a, const void *b )
+{
+    const GLFWlockstats *x = (const GLFWlockstats *) a;
+    const GLFWlockstats *y = (const GLFWlockstats *) b;
+
+    return (y->Contended > x->Contended) - (y->Contended < x->Contended);
+}
+
+
+//========================================================================
+// Enable lock profiling if the environment asks for it, and create the
+// lock for adding statistics
+//========================================================================
+
+void _glfwInitLockStats( void )
+{
+    const char *value;
+
+    value = getenv( "GLFW_LOCK_PROFILING" );
+    _glfwLockProfiling = value != NULL && *value != '\0' &&
+                         strcmp( value, "0" ) != 0;
+
+    // Profiling may also be enabled later with glfwEnable, so the lock is
+    // needed either way; without it no statistics are kept
+    _glfwLockStatMutex = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+}
+
+
+//========================================================================
+// Free all lock statistics (called by glfwTerminate)
+//========================================================================
+
+void _glfwTerminateLockStats( void )
+{
+    _GLFWlockstat *stat, *next;
+    int i;
+
+    _glfwLockProfiling = GL_FALSE;
+
+    for( i = 0;  i < _GLFW_LOCKSTAT_BUCKETS;  i ++ )
+    {
+        for( stat = _glfwLockStats[ i ];  stat != NULL;  stat = next )
+        {
+            next = stat->next;
+            free( stat );
+        }
+        _glfwLockStats[ i ] = NULL;
+    }
+
+    if( _glfwLockStatMutex != NULL )
+    {
+        _glfwPlatformDestroyMutex( _glfwLockStatMutex );
+        _glfwLockStatMutex = NULL;
+    }
+}
+
+
+//========================================================================
+// Release the statistics of a lock that is being destroyed, so that its
+// entry can be reused by another lock
+//========================================================================
+
+void _glfwForgetLockStats( void *lock )
+{
+    _GLFWlockstat *stat;
+
+    if( _glfwLockStatMutex == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex( _glfwLockStatMutex );
+
+    stat = FindLockStat( (_GLFWlockstat *)
+                         _glfwAtomicLoadPtr( LockStatBucket( lock ) ), lock );
+    if( stat != NULL )
+    {
+        _glfwAtomicStorePtr( &stat->lock, NULL );
+    }
+
+    _glfwPlatformUnlockMutex( _glfwLockStatMutex );
+}
+
+
+//========================================================================
+// Lock a mutex, counting the lock and any wait for it
+//========================================================================
+
+void _glfwProfileLockMutex( GLFWmutex mutex )
+{
+    _GLFWlockstat *stat;
+    double        start;
+
+    stat = GetLockStat( mutex, GLFW_LOCK_MUTEX );
+    if( stat == NULL )
+    {
+        _glfwPlatformLockMutex( mutex );
+        return;
+    }
+
+    if( !_glfwPlatformTryLockMutex( mutex ) )
+    {
+        start = _glfwPlatformGetTime();
+        _glfwPlatformLockMutex( mutex );
+
+        (void) _glfwAtomicAdd( &stat->contended, 1 );
+        CountLockWait( stat, _glfwPlatformGetTime() - start );
+    }
+
+    (void) _glfwAtomicAdd( &stat->acquisitions, 1 );
+}
+
+
+//========================================================================
+// Wait for a condition variable, counting the wait and how long it took
+//========================================================================
+
+void _glfwProfileWaitCond( GLFWcond cond, GLFWmutex mutex, double timeout )
+{
+    _GLFWlockstat *stat;
+    double        start, wait;
+
+    stat = GetLockStat( cond, GLFW_LOCK_COND );
+    if( stat == NULL )
+    {
+        _glfwPlatformWaitCond( cond, mutex, timeout );
+        return;
+    }
+
+    start = _glfwPlatformGetTime();
+    _glfwPlatformWaitCond( cond, mutex, timeout );
+    wait = _glfwPlatformGetTime() - start;
+
+    // For condition variables, contended means the wait timed out
+    (void) _glfwAtomicAdd( &stat->acquisitions, 1 );
+    if( timeout < GLFW_INFINITY && wait >= timeout )
+    {
+        (void) _glfwAtomicAdd( &stat->contended, 1 );
+    }
+    CountLockWait( stat, wait );
+}
+
+
+
+//************************************************************************
+//****                     GLFW user functions                        ****
+//************************************************************************
+
+//========================================================================
+// Give a mutex a name to report its statistics under
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwSetMutexName( GLFWmutex mutex,
+                                            const char *name )
+{
+    _GLFWlockstat *stat;
+
+    // Is GLFW initialized? Names are only kept while profiling
+    if( !_glfwInitialized || !_glfwLockProfiling || !mutex || !name )
+    {
+        return;
+    }
+
+    stat = GetLockStat( mutex, GLFW_LOCK_MUTEX );
+    if( stat != NULL )
+    {
+        strncpy( stat->name, name, sizeof(stat->name) - 1 );
+    }
+}
+
+
+//========================================================================
+// Give a condition variable a name to report its statistics under
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwSetCondName( GLFWcond cond, const char *name )
+{
+    _GLFWlockstat *stat;
+
+    // Is GLFW initialized? Names are only kept while profiling
+    if( !_glfwInitialized || !_glfwLockProfiling || !cond || !name )
+    {
+        return;
+    }
+
+    stat = GetLockStat( cond, GLFW_LOCK_COND );
+    if( stat != NULL )
+    {
+        strncpy( stat->name, name, sizeof(stat->name) - 1 );
+    }
+}
+
+
+//========================================================================
+// Get the statistics of up to maxcount locks, most contended first.
+// Returns the number of locks reported.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwGetLockStats( GLFWlockstats *list,
+                                           int maxcount )
+{
+    _GLFWlockstat *stat;
+    GLFWlockstats *all;
+    int count, i, j;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || list == NULL || maxcount <= 0 )
+    {
+        return 0;
+    }
+
+    // Entries may be added or released while we look; any beyond those
+    // counted here are left out
+    count = 0;
+    for( i = 0;  i < _GLFW_LOCKSTAT_BUCKETS;  i ++ )
+    {
+        stat = (_GLFWlockstat *) _glfwAtomicLoadPtr( &_glfwLockStats[ i ] );
+        for( ;  stat != NULL;  stat = stat->next )
+        {
+            if( _glfwAtomicLoadPtr( &stat->lock ) != NULL )
+            {
+                count ++;
+            }
+        }
+    }
+
+    if( count == 0 )
+    {
+        return 0;
+    }
+
+    all = (GLFWlockstats *) malloc( count * sizeof(GLFWlockstats) );
+    if( all == NULL )
+    {
+        return 0;
+    }
+
+    // Take a snapshot, so that the counts do not change while sorting
+    i = 0;
+    for( j = 0;  j < _GLFW_LOCKSTAT_BUCKETS && i < count;  j ++ )
+    {
+        stat = (_GLFWlockstat *) _glfwAtomicLoadPtr( &_glfwLockStats[ j ] );
+        for( ;  stat != NULL && i < count;  stat = stat->next )
+        {
+            CopyLockStat( &all[ i ], stat );
+            if( all[ i ].Lock != NULL )
+            {
+                i ++;
+            }
+        }
+    }
+    count = i;
+
+    qsort( all, count, sizeof(GLFWlockstats), CompareLockStats );
+
+    if( count > maxcount )
+    {
+        count = maxcount;
+    }
+    memcpy( list, all, count * sizeof(GLFWlockstats) );
+
+    free( all );
+
+    return count;
+}
@@ -0,0 +1,1178 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+
+//========================================================================
+// Description:
+//
+// Asset packs. A pack is a single file holding any number of named
+// entries, which can be read through GLFW streams with names of the form
+// "pack:<entry name>" once the pack has been mounted.
+//
+// All numbers are stored little endian. The file starts with a header:
+//
+//   char[8]  magic ("GLFWPACK")
+//   uint32   version (1)
+//   uint32   number of entries
+//   uint64   offset of directory
+//   uint64   offset of string table
+//
+// The directory holds one 40 byte record per entry, sorted by name hash
+// and then by name:
+//
+//   uint32   FNV-1a hash of name
+//   uint32   offset of name in string table
+//   uint32   length of name
+//   uint32   method (0 = stored, 1 = compressed)
+//   uint64   offset of entry data (aligned to 16 bytes)
+//   uint64   size of entry data in the file
+//   uint64   size of entry
+//
+// Compressed entries are split into independent 64 KB blocks, so that
+// large entries can be decompressed by several threads. The entry data is
+// a block count, followed by the compressed size of each block and then
+// the blocks themselves. Blocks that did not compress are stored as is
+// (their compressed size equals their size). Blocks use a byte oriented
+// LZ77 format in the style of LZ4:
+//
+//   token     high nibble: literal count, low nibble: match length - 4
+//             (15 means that more length bytes follow, each adding up to
+//             255, until a byte less than 255)
+//   literals
+//   offset    uint16, distance back to the match (absent in the last
+//             sequence of a block, which only has literals)
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+#define _GLFW_PACK_MAGIC       "GLFWPACK"
+#define _GLFW_PACK_VERSION     1
+#define _GLFW_PACK_HEADER_SIZE 32
+#define _GLFW_PACK_ENTRY_SIZE  40
+#define _GLFW_PACK_ALIGN       16
+
+#define _GLFW_PACK_STORED      0
+#define _GLFW_PACK_COMPRESSED  1
+
+#define _GLFW_PACK_BLOCK_SIZE  65536
+#define _GLFW_PACK_HASH_BITS   14
+
+
+//========================================================================
+// Mounted pack. The list of mounted packs holds one reference, and every
+// open stream reading from the pack another, so a pack that is unmounted
+// stays mapped until the last such stream is closed.
+//========================================================================
+
+struct _GLFWpack_struct {
+    char          *name;
+    unsigned char *data;
+    _GLFWoffset   size;
+    int           count;
+    const unsigned char *directory;
+    const unsigned char *strings;
+    int           refs;         // Protected by _glfwPackMutex
+    _GLFWpack     *next;
+};
+
+// List of mounted packs, most recently mounted first
+static _GLFWpack *_glfwPacks = NULL;
+
+// Protects the list of mounted packs and their reference counts
+static GLFWmutex _glfwPackMutex = NULL;
+
+
+//========================================================================
+// Pack entry (as used while a pack is created)
+//========================================================================
+
+typedef struct {
+    const char    *name;
+    unsigned int  hash;
+    int           length;
+    int           method;
+    _GLFWoffset   offset;
+    _GLFWoffset   stored;
+    _GLFWoffset   size;
+} _GLFWpackentry;
+
+
+//========================================================================
+// Decompression job for a compressed entry
+//========================================================================
+
+typedef struct {
+    const unsigned char *blocks;
+    const unsigned char *sizes;
+    size_t        *offsets;
+    unsigned char *data;
+    size_t        size;
+} _GLFWinflate;
+
+
+//========================================================================
+// Little endian number decoding and encoding
+//========================================================================
+
+static unsigned int GetUInt32( const unsigned char *p )
+{
+    return (unsigned int) p[0] | ((unsigned int) p[1] << 8) |
+           ((unsigned int) p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+
+static _GLFWoffset GetUInt64( const unsigned char *p )
+{
+    return (_GLFWoffset) GetUInt32( p ) |
+           ((_GLFWoffset) GetUInt32( p + 4 ) << 32);
+}
+
+static void PutUInt32( unsigned char *p, unsigned int x )
+{
+    p[0] = (unsigned char) x;
+    p[1] = (unsigned char) (x >> 8);
+    p[2] = (unsigned char) (x >> 16);
+    p[3] = (unsigned char) (x >> 24);
+}
+
+static void PutUInt64( unsigned char *p, _GLFWoffset x )
+{
+    PutUInt32( p, (unsigned int) x );
+    PutUInt32( p + 4, (unsigned int) (x >> 32) );
+}
+
+
+//========================================================================
+// Hash an entry name (32-bit FNV-1a)
+//========================================================================
+
+static unsigned int HashName( const char *name, int length )
+{
+    unsigned int hash = 2166136261U;
+    int i;
+
+    for( i = 0; i < length; i ++ )
+    {
+        hash ^= (unsigned char) name[ i ];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+
+//========================================================================
+// Write a sequence length extension (for lengths of 15 and above)
+//========================================================================
+
+static unsigned char * PutLength( unsigned char *op, int length )
+{
+    for( length -= 15; length >= 255; length -= 255 )
+    {
+        *op ++ = 255;
+    }
+    *op ++ = (unsigned char) length;
+
+    return op;
+}
+
+
+//========================================================================
+// Compress a block. Returns the compressed size, or zero if the block
+// does not fit in maxsize bytes.
+//========================================================================
+
+static int CompressBlock( const unsigned char *src, int size,
+                          unsigned char *dst, int maxsize )
+{
+    int table[ 1 << _GLFW_PACK_HASH_BITS ];
+    unsigned char *op, *oend, *token;
+    int ip, anchor, ref, h, length, literals;
+
+    for( h = 0; h < (1 << _GLFW_PACK_HASH_BITS); h ++ )
+    {
+        table[ h ] = -1;
+    }
+
+    op     = dst;
+    oend   = dst + maxsize;
+    ip     = 0;
+    anchor = 0;
+
+    while( ip + 4 <= size )
+    {
+        // Look up the previous occurence of the next four bytes
+        h = (int) ((GetUInt32( src + ip ) * 2654435761U) >>
+                   (32 - _GLFW_PACK_HASH_BITS));
+        ref = table[ h ];
+        table[ h ] = ip;
+
+        if( ref < 0 || ip - ref > 65535 ||
+            memcmp( src + ref, src + ip, 4 ) != 0 )
+        {
+            ip ++;
+            continue;
+        }
+
+        length = 4;
+        while( ip + length < size && src[ ref + length ] == src[ ip + length ] )
+        {
+            length ++;
+        }
+
+        // Worst case size of this sequence
+        literals = ip - anchor;
+        if( (oend - op) < 1 + literals + literals / 255 + 1 + 2 +
+                          length / 255 + 1 )
+        {
+            return 0;
+        }
+
+        token = op ++;
+        *token = (unsigned char) ((literals < 15 ? literals : 15) << 4);
+        if( literals >= 15 )
+        {
+            op = PutLength( op, literals );
+        }
+        memcpy( op, src + anchor, literals );
+        op += literals;
+
+        *op ++ = (unsigned char) (ip - ref);
+        *op ++ = (unsigned char) ((ip - ref) >> 8);
+
+        *token |= (unsigned char) (length - 4 < 15 ? length - 4 : 15);
+        if( length - 4 >= 15 )
+        {
+            op = PutLength( op, length - 4 );
+        }
+
+        ip    += length;
+        anchor = ip;
+    }
+
+    // The block ends with a sequence holding the remaining literals
+    literals = size - anchor;
+    if( (oend - op) < 1 + literals + literals / 255 + 1 )
+    {
+        return 0;
+    }
+
+    token = op ++;
+    *token = (unsigned char) ((literals < 15 ? literals : 15) << 4);
+    if( literals >= 15 )
+    {
+        op = PutLength( op, literals );
+    }
+    memcpy( op, src + anchor, literals );
+    op += literals;
+
+    return (int) (op - dst);
+}
+
+
+//========================================================================
+// Read a sequence length extension
+//========================================================================
+
+static const unsigned char * GetLength( const unsigned char *ip,
+                                        const unsigned char *iend,
+                                        int *length )
+{
+    int c;
+
+    do
+    {
+        if( ip >= iend )
+        {
+            return NULL;
+        }
+        c = *ip ++;
+        *length += c;
+    }
+    while( c == 255 );
+
+    return ip;
+}
+
+
+//========================================================================
+// Decompress a block, which must decompress to exactly size bytes
+//========================================================================
+
+static int DecompressBlock( const unsigned char *src, int srcsize,
+                            unsigned char *dst, int size )
+{
+    const unsigned char *ip, *iend, *match;
+    unsigned char *op, *oend;
+    int token, length, offset;
+
+    ip   = src;
+    iend = src + srcsize;
+    op   = dst;
+    oend = dst + size;
+
+    while( ip < iend )
+    {
+        token = *ip ++;
+
+        // Literals
+        length = token >> 4;
+        if( length == 15 )
+        {
+            ip = GetLength( ip, iend, &length );
+            if( ip == NULL )
+            {
+                return GL_FALSE;
+            }
+        }
+        if( length > iend - ip || length > oend - op )
+        {
+            return GL_FALSE;
+        }
+        memcpy( op, ip, length );
+        ip += length;
+        op += length;
+
+        // The last sequence has no match
+        if( ip == iend )
+        {
+            break;
+        }
+
+        // Match
+        if( iend - ip < 2 )
+        {
+            return GL_FALSE;
+        }
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        length = token & 15;
+        if( length == 15 )
+        {
+            ip = GetLength( ip, iend, &length );
+            if( ip == NULL )
+            {
+                return GL_FALSE;
+            }
+        }
+        length += 4;
+
+        if( offset == 0 || offset > op - dst || length > oend - op )
+        {
+            return GL_FALSE;
+        }
+
+        match = op - offset;
+        if( offset >= length )
+        {
+            memcpy( op, match, length );
+            op += length;
+        }
+        else
+        {
+            // Overlapping match (repeats the last offset bytes)
+            while( length -- )
+            {
+                *op ++ = *match ++;
+            }
+        }
+    }
+
+    return op == oend;
+}
+
+
+//========================================================================
+// Decompression worker; decompresses blocks until the entry is done
+//========================================================================
+
+static void InflateWorker( _GLFWworkset *work )
+{
+    _GLFWinflate *job = (_GLFWinflate *) work->arg;
+    size_t size;
+    int i, srcsize;
+
+    while( (i = _glfwClaimWorkItem( work )) >= 0 )
+    {
+        size = job->size - (size_t) i * _GLFW_PACK_BLOCK_SIZE;
+        if( size > _GLFW_PACK_BLOCK_SIZE )
+        {
+            size = _GLFW_PACK_BLOCK_SIZE;
+        }
+
+        srcsize = (int) GetUInt32( job->sizes + i * 4 );
+        if( srcsize == (int) size )
+        {
+            memcpy( job->data + (size_t) i * _GLFW_PACK_BLOCK_SIZE,
+                    job->blocks + job->offsets[ i ], size );
+        }
+        else if( !DecompressBlock( job->blocks + job->offsets[ i ], srcsize,
+                                   job->data + (size_t) i * _GLFW_PACK_BLOCK_SIZE,
+                                   (int) size ) )
+        {
+            _glfwFailWorkItem( work );
+        }
+    }
+}
+
+
+//========================================================================
+// Decompress an entry into memory, using one thread per processor for
+// entries with more than one block
+//========================================================================
+
+static unsigned char * InflateEntry( const unsigned char *src,
+                                     _GLFWoffset stored, _GLFWoffset size )
+{
+    _GLFWinflate job;
+    _GLFWworkset work;
+    _GLFWoffset  total;
+    int          i;
+
+    if( stored < 4 || (_GLFWoffset) (size_t) size != size )
+    {
+        return NULL;
+    }
+
+    work.count = (int) GetUInt32( src );
+    if( (_GLFWoffset) work.count !=
+        (size + _GLFW_PACK_BLOCK_SIZE - 1) / _GLFW_PACK_BLOCK_SIZE ||
+        4 + (_GLFWoffset) work.count * 4 > stored )
+    {
+        return NULL;
+    }
+
+    job.sizes   = src + 4;
+    job.blocks  = job.sizes + work.count * 4;
+    job.size    = (size_t) size;
+
+    // Locate the blocks, and check that they are all within the entry
+    job.offsets = (size_t *) malloc( (work.count + 1) * sizeof(size_t) );
+    if( job.offsets == NULL )
+    {
+        return NULL;
+    }
+    total = 0;
+    for( i = 0; i < work.count; i ++ )
+    {
+        job.offsets[ i ] = (size_t) total;
+        total += GetUInt32( job.sizes + i * 4 );
+    }
+    if( 4 + (_GLFWoffset) work.count * 4 + total > stored )
+    {
+        free( job.offsets );
+        return NULL;
+    }
+
+    job.data = (unsigned char *) malloc( job.size ? job.size : 1 );
+    if( job.data == NULL )
+    {
+        free( job.offsets );
+        return NULL;
+    }
+
+    work.worker = InflateWorker;
+    work.arg    = &job;
+    if( !_glfwRunWorkset( &work, _glfwGetUsableProcessors() ) )
+    {
+        free( job.offsets );
+        free( job.data );
+        return NULL;
+    }
+
+    free( job.offsets );
+    return job.data;
+}
+
+
+//========================================================================
+// Find an entry in a pack, returning its directory record
+//========================================================================
+
+static const unsigned char * FindEntry( const _GLFWpack *pack,
+                                        const char *name, int length,
+                                        unsigned int hash )
+{
+    const unsigned char *entry;
+    unsigned int h;
+    int low, high, mid;
+
+    // Find the first entry with a matching hash
+    low  = 0;
+    high = pack->count;
+    while( low < high )
+    {
+        mid = low + (high - low) / 2;
+        if( GetUInt32( pack->directory + mid * _GLFW_PACK_ENTRY_SIZE ) < hash )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    // Compare names of all entries with that hash
+    for( ; low < pack->count; low ++ )
+    {
+        entry = pack->directory + low * _GLFW_PACK_ENTRY_SIZE;
+        h = GetUInt32( entry );
+        if( h != hash )
+        {
+            break;
+        }
+
+        if( (int) GetUInt32( entry + 8 ) == length &&
+            memcmp( pack->strings + GetUInt32( entry + 4 ), name,
+                    length ) == 0 )
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+//========================================================================
+// Check that a mapped file is a valid pack, and set up its directory
+//========================================================================
+
+static int ValidatePack( _GLFWpack *pack )
+{
+    const unsigned char *entry;
+    _GLFWoffset diroffset, stroffset, offset, stored;
+    int i;
+
+    if( pack->size < _GLFW_PACK_HEADER_SIZE ||
+        memcmp( pack->data, _GLFW_PACK_MAGIC, 8 ) != 0 ||
+        GetUInt32( pack->data + 8 ) != _GLFW_PACK_VERSION )
+    {
+        return GL_FALSE;
+    }
+
+    pack->count = (int) GetUInt32( pack->data + 12 );
+    diroffset = GetUInt64( pack->data + 16 );
+    stroffset = GetUInt64( pack->data + 24 );
+
+    if( pack->count < 0 || diroffset < 0 || stroffset < 0 ||
+        diroffset + (_GLFWoffset) pack->count * _GLFW_PACK_ENTRY_SIZE >
+        pack->size || stroffset > pack->size )
+    {
+        return GL_FALSE;
+    }
+
+    pack->directory = pack->data + diroffset;
+    pack->strings   = pack->data + stroffset;
+
+    // Check that all names and entry data are within the file
+    for( i = 0; i < pack->count; i ++ )
+    {
+        entry  = pack->directory + i * _GLFW_PACK_ENTRY_SIZE;
+        offset = GetUInt64( entry + 16 );
+        stored = GetUInt64( entry + 24 );
+
+        if( stroffset + GetUInt32( entry + 4 ) + GetUInt32( entry + 8 ) >
+            pack->size || offset < 0 || stored < 0 ||
+            offset + stored > pack->size )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Unmap and free a pack that nothing refers to any more
+//========================================================================
+
+static void FreePack( _GLFWpack *pack )
+{
+    _glfwPlatformUnmapFile( pack->data, pack->size );
+    free( pack->name );
+    free( pack );
+}
+
+
+//========================================================================
+// Write data to a pack file being created, keeping track of the position
+//========================================================================
+
+static int WritePackData( FILE *file, const void *data, size_t size,
+                          _GLFWoffset *position )
+{
+    if( size && fwrite( data, 1, size, file ) != size )
+    {
+        return GL_FALSE;
+    }
+
+    *position += size;
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Pad a pack file being created to the entry alignment
+//========================================================================
+
+static int AlignPackData( FILE *file, _GLFWoffset *position )
+{
+    static const unsigned char zeros[ _GLFW_PACK_ALIGN ] = { 0 };
+    int pad;
+
+    pad = (int) ((_GLFW_PACK_ALIGN - *position % _GLFW_PACK_ALIGN) %
+                 _GLFW_PACK_ALIGN);
+
+    return WritePackData( file, zeros, pad, position );
+}
+
+
+//========================================================================
+// Compress entry data. Returns a buffer holding the block count, block
+// sizes and blocks, or NULL if the data does not compress.
+//========================================================================
+
+static unsigned char * CompressEntry( const unsigned char *data, size_t size,
+                                      size_t *stored )
+{
+    unsigned char *out, *op;
+    size_t block;
+    int i, count, csize;
+
+    count = (int) ((size + _GLFW_PACK_BLOCK_SIZE - 1) / _GLFW_PACK_BLOCK_SIZE);
+    if( count == 0 || size >= 0x7fffffff )
+    {
+        return NULL;
+    }
+
+    // Blocks that do not compress are stored, so the output is never
+    // larger than the header plus the data
+    out = (unsigned char *) malloc( 4 + count * 4 + size );
+    if( out == NULL )
+    {
+        return NULL;
+    }
+
+    PutUInt32( out, count );
+    op = out + 4 + count * 4;
+
+    for( i = 0; i < count; i ++ )
+    {
+        block = size - (size_t) i * _GLFW_PACK_BLOCK_SIZE;
+        if( block > _GLFW_PACK_BLOCK_SIZE )
+        {
+            block = _GLFW_PACK_BLOCK_SIZE;
+        }
+
+        csize = CompressBlock( data + (size_t) i * _GLFW_PACK_BLOCK_SIZE,
+                               (int) block, op, (int) block - 1 );
+        if( csize == 0 )
+        {
+            memcpy( op, data + (size_t) i * _GLFW_PACK_BLOCK_SIZE, block );
+            csize = (int) block;
+        }
+
+        PutUInt32( out + 4 + i * 4, csize );
+        op += csize;
+    }
+
+    *stored = op - out;
+    if( *stored >= size )
+    {
+        free( out );
+        return NULL;
+    }
+
+    return out;
+}
+
+
+//========================================================================
+// Read a file and write it to a pack file being created
+//========================================================================
+
+static int WritePackEntry( FILE *file, _GLFWpackentry *entry, int flags,
+                           _GLFWoffset *position )
+{
+    _GLFWstream stream;
+    unsigned char *data, *packed;
+    size_t stored;
+    int result;
+
+    if( !_glfwOpenFileStream( &stream, entry->name, "rb" ) )
+    {
+        return GL_FALSE;
+    }
+
+    _glfwSeekStream( &stream, 0, SEEK_END );
+    entry->size = _glfwTellStream( &stream );
+    _glfwSeekStream( &stream, 0, SEEK_SET );
+
+    if( entry->size < 0 || (_GLFWoffset) (size_t) entry->size != entry->size )
+    {
+        _glfwCloseStream( &stream );
+        return GL_FALSE;
+    }
+
+    data = (unsigned char *) malloc( entry->size ? (size_t) entry->size : 1 );
+    if( data == NULL )
+    {
+        _glfwCloseStream( &stream );
+        return GL_FALSE;
+    }
+
+    result = _glfwReadStream( &stream, data, (size_t) entry->size ) ==
+             (size_t) entry->size;
+    _glfwCloseStream( &stream );
+
+    packed = NULL;
+    if( result && (flags & GLFW_COMPRESS_BIT) )
+    {
+        packed = CompressEntry( data, (size_t) entry->size, &stored );
+    }
+
+    if( result )
+    {
+        result = AlignPackData( file, position );
+    }
+
+    entry->offset = *position;
+    if( packed )
+    {
+        entry->method = _GLFW_PACK_COMPRESSED;
+        entry->stored = stored;
+        result = result && WritePackData( file, packed, stored, position );
+        free( packed );
+    }
+    else
+    {
+        entry->method = _GLFW_PACK_STORED;
+        entry->stored = entry->size;
+        result = result && WritePackData( file, data, (size_t) entry->size,
+                                          position );
+    }
+
+    free( data );
+    return result;
+}
+
+
+//========================================================================
+// Entry order in the directory (by hash, then by name)
+//========================================================================
+
+static int CompareEntries( const void *a, const void *b )
+{
+    const _GLFWpackentry *e1 = (const _GLFWpackentry *) a;
+    const _GLFWpackentry *e2 = (const _GLFWpackentry *) b;
+
+    if( e1->hash != e2->hash )
+    {
+        return e1->hash < e2->hash ? -1 : 1;
+    }
+
+    return strcmp( e1->name, e2->name );
+}
+
+
+//========================================================================
+// Write the directory and string table of a pack file being created, and
+// then fill in its header
+//========================================================================
+
+static int WritePackDirectory( FILE *file, _GLFWpackentry *entries,
+                               int count, _GLFWoffset *position )
+{
+    unsigned char record[ _GLFW_PACK_ENTRY_SIZE ];
+    unsigned char header[ _GLFW_PACK_HEADER_SIZE ];
+    _GLFWoffset diroffset, stroffset;
+    unsigned int nameoffset;
+    int i;
+
+    if( !AlignPackData( file, position ) )
+    {
+        return GL_FALSE;
+    }
+
+    diroffset  = *position;
+    nameoffset = 0;
+    for( i = 0; i < count; i ++ )
+    {
+        PutUInt32( record, entries[ i ].hash );
+        PutUInt32( record + 4, nameoffset );
+        PutUInt32( record + 8, entries[ i ].length );
+        PutUInt32( record + 12, entries[ i ].method );
+        PutUInt64( record + 16, entries[ i ].offset );
+        PutUInt64( record + 24, entries[ i ].stored );
+        PutUInt64( record + 32, entries[ i ].size );
+        if( !WritePackData( file, record, sizeof(record), position ) )
+        {
+            return GL_FALSE;
+        }
+        nameoffset += entries[ i ].length;
+    }
+
+    stroffset = *position;
+    for( i = 0; i < count; i ++ )
+    {
+        if( !WritePackData( file, entries[ i ].name, entries[ i ].length,
+                            position ) )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    memcpy( header, _GLFW_PACK_MAGIC, 8 );
+    PutUInt32( header + 8, _GLFW_PACK_VERSION );
+    PutUInt32( header + 12, count );
+    PutUInt64( header + 16, diroffset );
+    PutUInt64( header + 24, stroffset );
+
+    return fseek( file, 0, SEEK_SET ) == 0 &&
+           fwrite( header, 1, sizeof(header), file ) == sizeof(header);
+}
+
+
+//========================================================================
+// Opens a GLFW stream with an entry of a mounted pack
+//========================================================================
+
+int _glfwOpenPackStream( _GLFWstream *stream, const char *name )
+{
+    _GLFWpack *pack;
+    const unsigned char *entry, *data;
+    unsigned char *inflated;
+    _GLFWoffset stored, size;
+    unsigned int hash, method;
+    int length;
+
+    if( _glfwPackMutex == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    length = (int) strlen( name );
+    hash   = HashName( name, length );
+
+    _glfwPlatformLockMutex( _glfwPackMutex );
+
+    // Later mounts take precedence
+    entry = NULL;
+    for( pack = _glfwPacks; pack != NULL; pack = pack->next )
+    {
+        entry = FindEntry( pack, name, length, hash );
+        if( entry != NULL )
+        {
+            break;
+        }
+    }
+    if( entry == NULL )
+    {
+        _glfwPlatformUnlockMutex( _glfwPackMutex );
+        return GL_FALSE;
+    }
+
+    // Keep the pack mapped while we (or the stream) read from it, even if
+    // it is unmounted meanwhile
+    pack->refs ++;
+
+    _glfwPlatformUnlockMutex( _glfwPackMutex );
+
+    data   = pack->data + GetUInt64( entry + 16 );
+    stored = GetUInt64( entry + 24 );
+    size   = GetUInt64( entry + 32 );
+    method = GetUInt32( entry + 12 );
+
+    // Stored entries are read straight from the mapped pack, which the
+    // stream then keeps mapped until it is closed
+    if( method == _GLFW_PACK_STORED && stored == size )
+    {
+        _glfwOpenBufferStream( stream, (void *) data, size );
+        stream->pack = pack;
+        return GL_TRUE;
+    }
+
+    inflated = NULL;
+    if( method == _GLFW_PACK_COMPRESSED )
+    {
+        inflated = InflateEntry( data, stored, size );
+    }
+
+    _glfwReleasePack( pack );
+
+    if( inflated == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    _glfwOpenBufferStream( stream, inflated, size );
+    stream->freeData = GL_TRUE;
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Drop a reference to a pack, freeing it if it was the last one
+//========================================================================
+
+void _glfwReleasePack( _GLFWpack *pack )
+{
+    int refs;
+
+    _glfwPlatformLockMutex( _glfwPackMutex );
+    refs = -- pack->refs;
+    _glfwPlatformUnlockMutex( _glfwPackMutex );
+
+    if( refs == 0 )
+    {
+        FreePack( pack );
+    }
+}
+
+
+//========================================================================
+// Create the lock for the list of mounted packs (called by glfwInit)
+//========================================================================
+
+void _glfwInitPacks( void )
+{
+    // Without the lock, glfwMountPack fails
+    _glfwPackMutex = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+}
+
+
+//========================================================================
+// Unmount all packs (called by glfwTerminate). Packs that are still read
+// by open streams are left mapped, as the streams may yet be closed.
+//========================================================================
+
+void _glfwTerminatePacks( void )
+{
+    _GLFWpack *pack;
+
+    if( _glfwPackMutex == NULL )
+    {
+        return;
+    }
+
+    while( _glfwPacks != NULL )
+    {
+        pack = _glfwPacks;
+        _glfwPacks = pack->next;
+
+        if( -- pack->refs == 0 )
+        {
+            FreePack( pack );
+        }
+    }
+
+    _glfwPlatformDestroyMutex( _glfwPackMutex );
+    _glfwPackMutex = NULL;
+}
+
+
+//************************************************************************
+//****                    GLFW user functions                         ****
+//************************************************************************
+
+//========================================================================
+// Mount a pack, making its entries available as "pack:<entry name>"
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwMountPack( const char *name )
+{
+    _GLFWpack *pack;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || _glfwPackMutex == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    pack = (_GLFWpack *) malloc( sizeof(_GLFWpack) );
+    if( pack == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    pack->name = (char *) malloc( strlen( name ) + 1 );
+    if( pack->name == NULL )
+    {
+        free( pack );
+        return GL_FALSE;
+    }
+    strcpy( pack->name, name );
+
+    pack->data = (unsigned char *) _glfwPlatformMapFile( name, &pack->size );
+    if( pack->data == NULL )
+    {
+        free( pack->name );
+        free( pack );
+        return GL_FALSE;
+    }
+
+    if( !ValidatePack( pack ) )
+    {
+        _glfwPlatformUnmapFile( pack->data, pack->size );
+        free( pack->name );
+        free( pack );
+        return GL_FALSE;
+    }
+
+    pack->refs = 1;
+
+    _glfwPlatformLockMutex( _glfwPackMutex );
+    pack->next = _glfwPacks;
+    _glfwPacks = pack;
+    _glfwPlatformUnlockMutex( _glfwPackMutex );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Unmount a pack
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwUnmountPack( const char *name )
+{
+    _GLFWpack **prev, *pack;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || _glfwPackMutex == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex( _glfwPackMutex );
+
+    for( prev = &_glfwPacks; *prev != NULL; prev = &(*prev)->next )
+    {
+        pack = *prev;
+        if( strcmp( pack->name, name ) == 0 )
+        {
+            *prev = pack->next;
+            _glfwPlatformUnlockMutex( _glfwPackMutex );
+
+            // The pack is unmapped once no stream reads from it
+            _glfwReleasePack( pack );
+            return;
+        }
+    }
+
+    _glfwPlatformUnlockMutex( _glfwPackMutex );
+}
+
+
+//========================================================================
+// Create a pack from a set of files, using the file names as entry names
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwCreatePack( const char *name,
+    const char **files, int count, int flags )
+{
+    unsigned char header[ _GLFW_PACK_HEADER_SIZE ];
+    _GLFWpackentry *entries;
+    _GLFWoffset position;
+    FILE *file;
+    int i, result;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || count < 0 )
+    {
+        return GL_FALSE;
+    }
+
+    entries = (_GLFWpackentry *) malloc( (count ? count : 1) *
+                                         sizeof(_GLFWpackentry) );
+    if( entries == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    for( i = 0; i < count; i ++ )
+    {
+        entries[ i ].name   = files[ i ];
+        entries[ i ].length = (int) strlen( files[ i ] );
+        entries[ i ].hash   = HashName( files[ i ], entries[ i ].length );
+    }
+
+    // Sort the entries into directory order, and refuse duplicate names
+    qsort( entries, count, sizeof(_GLFWpackentry), CompareEntries );
+    for( i = 1; i < count; i ++ )
+    {
+        if( CompareEntries( &entries[ i - 1 ], &entries[ i ] ) == 0 )
+        {
+            free( entries );
+            return GL_FALSE;
+        }
+    }
+
+    file = fopen( name, "wb" );
+    if( file == NULL )
+    {
+        free( entries );
+        return GL_FALSE;
+    }
+
+    // Leave room for the header, which is written last
+    memset( header, 0, sizeof(header) );
+    position = 0;
+    result = WritePackData( file, header, sizeof(header), &position );
+
+    for( i = 0; i < count && result; i ++ )
+    {
+        result = WritePackEntry( file, &entries[ i ], flags, &position );
+    }
+
+    result = result && WritePackDirectory( file, entries, count, &position );
+
+    if( fclose( file ) != 0 )
+    {
+        result = GL_FALSE;
+    }
+
+    if( !result )
+    {
+        remove( name );
+    }
+
+    free( entries );
+    return result;
+}
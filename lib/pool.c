@@ -0,0 +1,1917 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+
+
+//========================================================================
+// Description:
+//
+// Work-stealing thread pools. Every worker thread owns a Chase-Lev deque
+// of jobs: the owner pushes and pops jobs at the bottom without locking,
+// while idle workers steal from the top of other workers' deques. Jobs
+// submitted from threads outside the pool go through a small shared
+// queue. Idle workers spin briefly and then sleep on an address wait
+// (a futex where available), and are only woken when there are sleepers.
+//
+// Parallel loops are split recursively: the thread running a range
+// pushes its upper half as a new job and keeps the lower half, until the
+// range is no larger than the grain size. Threads waiting for a loop or
+// for submitted jobs run other jobs in the meantime.
+//
+// Task graphs are sets of tasks with dependencies between them. Every
+// task counts its unfinished dependencies; the thread that finishes a
+// task runs the first successor that becomes ready itself and pushes the
+// others onto its own deque. Tasks are never allocated at launch, so the
+// same graph can be launched again every frame.
+//
+// Where the platform supports fibers, workers run their loop on fibers.
+// A job that waits for a counter parks its fiber on the counter and the
+// worker continues with another fiber, so waiting jobs do not hold up
+// worker threads. When the counter drops to zero, the parked fibers are
+// put on the pool's ready queue, and are resumed by whichever worker
+// gets to them first (ready fibers come before new jobs).
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Assumed cache line size, used to keep deque ends apart
+#define _GLFW_CACHE_LINE        64
+
+// Upper limit on the number of worker threads in a pool
+#define _GLFW_POOL_MAX_THREADS  256
+
+// Initial number of slots in a worker deque (must be a power of two)
+#define _GLFW_DEQUE_SIZE        256
+
+// Number of times an idle worker looks for work before going to sleep
+#define _GLFW_POOL_SPIN         64
+
+// Stack size of worker fibers, which all jobs run on where fibers are
+// supported (documented for glfwCreateThreadPool, so keep them in sync)
+#define _GLFW_FIBER_STACK_SIZE  (256 * 1024)
+
+
+typedef struct _GLFWjob_struct       _GLFWjob;
+typedef struct _GLFWloop_struct      _GLFWloop;
+typedef struct _GLFWtask_struct      _GLFWtask;
+typedef struct _GLFWtaskgraph_struct _GLFWtaskgraph;
+typedef struct _GLFWjobarray_struct  _GLFWjobarray;
+typedef struct _GLFWworker_struct    _GLFWworker;
+typedef struct _GLFWpool_struct      _GLFWpool;
+typedef struct _GLFWfiber_struct     _GLFWfiber;
+typedef struct _GLFWcounter_struct   _GLFWcounter;
+
+
+//========================================================================
+// Parallel loop, shared by all the jobs that run parts of it
+//========================================================================
+
+struct _GLFWloop_struct {
+    GLFWforfun    fun;
+    void          *arg;
+    int           grain;
+    volatile int  remaining;    // Iterations not yet run
+};
+
+//========================================================================
+// Job (a submitted function, a range of a parallel loop or a task)
+//========================================================================
+
+struct _GLFWjob_struct {
+    GLFWjobfun    fun;
+    void          *arg;
+    _GLFWloop     *loop;
+    int           begin, end;
+    _GLFWtask     *task;
+    _GLFWjob      *next;        // Next job in the submission queue
+};
+
+//========================================================================
+// Task of a task graph. The job of a task is part of the task, and is
+// not freed when run.
+//========================================================================
+
+struct _GLFWtask_struct {
+    GLFWjobfun     fun;
+    void           *arg;
+    _GLFWtaskgraph *graph;
+    _GLFWjob       job;
+    int            dependencies;
+    volatile int   waiting;     // Dependencies not finished in this launch
+    int            *successors;
+    int            successorCount, successorSize;
+};
+
+//========================================================================
+// Task graph
+//========================================================================
+
+struct _GLFWtaskgraph_struct {
+    _GLFWtask     *tasks;
+    int           count, size;
+    int           checked;      // Known to be free of cycles
+    _GLFWpool     *pool;
+    volatile int  remaining;    // Tasks not finished in this launch
+};
+
+//========================================================================
+// Circular job array of a deque. Arrays replaced by bigger ones are kept
+// until the pool is destroyed, as thieves may still be reading them.
+//========================================================================
+
+struct _GLFWjobarray_struct {
+    unsigned int        mask;
+    _GLFWjobarray       *retired;
+    _GLFWjob * volatile slots[ 1 ];
+};
+
+//========================================================================
+// Fiber that runs the worker loop (and the jobs it picks up)
+//========================================================================
+
+struct _GLFWfiber_struct {
+    void          *handle;
+    _GLFWpool     *pool;
+    _GLFWfiber    *next;        // Next fiber in a free, ready or wait list
+    _GLFWfiber    *link;        // Next of all the fibers of the pool
+};
+
+//========================================================================
+// Counter that jobs can wait for
+//========================================================================
+
+struct _GLFWcounter_struct {
+    volatile int  value;
+    GLFWmutex     mutex;
+    _GLFWfiber    *waiters;     // Fibers parked until the value is zero
+};
+
+//========================================================================
+// Worker thread and its deque
+//========================================================================
+
+struct _GLFWworker_struct {
+    // Thieves take jobs from the top...
+    volatile unsigned int    top;
+    char                     pad1[ _GLFW_CACHE_LINE - sizeof(unsigned int) ];
+
+    // ...while the owner pushes and pops jobs at the bottom
+    volatile unsigned int    bottom;
+    _GLFWjobarray * volatile array;
+    char                     pad2[ _GLFW_CACHE_LINE - sizeof(unsigned int) -
+                                   sizeof(void *) ];
+
+    _GLFWpool     *pool;
+    GLFWthread    thread;
+    unsigned int  seed;
+
+    // Fiber state, only touched by the worker thread itself
+    void          *native;      // The worker thread's own context
+    _GLFWfiber    *current;     // Fiber running on this thread
+    _GLFWfiber    *release;     // Fiber to free once switched away from
+    _GLFWfiber    *park;        // Fiber to park once switched away from...
+    _GLFWcounter  *parkCounter; // ...on this counter (or as ready if NULL)
+};
+
+//========================================================================
+// Thread pool
+//========================================================================
+
+struct _GLFWpool_struct {
+    int           count;
+    _GLFWworker   *workers;
+
+    // Jobs submitted from threads outside the pool
+    GLFWmutex     mutex;
+    _GLFWjob      *first, *last;
+    volatile int  queued;
+
+    volatile int  pending;      // Submitted jobs not yet finished
+    volatile int  signal;       // Bumped to wake up sleeping workers
+    volatile int  sleeping;     // Number of sleeping workers
+    volatile int  quit;
+
+    // Fibers, protected by the mutex
+    int           fibers;       // Workers run on fibers
+    _GLFWfiber    *freeFibers;
+    _GLFWfiber    *readyFirst, *readyLast;
+    volatile int  readyCount;
+    _GLFWfiber    *allFibers;
+
+    _GLFWpool     *next;
+};
+
+// All pools, so that glfwTerminate can stop them
+static _GLFWpool *_glfwPools = NULL;
+
+// Pool used for task graphs launched without a pool
+static _GLFWpool * volatile _glfwDefaultPool = NULL;
+
+
+//========================================================================
+// Allocate a job array with the given number of slots
+//========================================================================
+
+static _GLFWjobarray *NewJobArray( unsigned int size )
+{
+    _GLFWjobarray *a;
+
+    a = (_GLFWjobarray *) malloc( sizeof(_GLFWjobarray) +
+                                  (size - 1) * sizeof(_GLFWjob *) );
+    if( a == NULL )
+    {
+        return NULL;
+    }
+
+    a->mask    = size - 1;
+    a->retired = NULL;
+    return a;
+}
+
+
+//========================================================================
+// Free a job array and all the arrays it replaced
+//========================================================================
+
+static void FreeJobArray( _GLFWjobarray *a )
+{
+    _GLFWjobarray *retired;
+
+    while( a != NULL )
+    {
+        retired = a->retired;
+        free( a );
+        a = retired;
+    }
+}
+
+
+//========================================================================
+// Push a job onto the bottom of a worker's own deque
+//========================================================================
+
+static int PushJob( _GLFWworker *w, _GLFWjob *job )
+{
+    unsigned int  b, t, i;
+    _GLFWjobarray *a, *bigger;
+
+    b = _glfwAtomicLoadRelaxed( &w->bottom );
+    t = _glfwAtomicLoad( &w->top );
+    a = w->array;
+
+    // Is the deque full? If so, move the jobs into a bigger array
+    if( (int) (b - t) > (int) a->mask )
+    {
+        bigger = NewJobArray( (a->mask + 1) * 2 );
+        if( bigger == NULL )
+        {
+            return GL_FALSE;
+        }
+        for( i = t;  i != b;  i ++ )
+        {
+            bigger->slots[ i & bigger->mask ] = a->slots[ i & a->mask ];
+        }
+        bigger->retired = a;
+        _glfwAtomicStorePtr( &w->array, bigger );
+        a = bigger;
+    }
+
+    a->slots[ b & a->mask ] = job;
+
+    // Publish the job (the release store orders the slot write)
+    _glfwAtomicStore( &w->bottom, b + 1 );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Pop a job from the bottom of a worker's own deque
+//========================================================================
+
+static _GLFWjob *PopJob( _GLFWworker *w )
+{
+    unsigned int  b, t;
+    _GLFWjobarray *a;
+    _GLFWjob      *job;
+
+    b = _glfwAtomicLoadRelaxed( &w->bottom ) - 1;
+    a = w->array;
+
+    // Reserve the bottom job before looking at the top (this must be a
+    // full barrier, as thieves do the reverse)
+    (void) _glfwAtomicExchange( &w->bottom, b );
+    t = _glfwAtomicLoad( &w->top );
+
+    if( (int) (b - t) < 0 )
+    {
+        // The deque was empty
+        _glfwAtomicStoreRelaxed( &w->bottom, b + 1 );
+        return NULL;
+    }
+
+    job = a->slots[ b & a->mask ];
+    if( b != t )
+    {
+        return job;
+    }
+
+    // This was the last job, so we race the thieves for it
+    if( !_glfwAtomicCompareExchange( &w->top, t, t + 1 ) )
+    {
+        job = NULL;
+    }
+    _glfwAtomicStoreRelaxed( &w->bottom, b + 1 );
+    return job;
+}
+
+
+//========================================================================
+// Steal a job from the top of another worker's deque
+//========================================================================
+
+static _GLFWjob *StealJob( _GLFWworker *w )
+{
+    unsigned int  b, t;
+    _GLFWjobarray *a;
+    _GLFWjob      *job;
+
+    t = _glfwAtomicLoad( &w->top );
+    _glfwAtomicFence();
+    b = _glfwAtomicLoad( &w->bottom );
+
+    if( (int) (b - t) <= 0 )
+    {
+        return NULL;
+    }
+
+    a = (_GLFWjobarray *) _glfwAtomicLoadPtr( &w->array );
+    job = a->slots[ t & a->mask ];
+
+    // Did the owner or another thief get there first?
+    if( !_glfwAtomicCompareExchange( &w->top, t, t + 1 ) )
+    {
+        return NULL;
+    }
+
+    return job;
+}
+
+
+//========================================================================
+// Append a job to the pool's submission queue
+//========================================================================
+
+static void EnqueueJob( _GLFWpool *pool, _GLFWjob *job )
+{
+    job->next = NULL;
+
+    _glfwPlatformLockMutex( pool->mutex );
+    if( pool->last != NULL )
+    {
+        pool->last->next = job;
+    }
+    else
+    {
+        pool->first = job;
+    }
+    pool->last = job;
+    (void) _glfwAtomicAdd( &pool->queued, 1 );
+    _glfwPlatformUnlockMutex( pool->mutex );
+}
+
+
+//========================================================================
+// Take the first job from the pool's submission queue
+//========================================================================
+
+static _GLFWjob *DequeueJob( _GLFWpool *pool )
+{
+    _GLFWjob *job;
+
+    if( _glfwAtomicLoad( &pool->queued ) == 0 )
+    {
+        return NULL;
+    }
+
+    _glfwPlatformLockMutex( pool->mutex );
+    job = pool->first;
+    if( job != NULL )
+    {
+        pool->first = job->next;
+        if( pool->first == NULL )
+        {
+            pool->last = NULL;
+        }
+        (void) _glfwAtomicAdd( &pool->queued, -1 );
+    }
+    _glfwPlatformUnlockMutex( pool->mutex );
+
+    return job;
+}
+
+
+//========================================================================
+// Return the worker of the pool that is the calling thread, if any
+//========================================================================
+
+static _GLFWworker *FindWorker( _GLFWpool *pool )
+{
+    _GLFWworker *w;
+
+    w = (_GLFWworker *) _glfwPlatformGetThreadData();
+    if( w == NULL || w->pool != pool )
+    {
+        return NULL;
+    }
+
+    return w;
+}
+
+
+//========================================================================
+// Wake up a sleeping worker, if there is one
+//========================================================================
+
+static void WakeWorker( _GLFWpool *pool )
+{
+    // The new job must be visible before we look for sleepers, as they
+    // look for jobs after announcing that they are going to sleep
+    _glfwAtomicFence();
+
+    if( _glfwAtomicLoad( &pool->sleeping ) > 0 )
+    {
+        (void) _glfwAtomicAdd( &pool->signal, 1 );
+        _glfwPlatformWakeAddress( &pool->signal, 1 );
+    }
+}
+
+
+//========================================================================
+// Add a job to the calling worker's deque, or to the submission queue
+//========================================================================
+
+static void AddJob( _GLFWpool *pool, _GLFWworker *w, _GLFWjob *job )
+{
+    if( w == NULL || !PushJob( w, job ) )
+    {
+        EnqueueJob( pool, job );
+    }
+
+    WakeWorker( pool );
+}
+
+
+//========================================================================
+// Is there any job in the pool waiting to be run (or, for workers running
+// on fibers, any fiber ready to be resumed)?
+//========================================================================
+
+static int HasWork( _GLFWpool *pool, _GLFWworker *self )
+{
+    _GLFWworker  *w;
+    unsigned int b, t;
+    int          i;
+
+    if( self->current != NULL && _glfwAtomicLoad( &pool->readyCount ) > 0 )
+    {
+        return GL_TRUE;
+    }
+
+    for( i = 0;  i < pool->count;  i ++ )
+    {
+        w = &pool->workers[ i ];
+        t = _glfwAtomicLoad( &w->top );
+        b = _glfwAtomicLoad( &w->bottom );
+        if( (int) (b - t) > 0 )
+        {
+            return GL_TRUE;
+        }
+    }
+
+    return _glfwAtomicLoad( &pool->queued ) > 0;
+}
+
+
+//========================================================================
+// Find a job to run: first from our own deque, then by stealing from the
+// other workers (starting at a random one), then from the queue
+//========================================================================
+
+static _GLFWjob *FindJob( _GLFWpool *pool, _GLFWworker *w )
+{
+    _GLFWjob *job;
+    int      i, start;
+
+    if( w != NULL )
+    {
+        job = PopJob( w );
+        if( job != NULL )
+        {
+            return job;
+        }
+
+        w->seed ^= w->seed << 13;
+        w->seed ^= w->seed >> 17;
+        w->seed ^= w->seed << 5;
+        start = (int) (w->seed % (unsigned int) pool->count);
+    }
+    else
+    {
+        start = 0;
+    }
+
+    for( i = 0;  i < pool->count;  i ++ )
+    {
+        _GLFWworker *victim = &pool->workers[ (start + i) % pool->count ];
+        if( victim != w )
+        {
+            job = StealJob( victim );
+            if( job != NULL )
+            {
+                return job;
+            }
+        }
+    }
+
+    return DequeueJob( pool );
+}
+
+
+//========================================================================
+// Run a range of a parallel loop, splitting off the upper half as new
+// jobs until the range fits the grain size
+//========================================================================
+
+static void RunRange( _GLFWpool *pool, _GLFWworker *w, _GLFWjob *job )
+{
+    _GLFWloop *loop = job->loop;
+    _GLFWjob  *split;
+    int       begin = job->begin, end = job->end, mid;
+
+    free( job );
+
+    while( end - begin > loop->grain )
+    {
+        split = (_GLFWjob *) malloc( sizeof(_GLFWjob) );
+        if( split == NULL )
+        {
+            break;
+        }
+
+        mid = begin + (end - begin) / 2;
+
+        split->fun   = NULL;
+        split->arg   = NULL;
+        split->loop  = loop;
+        split->task  = NULL;
+        split->begin = mid;
+        split->end   = end;
+        AddJob( pool, w, split );
+
+        end = mid;
+    }
+
+    loop->fun( begin, end, loop->arg );
+
+    // Wake the thread waiting for the loop if this was the last range
+    if( _glfwAtomicAdd( &loop->remaining, -(end - begin) ) == end - begin )
+    {
+        _glfwPlatformWakeAddress( &loop->remaining, 0 );
+    }
+}
+
+
+//========================================================================
+// Run a task, then any of its successors that it made ready: the first
+// one on this thread, the others as new jobs on our own deque
+//========================================================================
+
+static void RunTask( _GLFWpool *pool, _GLFWworker *w, _GLFWtask *task )
+{
+    _GLFWtaskgraph *graph = task->graph;
+    _GLFWtask      *next, *successor;
+    int            i;
+
+    while( task != NULL )
+    {
+        task->fun( task->arg );
+
+        // The task may have waited, and continued on another thread
+        w = FindWorker( pool );
+
+        next = NULL;
+        for( i = 0;  i < task->successorCount;  i ++ )
+        {
+            successor = &graph->tasks[ task->successors[ i ] ];
+            if( _glfwAtomicAdd( &successor->waiting, -1 ) == 1 )
+            {
+                if( next == NULL )
+                {
+                    next = successor;
+                }
+                else
+                {
+                    AddJob( pool, w, &successor->job );
+                }
+            }
+        }
+
+        if( _glfwAtomicAdd( &graph->remaining, -1 ) == 1 )
+        {
+            _glfwPlatformWakeAddress( &graph->remaining, 0 );
+        }
+
+        task = next;
+    }
+}
+
+
+//========================================================================
+// Run a job
+//========================================================================
+
+static void RunJob( _GLFWpool *pool, _GLFWworker *w, _GLFWjob *job )
+{
+    GLFWjobfun fun;
+    void       *arg;
+
+    if( job->loop != NULL )
+    {
+        RunRange( pool, w, job );
+        return;
+    }
+
+    if( job->task != NULL )
+    {
+        RunTask( pool, w, job->task );
+        return;
+    }
+
+    fun = job->fun;
+    arg = job->arg;
+    free( job );
+
+    fun( arg );
+
+    if( _glfwAtomicAdd( &pool->pending, -1 ) == 1 )
+    {
+        _glfwPlatformWakeAddress( &pool->pending, 0 );
+    }
+}
+
+
+//========================================================================
+// Run jobs until the counter drops to zero, sleeping on the counter when
+// there is nothing left to help with
+//========================================================================
+
+static void HelpUntilZero( _GLFWpool *pool, _GLFWworker *w,
+                           volatile int *counter )
+{
+    _GLFWjob *job;
+    int      value, spins = 0;
+
+    for( ;; )
+    {
+        value = _glfwAtomicLoad( counter );
+        if( value <= 0 )
+        {
+            break;
+        }
+
+        job = FindJob( pool, w );
+        if( job != NULL )
+        {
+            RunJob( pool, w, job );
+            w = FindWorker( pool );
+            spins = 0;
+        }
+        else if( spins < _GLFW_POOL_SPIN )
+        {
+            _glfwAtomicPause();
+            spins ++;
+        }
+        else
+        {
+            _glfwPlatformWaitAddress( counter, value, GLFW_INFINITY );
+        }
+    }
+}
+
+
+//========================================================================
+// Create a fiber for the pool (not yet on any list but the pool's own)
+//========================================================================
+
+static void FiberMain( void *arg );
+
+static _GLFWfiber *NewFiber( _GLFWpool *pool )
+{
+    _GLFWfiber *fiber;
+
+    fiber = (_GLFWfiber *) calloc( 1, sizeof(_GLFWfiber) );
+    if( fiber == NULL )
+    {
+        return NULL;
+    }
+
+    fiber->pool   = pool;
+    fiber->handle = _glfwPlatformCreateFiber( FiberMain, fiber,
+                                              _GLFW_FIBER_STACK_SIZE );
+    if( fiber->handle == NULL )
+    {
+        free( fiber );
+        return NULL;
+    }
+
+    _glfwPlatformLockMutex( pool->mutex );
+    fiber->link = pool->allFibers;
+    pool->allFibers = fiber;
+    _glfwPlatformUnlockMutex( pool->mutex );
+
+    return fiber;
+}
+
+
+//========================================================================
+// Put a fiber that is not running on the pool's free list
+//========================================================================
+
+static void ReleaseFiber( _GLFWfiber *fiber )
+{
+    _GLFWpool *pool = fiber->pool;
+
+    _glfwPlatformLockMutex( pool->mutex );
+    fiber->next = pool->freeFibers;
+    pool->freeFibers = fiber;
+    _glfwPlatformUnlockMutex( pool->mutex );
+}
+
+
+//========================================================================
+// Take a fiber from the pool's free list, or create a new one
+//========================================================================
+
+static _GLFWfiber *TakeFreeFiber( _GLFWpool *pool )
+{
+    _GLFWfiber *fiber;
+
+    _glfwPlatformLockMutex( pool->mutex );
+    fiber = pool->freeFibers;
+    if( fiber != NULL )
+    {
+        pool->freeFibers = fiber->next;
+    }
+    _glfwPlatformUnlockMutex( pool->mutex );
+
+    if( fiber == NULL )
+    {
+        fiber = NewFiber( pool );
+    }
+
+    return fiber;
+}
+
+
+//========================================================================
+// Append a fiber that is done waiting to its pool's ready queue
+//========================================================================
+
+static void MakeFiberReady( _GLFWfiber *fiber )
+{
+    _GLFWpool *pool = fiber->pool;
+
+    fiber->next = NULL;
+
+    _glfwPlatformLockMutex( pool->mutex );
+    if( pool->readyLast != NULL )
+    {
+        pool->readyLast->next = fiber;
+    }
+    else
+    {
+        pool->readyFirst = fiber;
+    }
+    pool->readyLast = fiber;
+    (void) _glfwAtomicAdd( &pool->readyCount, 1 );
+    _glfwPlatformUnlockMutex( pool->mutex );
+
+    WakeWorker( pool );
+}
+
+
+//========================================================================
+// Take the first fiber from the pool's ready queue
+//========================================================================
+
+static _GLFWfiber *TakeReadyFiber( _GLFWpool *pool )
+{
+    _GLFWfiber *fiber;
+
+    if( _glfwAtomicLoad( &pool->readyCount ) == 0 )
+    {
+        return NULL;
+    }
+
+    _glfwPlatformLockMutex( pool->mutex );
+    fiber = pool->readyFirst;
+    if( fiber != NULL )
+    {
+        pool->readyFirst = fiber->next;
+        if( pool->readyFirst == NULL )
+        {
+            pool->readyLast = NULL;
+        }
+        (void) _glfwAtomicAdd( &pool->readyCount, -1 );
+    }
+    _glfwPlatformUnlockMutex( pool->mutex );
+
+    return fiber;
+}
+
+
+//========================================================================
+// Park a fiber that is not running until the counter drops to zero (or,
+// if counter is NULL or already zero, put it straight on the ready queue)
+//========================================================================
+
+static void ParkFiber( _GLFWfiber *fiber, _GLFWcounter *counter )
+{
+    if( counter != NULL )
+    {
+        _glfwPlatformLockMutex( counter->mutex );
+        if( _glfwAtomicLoad( &counter->value ) > 0 )
+        {
+            fiber->next = counter->waiters;
+            counter->waiters = fiber;
+            _glfwPlatformUnlockMutex( counter->mutex );
+            return;
+        }
+        _glfwPlatformUnlockMutex( counter->mutex );
+    }
+
+    MakeFiberReady( fiber );
+}
+
+
+//========================================================================
+// Wait for any glfwAddCounter that set the value to zero to be done with
+// the counter, so that the caller may destroy it
+//========================================================================
+
+static void LeaveCounter( _GLFWcounter *counter )
+{
+    _glfwPlatformLockMutex( counter->mutex );
+    _glfwPlatformUnlockMutex( counter->mutex );
+}
+
+
+//========================================================================
+// Finish a fiber switch, on the fiber that was switched to. The fiber we
+// switched away from is only freed or parked now, as any other thread
+// could resume it as soon as it is on a list.
+//========================================================================
+
+static _GLFWworker *AfterSwitch( void )
+{
+    _GLFWworker *w = (_GLFWworker *) _glfwPlatformGetThreadData();
+
+    if( w->release != NULL )
+    {
+        ReleaseFiber( w->release );
+        w->release = NULL;
+    }
+
+    if( w->park != NULL )
+    {
+        ParkFiber( w->park, w->parkCounter );
+        w->park = NULL;
+    }
+
+    return w;
+}
+
+
+//========================================================================
+// Switch the calling worker to another fiber. Returns when the calling
+// fiber is resumed, possibly on another worker thread, and returns the
+// worker of that thread.
+//========================================================================
+
+static _GLFWworker *ResumeFiber( _GLFWworker *w, _GLFWfiber *fiber )
+{
+    _GLFWfiber *current = w->current;
+
+    w->current = fiber;
+    _glfwPlatformSwitchFiber( current->handle, fiber->handle );
+
+    return AfterSwitch();
+}
+
+
+//========================================================================
+// Worker loop: resume ready fibers and run jobs until the pool quits
+//========================================================================
+
+static void RunWorker( _GLFWpool *pool, _GLFWworker *w )
+{
+    _GLFWfiber *fiber;
+    _GLFWjob   *job;
+    int        seq, spins = 0;
+
+    while( !_glfwAtomicLoad( &pool->quit ) )
+    {
+        // Fibers that are done waiting go first, as other jobs may in
+        // turn be waiting for them. This fiber is free once we switch.
+        if( w->current != NULL )
+        {
+            fiber = TakeReadyFiber( pool );
+            if( fiber != NULL )
+            {
+                w->release = w->current;
+                w = ResumeFiber( w, fiber );
+                spins = 0;
+                continue;
+            }
+        }
+
+        job = FindJob( pool, w );
+        if( job != NULL )
+        {
+            // Other sleeping workers may be able to help, too
+            WakeWorker( pool );
+
+            RunJob( pool, w, job );
+
+            // The job may have waited, and continued on another thread
+            w = FindWorker( pool );
+            spins = 0;
+            continue;
+        }
+
+        if( spins < _GLFW_POOL_SPIN )
+        {
+            _glfwAtomicPause();
+            spins ++;
+            continue;
+        }
+
+        // Announce that we are going to sleep, then look once more, so
+        // that a job added after our last look is not missed
+        seq = _glfwAtomicLoad( &pool->signal );
+        (void) _glfwAtomicAdd( &pool->sleeping, 1 );
+        if( !HasWork( pool, w ) && !_glfwAtomicLoad( &pool->quit ) )
+        {
+            _glfwPlatformWaitAddress( &pool->signal, seq, GLFW_INFINITY );
+        }
+        (void) _glfwAtomicAdd( &pool->sleeping, -1 );
+        spins = 0;
+    }
+}
+
+
+//========================================================================
+// Fiber function
+//========================================================================
+
+static void FiberMain( void *arg )
+{
+    _GLFWpool   *pool = ((_GLFWfiber *) arg)->pool;
+    _GLFWworker *w;
+
+    w = AfterSwitch();
+    RunWorker( pool, w );
+
+    // The pool is quitting, so return to the thread we ended up on
+    w = (_GLFWworker *) _glfwPlatformGetThreadData();
+    _glfwPlatformSwitchFiber( w->current->handle, w->native );
+}
+
+
+//========================================================================
+// Worker thread function
+//========================================================================
+
+static void GLFWCALL WorkerMain( void *arg )
+{
+    _GLFWworker *w = (_GLFWworker *) arg;
+    _GLFWpool   *pool = w->pool;
+
+    _glfwPlatformSetThreadData( w );
+
+    if( pool->fibers )
+    {
+        w->native = _glfwPlatformConvertThreadToFiber();
+        if( w->native != NULL )
+        {
+            w->current = TakeFreeFiber( pool );
+        }
+    }
+
+    if( w->current != NULL )
+    {
+        // Run the worker loop on fibers; this returns when the pool quits
+        _glfwPlatformSwitchFiber( w->native, w->current->handle );
+    }
+    else
+    {
+        RunWorker( pool, w );
+    }
+
+    if( w->native != NULL )
+    {
+        _glfwPlatformConvertFiberToThread( w->native );
+    }
+}
+
+
+//========================================================================
+// Stop the given number of worker threads and free the pool
+//========================================================================
+
+static void FreePool( _GLFWpool *pool, int started )
+{
+    _GLFWfiber *fiber;
+    int        i;
+
+    _glfwAtomicStore( &pool->quit, GL_TRUE );
+    (void) _glfwAtomicAdd( &pool->signal, 1 );
+    _glfwPlatformWakeAddress( &pool->signal, 0 );
+
+    for( i = 0;  i < started;  i ++ )
+    {
+        (void) _glfwPlatformWaitThread( pool->workers[ i ].thread,
+                                        GLFW_WAIT );
+    }
+
+    for( i = 0;  i < pool->count;  i ++ )
+    {
+        FreeJobArray( pool->workers[ i ].array );
+    }
+
+    while( pool->allFibers != NULL )
+    {
+        fiber = pool->allFibers;
+        pool->allFibers = fiber->link;
+        _glfwPlatformDestroyFiber( fiber->handle );
+        free( fiber );
+    }
+
+    if( pool->mutex != NULL )
+    {
+        _glfwPlatformDestroyMutex( pool->mutex );
+    }
+
+    free( pool->workers );
+    free( pool );
+}
+
+
+//========================================================================
+// Stop and free all pools
+//========================================================================
+
+void _glfwTerminatePools( void )
+{
+    _glfwDefaultPool = NULL;
+
+    while( _glfwPools != NULL )
+    {
+        glfwDestroyThreadPool( (GLFWpool) _glfwPools );
+    }
+}
+
+
+//========================================================================
+// Return the library's own pool, creating it on first use
+//========================================================================
+
+static _GLFWpool *GetDefaultPool( void )
+{
+    _GLFWpool *pool;
+
+    pool = (_GLFWpool *) _glfwAtomicLoadPtr( &_glfwDefaultPool );
+    if( pool != NULL )
+    {
+        return pool;
+    }
+
+    // Threads can not be created inside the critical section, so two
+    // threads may race to create the pool; the loser destroys its own
+    pool = (_GLFWpool *) glfwCreateThreadPool( 0 );
+    if( pool == NULL )
+    {
+        return NULL;
+    }
+
+    if( !_glfwAtomicCompareExchangePtr( &_glfwDefaultPool, NULL, pool ) )
+    {
+        glfwDestroyThreadPool( (GLFWpool) pool );
+        pool = (_GLFWpool *) _glfwAtomicLoadPtr( &_glfwDefaultPool );
+    }
+
+    return pool;
+}
+
+
+//========================================================================
+// Check that the dependencies of a task graph contain no cycles, by
+// removing tasks without remaining dependencies until none are left
+//========================================================================
+
+static int CheckTaskGraph( _GLFWtaskgraph *graph )
+{
+    int *waiting, *ready, count, done, i, j;
+
+    if( graph->checked || graph->count == 0 )
+    {
+        return GL_TRUE;
+    }
+
+    waiting = (int *) malloc( graph->count * 2 * sizeof(int) );
+    if( waiting == NULL )
+    {
+        return GL_FALSE;
+    }
+    ready = waiting + graph->count;
+
+    count = 0;
+    for( i = 0;  i < graph->count;  i ++ )
+    {
+        waiting[ i ] = graph->tasks[ i ].dependencies;
+        if( waiting[ i ] == 0 )
+        {
+            ready[ count ++ ] = i;
+        }
+    }
+
+    for( done = 0;  done < count;  done ++ )
+    {
+        _GLFWtask *task = &graph->tasks[ ready[ done ] ];
+        for( j = 0;  j < task->successorCount;  j ++ )
+        {
+            if( -- waiting[ task->successors[ j ] ] == 0 )
+            {
+                ready[ count ++ ] = task->successors[ j ];
+            }
+        }
+    }
+
+    free( waiting );
+
+    graph->checked = (count == graph->count);
+    return graph->checked;
+}
+
+
+
+//************************************************************************
+//****                     GLFW user functions                        ****
+//************************************************************************
+
+//========================================================================
+// Create a thread pool with the given number of worker threads (or, if
+// threads is less than one, one less than the number of processors)
+//========================================================================
+
+GLFWAPI GLFWpool GLFWAPIENTRY glfwCreateThreadPool( int threads )
+{
+    _GLFWpool         *pool;
+    _GLFWworker       *w;
+    _GLFWfiber        *fiber;
+    GLFWthreadattribs attribs;
+    int               i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    if( threads < 1 )
+    {
+        threads = _glfwGetUsableProcessors() - 1;
+        if( threads < 1 )
+        {
+            threads = 1;
+        }
+    }
+    if( threads > _GLFW_POOL_MAX_THREADS )
+    {
+        threads = _GLFW_POOL_MAX_THREADS;
+    }
+
+    pool = (_GLFWpool *) calloc( 1, sizeof(_GLFWpool) );
+    if( pool == NULL )
+    {
+        return NULL;
+    }
+
+    pool->count   = threads;
+    pool->workers = (_GLFWworker *) calloc( threads, sizeof(_GLFWworker) );
+    pool->mutex   = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+    if( pool->workers == NULL || pool->mutex == NULL )
+    {
+        FreePool( pool, 0 );
+        return NULL;
+    }
+
+    for( i = 0;  i < threads;  i ++ )
+    {
+        w = &pool->workers[ i ];
+        w->pool  = pool;
+        w->seed  = 2654435761u * (unsigned int) (i + 1);
+        w->array = NewJobArray( _GLFW_DEQUE_SIZE );
+        if( w->array == NULL )
+        {
+            FreePool( pool, 0 );
+            return NULL;
+        }
+    }
+
+    // Give every worker a fiber to start on. Without fiber support, jobs
+    // that wait for counters block their worker thread instead.
+    pool->fibers = GL_TRUE;
+    for( i = 0;  i < threads;  i ++ )
+    {
+        fiber = NewFiber( pool );
+        if( fiber == NULL )
+        {
+            pool->fibers = GL_FALSE;
+            break;
+        }
+        ReleaseFiber( fiber );
+    }
+
+    // Name the workers, so that they can be told apart in profilers
+    memset( &attribs, 0, sizeof(attribs) );
+    attribs.Name = "GLFW worker";
+
+    for( i = 0;  i < threads;  i ++ )
+    {
+        w = &pool->workers[ i ];
+        w->thread = _glfwPlatformCreateThread( WorkerMain, w, &attribs );
+        if( w->thread < 0 )
+        {
+            FreePool( pool, i );
+            return NULL;
+        }
+    }
+
+    ENTER_THREAD_CRITICAL_SECTION
+    pool->next = _glfwPools;
+    _glfwPools = pool;
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    return (GLFWpool) pool;
+}
+
+
+//========================================================================
+// Wait for all submitted jobs to finish, then stop the worker threads
+// and free the pool
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyThreadPool( GLFWpool handle )
+{
+    _GLFWpool *pool = (_GLFWpool *) handle, **prev;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || pool == NULL )
+    {
+        return;
+    }
+
+    HelpUntilZero( pool, NULL, &pool->pending );
+
+    ENTER_THREAD_CRITICAL_SECTION
+    for( prev = &_glfwPools;  *prev != NULL;  prev = &(*prev)->next )
+    {
+        if( *prev == pool )
+        {
+            *prev = pool->next;
+            break;
+        }
+    }
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    FreePool( pool, pool->count );
+}
+
+
+//========================================================================
+// Submit a job to be run by the pool
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwSubmitJob( GLFWpool handle, GLFWjobfun fun,
+                                        void *arg )
+{
+    _GLFWpool *pool = (_GLFWpool *) handle;
+    _GLFWjob  *job;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || pool == NULL || fun == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    job = (_GLFWjob *) malloc( sizeof(_GLFWjob) );
+    if( job == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    job->fun  = fun;
+    job->arg  = arg;
+    job->loop = NULL;
+    job->task = NULL;
+
+    (void) _glfwAtomicAdd( &pool->pending, 1 );
+    AddJob( pool, FindWorker( pool ), job );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Wait for all jobs submitted to the pool to finish, running jobs on the
+// calling thread in the meantime
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwWaitJobs( GLFWpool handle )
+{
+    _GLFWpool *pool = (_GLFWpool *) handle;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || pool == NULL )
+    {
+        return;
+    }
+
+    HelpUntilZero( pool, FindWorker( pool ), &pool->pending );
+}
+
+
+//========================================================================
+// Call fun for every iteration in [begin, end), split into ranges of at
+// most grain iterations that are run in parallel by the pool and the
+// calling thread. Returns when all iterations have been run.
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwParallelFor( GLFWpool handle, int begin,
+                                           int end, int grain,
+                                           GLFWforfun fun, void *arg )
+{
+    _GLFWpool   *pool = (_GLFWpool *) handle;
+    _GLFWworker *w;
+    _GLFWloop   loop;
+    _GLFWjob    *job;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || pool == NULL || fun == NULL || end <= begin )
+    {
+        return;
+    }
+
+    // Pick a grain size that gives each thread a few ranges to balance
+    if( grain < 1 )
+    {
+        grain = (end - begin) / ((pool->count + 1) * 8);
+        if( grain < 1 )
+        {
+            grain = 1;
+        }
+    }
+
+    job = (_GLFWjob *) malloc( sizeof(_GLFWjob) );
+    if( job == NULL || end - begin <= grain )
+    {
+        // Not worth (or not possible) to split
+        free( job );
+        fun( begin, end, arg );
+        return;
+    }
+
+    loop.fun       = fun;
+    loop.arg       = arg;
+    loop.grain     = grain;
+    loop.remaining = end - begin;
+
+    job->fun   = NULL;
+    job->arg   = NULL;
+    job->loop  = &loop;
+    job->task  = NULL;
+    job->begin = begin;
+    job->end   = end;
+
+    // Start on the calling thread, then help until the loop is done
+    RunRange( pool, FindWorker( pool ), job );
+
+    // The loop body may have waited, and continued on another thread
+    w = FindWorker( pool );
+    HelpUntilZero( pool, w, &loop.remaining );
+}
+
+
+//========================================================================
+// Create an empty task graph
+//========================================================================
+
+GLFWAPI GLFWtaskgraph GLFWAPIENTRY glfwCreateTaskGraph( void )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    return (GLFWtaskgraph) calloc( 1, sizeof(_GLFWtaskgraph) );
+}
+
+
+//========================================================================
+// Wait for a task graph to finish and free it
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyTaskGraph( GLFWtaskgraph handle )
+{
+    _GLFWtaskgraph *graph = (_GLFWtaskgraph *) handle;
+    int            i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || graph == NULL )
+    {
+        return;
+    }
+
+    glfwWaitTaskGraph( handle );
+
+    for( i = 0;  i < graph->count;  i ++ )
+    {
+        free( graph->tasks[ i ].successors );
+    }
+    free( graph->tasks );
+    free( graph );
+}
+
+
+//========================================================================
+// Add a task to a task graph. Returns the index of the new task, or -1.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAddTask( GLFWtaskgraph handle, GLFWjobfun fun,
+                                      void *arg )
+{
+    _GLFWtaskgraph *graph = (_GLFWtaskgraph *) handle;
+    _GLFWtask      *task;
+    int            i, size;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || graph == NULL || fun == NULL )
+    {
+        return -1;
+    }
+
+    // Tasks can not be added while the graph is running
+    if( _glfwAtomicLoad( &graph->remaining ) > 0 )
+    {
+        return -1;
+    }
+
+    if( graph->count == graph->size )
+    {
+        size = graph->size ? graph->size * 2 : 16;
+        task = (_GLFWtask *) realloc( graph->tasks,
+                                      size * sizeof(_GLFWtask) );
+        if( task == NULL )
+        {
+            return -1;
+        }
+        graph->tasks = task;
+        graph->size  = size;
+
+        // The task jobs point back at their (now moved) tasks
+        for( i = 0;  i < graph->count;  i ++ )
+        {
+            graph->tasks[ i ].job.task = &graph->tasks[ i ];
+        }
+    }
+
+    task = &graph->tasks[ graph->count ];
+    memset( task, 0, sizeof(_GLFWtask) );
+    task->fun      = fun;
+    task->arg      = arg;
+    task->graph    = graph;
+    task->job.task = task;
+
+    return graph->count ++;
+}
+
+
+//========================================================================
+// Make a task wait for another task (its dependency) to finish
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAddTaskDependency( GLFWtaskgraph handle,
+                                                int task, int dependency )
+{
+    _GLFWtaskgraph *graph = (_GLFWtaskgraph *) handle;
+    _GLFWtask      *before;
+    int            i, size, *successors;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || graph == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( task < 0 || task >= graph->count ||
+        dependency < 0 || dependency >= graph->count || task == dependency )
+    {
+        return GL_FALSE;
+    }
+
+    if( _glfwAtomicLoad( &graph->remaining ) > 0 )
+    {
+        return GL_FALSE;
+    }
+
+    before = &graph->tasks[ dependency ];
+
+    // Adding the same dependency twice changes nothing
+    for( i = 0;  i < before->successorCount;  i ++ )
+    {
+        if( before->successors[ i ] == task )
+        {
+            return GL_TRUE;
+        }
+    }
+
+    if( before->successorCount == before->successorSize )
+    {
+        size = before->successorSize ? before->successorSize * 2 : 4;
+        successors = (int *) realloc( before->successors,
+                                      size * sizeof(int) );
+        if( successors == NULL )
+        {
+            return GL_FALSE;
+        }
+        before->successors    = successors;
+        before->successorSize = size;
+    }
+
+    before->successors[ before->successorCount ++ ] = task;
+    graph->tasks[ task ].dependencies ++;
+    graph->checked = GL_FALSE;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Start running a task graph on a pool (or, if pool is NULL, on the
+// library's own pool). Returns immediately.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwLaunchTaskGraph( GLFWtaskgraph handle,
+                                              GLFWpool poolhandle )
+{
+    _GLFWtaskgraph *graph = (_GLFWtaskgraph *) handle;
+    _GLFWpool      *pool = (_GLFWpool *) poolhandle;
+    _GLFWworker    *w;
+    _GLFWtask      *task;
+    int            i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || graph == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // Is the graph still running from the last launch?
+    if( _glfwAtomicLoad( &graph->remaining ) > 0 )
+    {
+        return GL_FALSE;
+    }
+
+    // A graph with a cycle would never finish
+    if( !CheckTaskGraph( graph ) )
+    {
+        return GL_FALSE;
+    }
+
+    if( graph->count == 0 )
+    {
+        return GL_TRUE;
+    }
+
+    if( pool == NULL )
+    {
+        pool = GetDefaultPool();
+        if( pool == NULL )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    graph->pool = pool;
+
+    for( i = 0;  i < graph->count;  i ++ )
+    {
+        graph->tasks[ i ].waiting = graph->tasks[ i ].dependencies;
+    }
+    _glfwAtomicStore( &graph->remaining, graph->count );
+
+    w = FindWorker( pool );
+    for( i = 0;  i < graph->count;  i ++ )
+    {
+        task = &graph->tasks[ i ];
+        if( task->dependencies == 0 )
+        {
+            AddJob( pool, w, &task->job );
+        }
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Wait for a launched task graph to finish, running jobs of its pool on
+// the calling thread in the meantime
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwWaitTaskGraph( GLFWtaskgraph handle )
+{
+    _GLFWtaskgraph *graph = (_GLFWtaskgraph *) handle;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || graph == NULL )
+    {
+        return;
+    }
+
+    if( _glfwAtomicLoad( &graph->remaining ) > 0 )
+    {
+        HelpUntilZero( graph->pool, FindWorker( graph->pool ),
+                       &graph->remaining );
+    }
+}
+
+
+//========================================================================
+// Create a counter with the given initial value
+//========================================================================
+
+GLFWAPI GLFWcounter GLFWAPIENTRY glfwCreateCounter( int value )
+{
+    _GLFWcounter *counter;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    counter = (_GLFWcounter *) calloc( 1, sizeof(_GLFWcounter) );
+    if( counter == NULL )
+    {
+        return NULL;
+    }
+
+    counter->mutex = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+    if( counter->mutex == NULL )
+    {
+        free( counter );
+        return NULL;
+    }
+
+    counter->value = value;
+    return (GLFWcounter) counter;
+}
+
+
+//========================================================================
+// Destroy a counter (nothing may be waiting for it)
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyCounter( GLFWcounter handle )
+{
+    _GLFWcounter *counter = (_GLFWcounter *) handle;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || counter == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformDestroyMutex( counter->mutex );
+    free( counter );
+}
+
+
+//========================================================================
+// Add delta to a counter and return the new value. When the value drops
+// to zero (or below), everything waiting for the counter is resumed.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwAddCounter( GLFWcounter handle, int delta )
+{
+    _GLFWcounter *counter = (_GLFWcounter *) handle;
+    _GLFWfiber   *fiber, *next;
+    int          value;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || counter == NULL )
+    {
+        return 0;
+    }
+
+    for( ;; )
+    {
+        value = _glfwAtomicLoad( &counter->value );
+        if( value > 0 && value + delta <= 0 )
+        {
+            break;
+        }
+
+        // The value does not drop to zero, so nobody needs waking
+        if( _glfwAtomicCompareExchange( &counter->value, value,
+                                        value + delta ) )
+        {
+            return value + delta;
+        }
+    }
+
+    // The value may drop to zero, which must happen under the mutex: a
+    // waiter may destroy the counter once it has seen zero, but it takes
+    // the mutex first, so we are done with the counter by then. Fibers
+    // park under the mutex after checking the value, so none can be
+    // missed here either.
+    fiber = NULL;
+
+    _glfwPlatformLockMutex( counter->mutex );
+    value = _glfwAtomicAdd( &counter->value, delta );
+    if( value > 0 && value + delta <= 0 )
+    {
+        fiber = counter->waiters;
+        counter->waiters = NULL;
+        _glfwPlatformWakeAddress( &counter->value, 0 );
+    }
+    _glfwPlatformUnlockMutex( counter->mutex );
+
+    while( fiber != NULL )
+    {
+        next = fiber->next;
+        MakeFiberReady( fiber );
+        fiber = next;
+    }
+
+    return value + delta;
+}
+
+
+//========================================================================
+// Wait until a counter drops to zero (or below). In a job run by a pool
+// with fiber support, the job is put aside and the worker thread runs
+// other jobs in the meantime; the job may then continue on another
+// worker thread. Elsewhere, the calling thread runs jobs of its own pool
+// (if it is a worker) or sleeps.
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwWaitCounter( GLFWcounter handle )
+{
+    _GLFWcounter *counter = (_GLFWcounter *) handle;
+    _GLFWworker  *w;
+    _GLFWfiber   *fiber;
+    int          value;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || counter == NULL )
+    {
+        return;
+    }
+
+    if( _glfwAtomicLoad( &counter->value ) <= 0 )
+    {
+        LeaveCounter( counter );
+        return;
+    }
+
+    w = (_GLFWworker *) _glfwPlatformGetThreadData();
+    if( w != NULL )
+    {
+        if( w->current != NULL )
+        {
+            fiber = TakeReadyFiber( w->pool );
+            if( fiber == NULL )
+            {
+                fiber = TakeFreeFiber( w->pool );
+            }
+
+            if( fiber != NULL )
+            {
+                // We are parked on the counter once we have switched away,
+                // and only made ready again after the mutex is released
+                w->park        = w->current;
+                w->parkCounter = counter;
+                (void) ResumeFiber( w, fiber );
+                return;
+            }
+        }
+
+        HelpUntilZero( w->pool, w, &counter->value );
+        LeaveCounter( counter );
+        return;
+    }
+
+    for( ;; )
+    {
+        value = _glfwAtomicLoad( &counter->value );
+        if( value <= 0 )
+        {
+            break;
+        }
+
+        _glfwPlatformWaitAddress( &counter->value, value, GLFW_INFINITY );
+    }
+
+    LeaveCounter( counter );
+}
+
+
+//========================================================================
+// Let other work run on the calling worker thread: resume a fiber that is
+// done waiting (putting this job aside until its turn comes again), or
+// run a pending job. Does nothing on threads that are not pool workers.
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwYieldFiber( void )
+{
+    _GLFWworker *w;
+    _GLFWfiber  *fiber;
+    _GLFWjob    *job;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return;
+    }
+
+    w = (_GLFWworker *) _glfwPlatformGetThreadData();
+    if( w == NULL )
+    {
+        return;
+    }
+
+    if( w->current != NULL )
+    {
+        fiber = TakeReadyFiber( w->pool );
+        if( fiber != NULL )
+        {
+            w->park        = w->current;
+            w->parkCounter = NULL;
+            (void) ResumeFiber( w, fiber );
+            return;
+        }
+    }
+
+    job = FindJob( w->pool, w );
+    if( job != NULL )
+    {
+        RunJob( w->pool, w, job );
+    }
+}
@@ -0,0 +1,493 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+
+
+//========================================================================
+// Description:
+//
+// Image prefetching. Images that will soon be read are handed to a
+// background thread, which first asks the system to read the files ahead
+// (so that the reads are queued while the application is busy with other
+// things) and then, if asked to, decodes them into a small cache. A later
+// glfwReadImage of the same file with the same flags takes the decoded
+// image from the cache instead of reading the file again.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Decoded images are held up to this many bytes; decoding is resumed as
+// cached images are taken, or as images left over from earlier requests
+// are evicted
+#define _GLFW_PREFETCH_CACHE_SIZE  (64 * 1024 * 1024)
+
+// Flags that change the decoded image (and so must match for a hit)
+#define _GLFW_PREFETCH_FLAG_MASK   (GLFW_NO_RESCALE_BIT | \
+                                    GLFW_ORIGIN_UL_BIT | \
+                                    GLFW_ALPHA_MAP_BIT | \
+                                    GLFW_SUBSAMPLE_2_BIT | \
+                                    GLFW_SUBSAMPLE_4_BIT | \
+                                    GLFW_SUBSAMPLE_8_BIT)
+
+// Prefetch entry states
+#define _GLFW_PREFETCH_QUEUED   0  // Waiting for its read-ahead hint
+#define _GLFW_PREFETCH_HINTED   1  // Hinted, waiting to be decoded
+#define _GLFW_PREFETCH_BUSY     2  // Being hinted or decoded
+#define _GLFW_PREFETCH_READY    3  // Decoded and cached
+
+
+//========================================================================
+// Prefetched image
+//========================================================================
+
+typedef struct _GLFWprefetch_struct _GLFWprefetch;
+
+struct _GLFWprefetch_struct {
+    char          *name;
+    int           flags;
+    int           state;
+    unsigned int  request;      // glfwPrefetchImages call it came from
+    GLFWimage     image;
+    size_t        size;
+    _GLFWprefetch *next;
+};
+
+// Prefetch queue and cache, in the order the images were requested
+static struct {
+    GLFWmutex     mutex;
+    GLFWcond      cond;
+    GLFWthread    thread;
+    int           quit;
+    size_t        cached;
+    unsigned int  requests;     // Number of glfwPrefetchImages calls
+    _GLFWprefetch *first, *last;
+} _glfwPrefetch = { NULL, NULL, -1, GL_FALSE, 0, 0, NULL, NULL };
+
+
+//========================================================================
+// Unlink and free a prefetch entry (the mutex must be held)
+//========================================================================
+
+static void RemovePrefetch( _GLFWprefetch *entry )
+{
+    _GLFWprefetch **prev, *last;
+
+    last = NULL;
+    for( prev = &_glfwPrefetch.first;  *prev != entry;
+         prev = &(*prev)->next )
+    {
+        last = *prev;
+    }
+    *prev = entry->next;
+    if( _glfwPrefetch.last == entry )
+    {
+        _glfwPrefetch.last = last;
+    }
+
+    if( entry->state == _GLFW_PREFETCH_READY )
+    {
+        _glfwPrefetch.cached -= entry->size;
+        free( entry->image.Data );
+    }
+
+    free( entry->name );
+    free( entry );
+}
+
+
+//========================================================================
+// Make room in a full cache for decoding the given entry, by evicting
+// decoded images that were requested by earlier glfwPrefetchImages calls
+// and never taken, least recently requested first (the mutex must be
+// held). Images of the same request are never evicted for each other, as
+// they will most likely be read in order. Returns GL_TRUE if there is
+// room now.
+//========================================================================
+
+static int EvictPrefetch( const _GLFWprefetch *needed )
+{
+    _GLFWprefetch *entry, *next;
+
+    // The list is in request order, so the oldest entries come first
+    for( entry = _glfwPrefetch.first;
+         entry && _glfwPrefetch.cached >= _GLFW_PREFETCH_CACHE_SIZE;
+         entry = next )
+    {
+        next = entry->next;
+
+        // Wrapping request numbers compare correctly as differences
+        if( (int) (entry->request - needed->request) >= 0 )
+        {
+            break;
+        }
+
+        if( entry->state == _GLFW_PREFETCH_READY )
+        {
+            RemovePrefetch( entry );
+        }
+    }
+
+    return _glfwPrefetch.cached < _GLFW_PREFETCH_CACHE_SIZE;
+}
+
+
+//========================================================================
+// Find the next entry to work on (the mutex must be held). Read-ahead
+// hints go before decoding, so that all reads are queued early on
+//========================================================================
+
+static _GLFWprefetch * NextPrefetch( void )
+{
+    _GLFWprefetch *entry;
+
+    for( entry = _glfwPrefetch.first;  entry;  entry = entry->next )
+    {
+        if( entry->state == _GLFW_PREFETCH_QUEUED )
+        {
+            return entry;
+        }
+    }
+
+    for( entry = _glfwPrefetch.first;  entry;  entry = entry->next )
+    {
+        if( entry->state == _GLFW_PREFETCH_HINTED )
+        {
+            if( _glfwPrefetch.cached >= _GLFW_PREFETCH_CACHE_SIZE &&
+                !EvictPrefetch( entry ) )
+            {
+                return NULL;
+            }
+
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+//========================================================================
+// Prefetch thread; works through the queue until GLFW is terminated
+//========================================================================
+
+static void GLFWCALL PrefetchWorker( void *arg )
+{
+    _GLFWprefetch *entry;
+    GLFWimage     image;
+    int           state, success;
+
+    (void) arg;
+
+    _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+
+    while( !_glfwPrefetch.quit )
+    {
+        entry = NextPrefetch();
+        if( entry == NULL )
+        {
+            _glfwPlatformWaitCond( _glfwPrefetch.cond, _glfwPrefetch.mutex,
+                                   GLFW_INFINITY );
+            continue;
+        }
+
+        state = entry->state;
+        success = GL_FALSE;
+        entry->state = _GLFW_PREFETCH_BUSY;
+        _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+
+        // The entry cannot be removed while it is busy, so it is safe to
+        // use it without holding the mutex
+        if( state == _GLFW_PREFETCH_QUEUED )
+        {
+            if( strncmp( entry->name, "pack:", 5 ) != 0 )
+            {
+                _glfwPlatformPrefetchFile( entry->name );
+            }
+        }
+        else
+        {
+            success = _glfwReadImageFile( entry->name, &image,
+                                          entry->flags );
+        }
+
+        _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+
+        if( state == _GLFW_PREFETCH_QUEUED &&
+            (entry->flags & GLFW_PREFETCH_DECODE_BIT) )
+        {
+            entry->state = _GLFW_PREFETCH_HINTED;
+        }
+        else if( state == _GLFW_PREFETCH_HINTED && success )
+        {
+            entry->image = image;
+            entry->size  = (size_t) image.Width * image.Height *
+                           image.BytesPerPixel;
+            entry->state = _GLFW_PREFETCH_READY;
+            _glfwPrefetch.cached += entry->size;
+        }
+        else
+        {
+            RemovePrefetch( entry );
+        }
+
+        // Readers may be waiting for this entry
+        _glfwPlatformBroadcastCond( _glfwPrefetch.cond );
+    }
+
+    _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+}
+
+
+//========================================================================
+// Take a prefetched image from the cache, if there is one for this file
+// and these flags. Returns GL_FALSE if the image must be read as usual
+//========================================================================
+
+int _glfwTakePrefetchedImage( const char *name, GLFWimage *img, int flags )
+{
+    _GLFWprefetch *entry;
+    int           result;
+
+    if( _glfwPrefetch.mutex == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    result = GL_FALSE;
+
+    _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+
+    for( entry = _glfwPrefetch.first;  entry;  )
+    {
+        if( strcmp( entry->name, name ) != 0 ||
+            ((entry->flags ^ flags) & _GLFW_PREFETCH_FLAG_MASK) )
+        {
+            entry = entry->next;
+            continue;
+        }
+
+        if( entry->state == _GLFW_PREFETCH_BUSY )
+        {
+            // Wait for it to be finished, and then look again, as the
+            // entry may be gone by then
+            _glfwPlatformWaitCond( _glfwPrefetch.cond, _glfwPrefetch.mutex,
+                                   GLFW_INFINITY );
+            entry = _glfwPrefetch.first;
+            continue;
+        }
+
+        if( entry->state == _GLFW_PREFETCH_READY )
+        {
+            // Hand over the decoded image rather than copying it
+            *img = entry->image;
+            entry->image.Data = NULL;
+            result = GL_TRUE;
+        }
+
+        // Either way, the reader no longer needs this entry
+        RemovePrefetch( entry );
+
+        // Room may have been made in the cache
+        _glfwPlatformBroadcastCond( _glfwPrefetch.cond );
+        break;
+    }
+
+    _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+
+    return result;
+}
+
+
+//========================================================================
+// Stop the prefetch thread and drop all cached images
+//========================================================================
+
+void _glfwTerminatePrefetch( void )
+{
+    if( _glfwPrefetch.mutex == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+    _glfwPrefetch.quit = GL_TRUE;
+    _glfwPlatformBroadcastCond( _glfwPrefetch.cond );
+    _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+
+    if( _glfwPrefetch.thread >= 0 )
+    {
+        _glfwPlatformWaitThread( _glfwPrefetch.thread, GLFW_WAIT );
+    }
+
+    while( _glfwPrefetch.first )
+    {
+        RemovePrefetch( _glfwPrefetch.first );
+    }
+
+    _glfwPlatformDestroyCond( _glfwPrefetch.cond );
+    _glfwPlatformDestroyMutex( _glfwPrefetch.mutex );
+
+    _glfwPrefetch.mutex    = NULL;
+    _glfwPrefetch.cond     = NULL;
+    _glfwPrefetch.thread   = -1;
+    _glfwPrefetch.quit     = GL_FALSE;
+    _glfwPrefetch.cached   = 0;
+    _glfwPrefetch.requests = 0;
+}
+
+
+//========================================================================
+// Start the prefetch thread, if it is not already running
+//========================================================================
+
+static int StartPrefetch( void )
+{
+    GLFWthreadattribs attribs;
+    int               result;
+
+    // The thread critical section must not be held while creating the
+    // thread, so it only guards creation of the mutex
+    ENTER_THREAD_CRITICAL_SECTION
+
+    if( _glfwPrefetch.mutex == NULL )
+    {
+        _glfwPrefetch.cond  = _glfwPlatformCreateCond();
+        _glfwPrefetch.mutex = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+        if( _glfwPrefetch.cond == NULL || _glfwPrefetch.mutex == NULL )
+        {
+            if( _glfwPrefetch.cond )
+            {
+                _glfwPlatformDestroyCond( _glfwPrefetch.cond );
+            }
+            if( _glfwPrefetch.mutex )
+            {
+                _glfwPlatformDestroyMutex( _glfwPrefetch.mutex );
+            }
+            _glfwPrefetch.cond  = NULL;
+            _glfwPrefetch.mutex = NULL;
+        }
+    }
+
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    if( _glfwPrefetch.mutex == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+    if( _glfwPrefetch.thread < 0 )
+    {
+        memset( &attribs, 0, sizeof(attribs) );
+        attribs.Name = "GLFW prefetch";
+
+        _glfwPrefetch.thread = _glfwPlatformCreateThread( PrefetchWorker,
+                                                          NULL, &attribs );
+    }
+    result = _glfwPrefetch.thread >= 0;
+    _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+
+    return result;
+}
+
+
+//************************************************************************
+//****                    GLFW user functions                         ****
+//************************************************************************
+
+//========================================================================
+// Tell GLFW which images will soon be read, so that their files can be
+// read ahead, and optionally decoded, in the background
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwPrefetchImages( const char **names,
+    int count, int flags )
+{
+    _GLFWprefetch *entry;
+    int           i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || count <= 0 )
+    {
+        return;
+    }
+
+    if( !StartPrefetch() )
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex( _glfwPrefetch.mutex );
+
+    _glfwPrefetch.requests ++;
+
+    for( i = 0; i < count; i ++ )
+    {
+        entry = (_GLFWprefetch *) malloc( sizeof(_GLFWprefetch) );
+        if( entry == NULL )
+        {
+            break;
+        }
+
+        entry->name = (char *) malloc( strlen( names[ i ] ) + 1 );
+        if( entry->name == NULL )
+        {
+            free( entry );
+            break;
+        }
+        strcpy( entry->name, names[ i ] );
+
+        entry->flags      = flags;
+        entry->state      = _GLFW_PREFETCH_QUEUED;
+        entry->request    = _glfwPrefetch.requests;
+        entry->image.Data = NULL;
+        entry->size       = 0;
+        entry->next       = NULL;
+
+        if( _glfwPrefetch.last )
+        {
+            _glfwPrefetch.last->next = entry;
+        }
+        else
+        {
+            _glfwPrefetch.first = entry;
+        }
+        _glfwPrefetch.last = entry;
+    }
+
+    _glfwPlatformSignalCond( _glfwPrefetch.cond );
+    _glfwPlatformUnlockMutex( _glfwPrefetch.mutex );
+}
@@ -0,0 +1,505 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+//========================================================================
+// Description:
+//
+// Bounded lock-free queues of fixed size elements, for handing data
+// between threads. Single producer, single consumer queues are plain
+// ring buffers, where each side only writes its own index and keeps a
+// cached copy of the other side's. Multiple producer, multiple consumer
+// queues give every slot a sequence number that tells producers and
+// consumers whose turn it is, so that each side only needs a single
+// compare-and-exchange on its index.
+//
+// The blocking functions spin briefly, then sleep on an address wait (a
+// futex where available). The other side only makes a system call to
+// wake them when somebody is actually sleeping.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Assumed cache line size, used to keep the two sides of a queue apart
+#define _GLFW_CACHE_LINE        64
+
+// Upper limit on the number of elements in a queue
+#define _GLFW_QUEUE_MAX_SIZE    (1 << 30)
+
+// Number of times a blocked push or pop retries before going to sleep
+#define _GLFW_QUEUE_SPIN        256
+
+
+//========================================================================
+// Queue
+//========================================================================
+
+typedef struct {
+    // Producer side: next slot to push, and (for single producer queues)
+    // the last consumer index seen
+    volatile unsigned int tail;
+    unsigned int          headCache;
+    char                  pad1[ _GLFW_CACHE_LINE - 2 * sizeof(unsigned int) ];
+
+    // Consumer side: next slot to pop, and (for single consumer queues)
+    // the last producer index seen
+    volatile unsigned int head;
+    unsigned int          tailCache;
+    char                  pad2[ _GLFW_CACHE_LINE - 2 * sizeof(unsigned int) ];
+
+    // Sleeping producers and consumers
+    volatile int  notEmpty;     // Bumped by pushes when consumers sleep
+    volatile int  popWaiters;
+    volatile int  notFull;      // Bumped by pops when producers sleep
+    volatile int  pushWaiters;
+
+    int           mode;
+    unsigned int  mask;
+    int           elemSize;
+    int           stride;       // Bytes per slot
+    char          *slots;
+} _GLFWqueue;
+
+// Multiple producer, multiple consumer slots start with their sequence
+// number, followed by the element
+#define SLOT( q, i )      ((q)->slots + ((i) & (q)->mask) * (q)->stride)
+#define SLOT_SEQ( s )     ((volatile unsigned int *) (s))
+#define SLOT_DATA( q, s ) \
+        ((q)->mode == GLFW_QUEUE_MPMC ? (s) + sizeof(unsigned int) : (s))
+
+
+//========================================================================
+// Push an element onto a queue, unless it is full
+//========================================================================
+
+static int PushElement( _GLFWqueue *q, const void *elem )
+{
+    unsigned int pos, seq;
+    char         *slot;
+
+    if( q->mode == GLFW_QUEUE_SPSC )
+    {
+        pos = _glfwAtomicLoadRelaxed( &q->tail );
+        if( pos - q->headCache > q->mask )
+        {
+            q->headCache = _glfwAtomicLoad( &q->head );
+            if( pos - q->headCache > q->mask )
+            {
+                return GL_FALSE;
+            }
+        }
+
+        memcpy( SLOT( q, pos ), elem, q->elemSize );
+        (void) _glfwAtomicExchange( &q->tail, pos + 1 );
+        return GL_TRUE;
+    }
+
+    pos = _glfwAtomicLoadRelaxed( &q->tail );
+    for( ;; )
+    {
+        slot = SLOT( q, pos );
+        seq = _glfwAtomicLoad( SLOT_SEQ( slot ) );
+
+        if( seq == pos )
+        {
+            // The slot is free; try to claim it
+            if( _glfwAtomicCompareExchange( &q->tail, pos, pos + 1 ) )
+            {
+                break;
+            }
+            pos = _glfwAtomicLoadRelaxed( &q->tail );
+        }
+        else if( (int) (seq - pos) < 0 )
+        {
+            // The slot still holds an element from the previous lap
+            return GL_FALSE;
+        }
+        else
+        {
+            // Another producer claimed the slot first
+            pos = _glfwAtomicLoadRelaxed( &q->tail );
+        }
+    }
+
+    memcpy( SLOT_DATA( q, slot ), elem, q->elemSize );
+
+    // Hand the slot over to the consumers
+    (void) _glfwAtomicExchange( SLOT_SEQ( slot ), pos + 1 );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Pop an element from a queue, unless it is empty
+//========================================================================
+
+static int PopElement( _GLFWqueue *q, void *elem )
+{
+    unsigned int pos, seq;
+    char         *slot;
+
+    if( q->mode == GLFW_QUEUE_SPSC )
+    {
+        pos = _glfwAtomicLoadRelaxed( &q->head );
+        if( pos == q->tailCache )
+        {
+            q->tailCache = _glfwAtomicLoad( &q->tail );
+            if( pos == q->tailCache )
+            {
+                return GL_FALSE;
+            }
+        }
+
+        memcpy( elem, SLOT( q, pos ), q->elemSize );
+        (void) _glfwAtomicExchange( &q->head, pos + 1 );
+        return GL_TRUE;
+    }
+
+    pos = _glfwAtomicLoadRelaxed( &q->head );
+    for( ;; )
+    {
+        slot = SLOT( q, pos );
+        seq = _glfwAtomicLoad( SLOT_SEQ( slot ) );
+
+        if( seq == pos + 1 )
+        {
+            // The slot holds an element; try to claim it
+            if( _glfwAtomicCompareExchange( &q->head, pos, pos + 1 ) )
+            {
+                break;
+            }
+            pos = _glfwAtomicLoadRelaxed( &q->head );
+        }
+        else if( (int) (seq - (pos + 1)) < 0 )
+        {
+            // The slot has not been filled yet
+            return GL_FALSE;
+        }
+        else
+        {
+            // Another consumer claimed the slot first
+            pos = _glfwAtomicLoadRelaxed( &q->head );
+        }
+    }
+
+    memcpy( elem, SLOT_DATA( q, slot ), q->elemSize );
+
+    // Hand the slot back to the producers, for the next lap
+    (void) _glfwAtomicExchange( SLOT_SEQ( slot ), pos + q->mask + 1 );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Wake up one thread sleeping on the given signal, if there is one
+//========================================================================
+
+static void WakeQueue( volatile int *signal, volatile int *waiters )
+{
+    // Sleepers try again after announcing that they sleep, so the change
+    // to the queue must be visible before we look for them. Elements are
+    // published with an exchange rather than a store for this reason, as
+    // that is a full barrier and saves a separate fence.
+    if( _glfwAtomicLoad( waiters ) > 0 )
+    {
+        (void) _glfwAtomicAdd( signal, 1 );
+        _glfwPlatformWakeAddress( signal, 1 );
+    }
+}
+
+
+//========================================================================
+// Push or pop an element, waiting up to timeout seconds for room or for
+// an element to arrive
+//========================================================================
+
+static int WaitQueue( _GLFWqueue *q, void *elem, int push, double timeout )
+{
+    volatile int *signal, *waiters;
+    double       deadline = 0.0, remaining = timeout;
+    int          seq, done, spins;
+
+    if( push )
+    {
+        signal  = &q->notFull;
+        waiters = &q->pushWaiters;
+    }
+    else
+    {
+        signal  = &q->notEmpty;
+        waiters = &q->popWaiters;
+    }
+
+    if( timeout < GLFW_INFINITY )
+    {
+        deadline = _glfwPlatformGetTime() + timeout;
+    }
+
+    for( ;; )
+    {
+        for( spins = 0;  spins < _GLFW_QUEUE_SPIN;  spins ++ )
+        {
+            done = push ? PushElement( q, elem ) : PopElement( q, elem );
+            if( done )
+            {
+                return GL_TRUE;
+            }
+            _glfwAtomicPause();
+        }
+
+        if( timeout < GLFW_INFINITY )
+        {
+            remaining = deadline - _glfwPlatformGetTime();
+            if( remaining <= 0.0 )
+            {
+                return GL_FALSE;
+            }
+        }
+
+        // Announce that we are going to sleep, then try once more, so
+        // that a change made after our last try is not missed
+        seq = _glfwAtomicLoad( signal );
+        (void) _glfwAtomicAdd( waiters, 1 );
+        done = push ? PushElement( q, elem ) : PopElement( q, elem );
+        if( !done )
+        {
+            _glfwPlatformWaitAddress( signal, seq, remaining );
+        }
+        (void) _glfwAtomicAdd( waiters, -1 );
+
+        if( done )
+        {
+            return GL_TRUE;
+        }
+    }
+}
+
+
+
+//************************************************************************
+//****                     GLFW user functions                        ****
+//************************************************************************
+
+//========================================================================
+// Create a queue with room for at least capacity elements of elemSize
+// bytes each
+//========================================================================
+
+GLFWAPI GLFWqueue GLFWAPIENTRY glfwCreateQueue( int capacity, int elemSize,
+                                                int mode )
+{
+    _GLFWqueue   *q;
+    unsigned int size, i;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    if( capacity < 1 || capacity > _GLFW_QUEUE_MAX_SIZE || elemSize < 1 ||
+        (mode != GLFW_QUEUE_SPSC && mode != GLFW_QUEUE_MPMC) )
+    {
+        return NULL;
+    }
+
+    // Round the capacity up to a power of two (and to at least two, as
+    // sequence numbers must tell a full slot from a free one)
+    size = 2;
+    while( size < (unsigned int) capacity )
+    {
+        size <<= 1;
+    }
+
+    q = (_GLFWqueue *) calloc( 1, sizeof(_GLFWqueue) );
+    if( q == NULL )
+    {
+        return NULL;
+    }
+
+    q->mode     = mode;
+    q->mask     = size - 1;
+    q->elemSize = elemSize;
+
+    if( mode == GLFW_QUEUE_MPMC )
+    {
+        // Keep the sequence numbers of all slots aligned
+        q->stride = (sizeof(unsigned int) + elemSize +
+                     sizeof(unsigned int) - 1) &
+                    ~(sizeof(unsigned int) - 1);
+    }
+    else
+    {
+        q->stride = elemSize;
+    }
+
+    q->slots = (char *) malloc( (size_t) size * q->stride );
+    if( q->slots == NULL )
+    {
+        free( q );
+        return NULL;
+    }
+
+    if( mode == GLFW_QUEUE_MPMC )
+    {
+        for( i = 0;  i < size;  i ++ )
+        {
+            *SLOT_SEQ( SLOT( q, i ) ) = i;
+        }
+    }
+
+    return (GLFWqueue) q;
+}
+
+
+//========================================================================
+// Destroy a queue (and any elements left in it)
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyQueue( GLFWqueue queue )
+{
+    _GLFWqueue *q = (_GLFWqueue *) queue;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || q == NULL )
+    {
+        return;
+    }
+
+    free( q->slots );
+    free( q );
+}
+
+
+//========================================================================
+// Push a copy of an element onto a queue, unless it is full. Returns
+// GL_TRUE if the element was pushed.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwTryPushQueue( GLFWqueue queue, const void *elem )
+{
+    _GLFWqueue *q = (_GLFWqueue *) queue;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || q == NULL || elem == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !PushElement( q, elem ) )
+    {
+        return GL_FALSE;
+    }
+
+    WakeQueue( &q->notEmpty, &q->popWaiters );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Pop the oldest element from a queue into elem, unless it is empty.
+// Returns GL_TRUE if an element was popped.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwTryPopQueue( GLFWqueue queue, void *elem )
+{
+    _GLFWqueue *q = (_GLFWqueue *) queue;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || q == NULL || elem == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !PopElement( q, elem ) )
+    {
+        return GL_FALSE;
+    }
+
+    WakeQueue( &q->notFull, &q->pushWaiters );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Push a copy of an element onto a queue, waiting up to timeout seconds
+// for room. Returns GL_TRUE if the element was pushed.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwPushQueue( GLFWqueue queue, const void *elem,
+                                        double timeout )
+{
+    _GLFWqueue *q = (_GLFWqueue *) queue;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || q == NULL || elem == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !WaitQueue( q, (void *) elem, GL_TRUE, timeout ) )
+    {
+        return GL_FALSE;
+    }
+
+    WakeQueue( &q->notEmpty, &q->popWaiters );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Pop the oldest element from a queue into elem, waiting up to timeout
+// seconds for one to arrive. Returns GL_TRUE if an element was popped.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwPopQueue( GLFWqueue queue, void *elem,
+                                       double timeout )
+{
+    _GLFWqueue *q = (_GLFWqueue *) queue;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || q == NULL || elem == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !WaitQueue( q, elem, GL_FALSE, timeout ) )
+    {
+        return GL_FALSE;
+    }
+
+    WakeQueue( &q->notFull, &q->pushWaiters );
+    return GL_TRUE;
+}
@@ -0,0 +1,557 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+//========================================================================
+// Description:
+//
+// Locks for data that is read much more often than it is written.
+//
+// Reader-writer locks count their readers in a number of counters, each
+// on a cache line of its own, and every thread picks its counter from
+// the address of its stack. Readers on different processors therefore
+// rarely touch the same cache line, and only a writer has to add up all
+// the counters. A reader may well leave through another counter than it
+// entered by; only the sum matters. Writers take turns on a mutex, and
+// once a writer has raised its flag, new readers wait for it, so that
+// readers can not starve writers.
+//
+// Sequence locks keep a small block of plain data, together with a
+// sequence number that is odd while a writer changes the data. Readers
+// copy the data without writing anything at all, and simply copy it
+// again if the sequence number shows that a writer got in the way.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Assumed cache line size, used to keep reader counters apart
+#define _GLFW_CACHE_LINE        64
+
+// Upper limit on the number of reader counters in a lock
+#define _GLFW_RWLOCK_MAX_SLOTS  64
+
+// Number of times a blocked locker checks again before going to sleep
+#define _GLFW_RWLOCK_SPIN       100
+
+
+//========================================================================
+// Reader-writer lock
+//========================================================================
+
+typedef struct {
+    volatile int  count;        // Readers in, minus readers out
+    char          pad[ _GLFW_CACHE_LINE - sizeof(int) ];
+} _GLFWreaderslot;
+
+typedef struct {
+    volatile int     writing;     // Non-zero while a writer holds or wants
+                                  // the lock
+    volatile int     readWaiters; // Readers sleeping until writing is zero
+    volatile int     drained;     // Bumped by readers leaving while a
+                                  // writer waits for them
+    int              spinLimit;
+    GLFWmutex        writers;
+    unsigned int     mask;
+    _GLFWreaderslot  *slots;
+} _GLFWrwlock;
+
+
+//========================================================================
+// Sequence lock
+//========================================================================
+
+typedef struct {
+    volatile int  seq;          // Odd while the data is being written
+    volatile int  waiters;      // Threads sleeping until seq changes
+    int           spinLimit;
+    int           size;
+    volatile int  *data;
+} _GLFWseqlock;
+
+
+//========================================================================
+// Return the reader counter used by the calling thread
+//========================================================================
+
+static volatile int * ReaderSlot( _GLFWrwlock *rw )
+{
+    int          local;
+    unsigned int hash;
+
+    // Thread stacks lie far apart, so the address of a local variable
+    // (at a granularity coarser than most call chains) tells threads
+    // apart without any thread local storage
+    hash = (unsigned int) ((size_t) &local >> 16);
+    hash *= 2654435761U;
+
+    return &rw->slots[ (hash >> 16) & rw->mask ].count;
+}
+
+
+//========================================================================
+// Return the number of readers holding a reader-writer lock
+//========================================================================
+
+static int CountReaders( _GLFWrwlock *rw )
+{
+    unsigned int i;
+    int          count = 0;
+
+    for( i = 0;  i <= rw->mask;  i ++ )
+    {
+        count += _glfwAtomicLoad( &rw->slots[ i ].count );
+    }
+
+    return count;
+}
+
+
+//========================================================================
+// Leave a reader-writer lock as a reader, waking a writer waiting for
+// the last reader to leave
+//========================================================================
+
+static void LeaveReader( _GLFWrwlock *rw, volatile int *slot )
+{
+    // The add is a full barrier, so a writer that raised its flag before
+    // we left either sees us leave when it counts, or is seen by us here
+    (void) _glfwAtomicAdd( slot, -1 );
+
+    if( _glfwAtomicLoad( &rw->writing ) )
+    {
+        (void) _glfwAtomicAdd( &rw->drained, 1 );
+        _glfwPlatformWakeAddress( &rw->drained, 1 );
+    }
+}
+
+
+//========================================================================
+// Wait for a sequence lock to leave the odd (writing) sequence number
+// that was last seen
+//========================================================================
+
+static void WaitSequence( _GLFWseqlock *sl, int seq, int *spins )
+{
+    if( *spins < sl->spinLimit )
+    {
+        (*spins) ++;
+        _glfwAtomicPause();
+        return;
+    }
+
+    (void) _glfwAtomicAdd( &sl->waiters, 1 );
+    _glfwPlatformWaitAddress( &sl->seq, seq, GLFW_INFINITY );
+    (void) _glfwAtomicAdd( &sl->waiters, -1 );
+}
+
+
+
+//************************************************************************
+//****                     GLFW user functions                        ****
+//************************************************************************
+
+//========================================================================
+// Create a reader-writer lock
+//========================================================================
+
+GLFWAPI GLFWrwlock GLFWAPIENTRY glfwCreateRWLock( void )
+{
+    _GLFWrwlock  *rw;
+    unsigned int count;
+    int          processors;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return NULL;
+    }
+
+    // One reader counter per processor is enough to keep readers apart
+    processors = _glfwPlatformGetNumberOfProcessors();
+    count = 1;
+    while( count < (unsigned int) processors &&
+           count < _GLFW_RWLOCK_MAX_SLOTS )
+    {
+        count <<= 1;
+    }
+
+    // The counters follow the lock, starting on a cache line boundary
+    rw = (_GLFWrwlock *) calloc( 1, sizeof(_GLFWrwlock) + _GLFW_CACHE_LINE +
+                                    count * sizeof(_GLFWreaderslot) );
+    if( rw == NULL )
+    {
+        return NULL;
+    }
+
+    rw->writers = _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+    if( rw->writers == NULL )
+    {
+        free( rw );
+        return NULL;
+    }
+
+    rw->mask  = count - 1;
+    rw->slots = (_GLFWreaderslot *)
+                (((size_t) (rw + 1) + _GLFW_CACHE_LINE - 1) &
+                 ~(size_t) (_GLFW_CACHE_LINE - 1));
+
+    // Spinning only helps if the thread we wait for can run meanwhile
+    rw->spinLimit = processors > 1 ? _GLFW_RWLOCK_SPIN : 0;
+
+    return (GLFWrwlock) rw;
+}
+
+
+//========================================================================
+// Destroy a reader-writer lock
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyRWLock( GLFWrwlock rwlock )
+{
+    _GLFWrwlock *rw = (_GLFWrwlock *) rwlock;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || rw == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformDestroyMutex( rw->writers );
+    free( rw );
+}
+
+
+//========================================================================
+// Lock a reader-writer lock for reading. Any number of threads may hold
+// the lock for reading at the same time, but not while a writer holds it.
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwLockRWLockRead( GLFWrwlock rwlock )
+{
+    _GLFWrwlock  *rw = (_GLFWrwlock *) rwlock;
+    volatile int *slot;
+    int          spins;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || rw == NULL )
+    {
+        return;
+    }
+
+    slot = ReaderSlot( rw );
+
+    for( ;; )
+    {
+        // The add is a full barrier, so either the writer sees us when it
+        // counts readers, or we see its flag here
+        (void) _glfwAtomicAdd( slot, 1 );
+        if( !_glfwAtomicLoad( &rw->writing ) )
+        {
+            return;
+        }
+
+        // A writer wants the lock; step aside until it is done
+        LeaveReader( rw, slot );
+
+        for( spins = 0;  spins < rw->spinLimit;  spins ++ )
+        {
+            if( !_glfwAtomicLoad( &rw->writing ) )
+            {
+                break;
+            }
+            _glfwAtomicPause();
+        }
+
+        if( _glfwAtomicLoad( &rw->writing ) )
+        {
+            (void) _glfwAtomicAdd( &rw->readWaiters, 1 );
+            _glfwPlatformWaitAddress( &rw->writing, 1, GLFW_INFINITY );
+            (void) _glfwAtomicAdd( &rw->readWaiters, -1 );
+        }
+    }
+}
+
+
+//========================================================================
+// Release a reader-writer lock held for reading
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwUnlockRWLockRead( GLFWrwlock rwlock )
+{
+    _GLFWrwlock *rw = (_GLFWrwlock *) rwlock;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || rw == NULL )
+    {
+        return;
+    }
+
+    LeaveReader( rw, ReaderSlot( rw ) );
+}
+
+
+//========================================================================
+// Lock a reader-writer lock for writing, waiting for all readers to leave
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwLockRWLockWrite( GLFWrwlock rwlock )
+{
+    _GLFWrwlock *rw = (_GLFWrwlock *) rwlock;
+    int         seq, spins;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || rw == NULL )
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex( rw->writers );
+
+    // Keep new readers out, then wait for the ones inside to leave
+    (void) _glfwAtomicExchange( &rw->writing, 1 );
+
+    for( spins = 0;  ;  spins ++ )
+    {
+        seq = _glfwAtomicLoad( &rw->drained );
+        if( CountReaders( rw ) == 0 )
+        {
+            break;
+        }
+
+        if( spins < rw->spinLimit )
+        {
+            _glfwAtomicPause();
+        }
+        else
+        {
+            _glfwPlatformWaitAddress( &rw->drained, seq, GLFW_INFINITY );
+        }
+    }
+}
+
+
+//========================================================================
+// Release a reader-writer lock held for writing
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwUnlockRWLockWrite( GLFWrwlock rwlock )
+{
+    _GLFWrwlock *rw = (_GLFWrwlock *) rwlock;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || rw == NULL )
+    {
+        return;
+    }
+
+    // The exchange is a full barrier, so a reader that is about to sleep
+    // has either been counted here or will see the flag cleared
+    (void) _glfwAtomicExchange( &rw->writing, 0 );
+    if( _glfwAtomicLoad( &rw->readWaiters ) > 0 )
+    {
+        _glfwPlatformWakeAddress( &rw->writing, 0 );
+    }
+
+    _glfwPlatformUnlockMutex( rw->writers );
+}
+
+
+//========================================================================
+// Create a sequence lock protecting size bytes of data, initially zero
+//========================================================================
+
+GLFWAPI GLFWseqlock GLFWAPIENTRY glfwCreateSeqLock( int size )
+{
+    _GLFWseqlock *sl;
+    size_t       words;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || size < 1 )
+    {
+        return NULL;
+    }
+
+    sl = (_GLFWseqlock *) calloc( 1, sizeof(_GLFWseqlock) );
+    if( sl == NULL )
+    {
+        return NULL;
+    }
+
+    // The data is kept in whole words, which are read and written one
+    // atomic (but unordered) access at a time
+    words = ((size_t) size + sizeof(int) - 1) / sizeof(int);
+    sl->data = (volatile int *) calloc( words, sizeof(int) );
+    if( sl->data == NULL )
+    {
+        free( sl );
+        return NULL;
+    }
+
+    sl->size = size;
+    sl->spinLimit = _glfwPlatformGetNumberOfProcessors() > 1 ?
+                    _GLFW_RWLOCK_SPIN : 0;
+
+    return (GLFWseqlock) sl;
+}
+
+
+//========================================================================
+// Destroy a sequence lock
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroySeqLock( GLFWseqlock seqlock )
+{
+    _GLFWseqlock *sl = (_GLFWseqlock *) seqlock;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || sl == NULL )
+    {
+        return;
+    }
+
+    free( (void *) sl->data );
+    free( sl );
+}
+
+
+//========================================================================
+// Replace the data of a sequence lock with a copy of data. Writers take
+// turns; readers are never waited for.
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwWriteSeqLock( GLFWseqlock seqlock,
+                                            const void *data )
+{
+    _GLFWseqlock *sl = (_GLFWseqlock *) seqlock;
+    const char   *src = (const char *) data;
+    int          seq, spins = 0, i, word, count, tail;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || sl == NULL || data == NULL )
+    {
+        return;
+    }
+
+    // Make the sequence number odd; the compare-and-exchange is a full
+    // barrier, so none of the data is changed before readers can tell
+    for( ;; )
+    {
+        seq = _glfwAtomicLoad( &sl->seq );
+        if( !(seq & 1) )
+        {
+            if( _glfwAtomicCompareExchange( &sl->seq, seq, seq + 1 ) )
+            {
+                break;
+            }
+        }
+        else
+        {
+            WaitSequence( sl, seq, &spins );
+        }
+    }
+
+    count = sl->size / (int) sizeof(int);
+    tail  = sl->size % (int) sizeof(int);
+
+    for( i = 0;  i < count;  i ++ )
+    {
+        memcpy( &word, src + i * sizeof(int), sizeof(int) );
+        _glfwAtomicStoreRelaxed( &sl->data[ i ], word );
+    }
+
+    if( tail )
+    {
+        word = 0;
+        memcpy( &word, src + count * sizeof(int), tail );
+        _glfwAtomicStoreRelaxed( &sl->data[ count ], word );
+    }
+
+    // Publish the data with an even sequence number again
+    (void) _glfwAtomicExchange( &sl->seq, seq + 2 );
+    if( _glfwAtomicLoad( &sl->waiters ) > 0 )
+    {
+        _glfwPlatformWakeAddress( &sl->seq, 0 );
+    }
+}
+
+
+//========================================================================
+// Copy the data of a sequence lock into data, as left by a single write
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwReadSeqLock( GLFWseqlock seqlock, void *data )
+{
+    _GLFWseqlock *sl = (_GLFWseqlock *) seqlock;
+    char         *dst = (char *) data;
+    int          seq, spins = 0, i, word, count, tail;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || sl == NULL || data == NULL )
+    {
+        return;
+    }
+
+    count = sl->size / (int) sizeof(int);
+    tail  = sl->size % (int) sizeof(int);
+
+    for( ;; )
+    {
+        seq = _glfwAtomicLoad( &sl->seq );
+        if( seq & 1 )
+        {
+            WaitSequence( sl, seq, &spins );
+            continue;
+        }
+
+        for( i = 0;  i < count;  i ++ )
+        {
+            word = _glfwAtomicLoadRelaxed( &sl->data[ i ] );
+            memcpy( dst + i * sizeof(int), &word, sizeof(int) );
+        }
+
+        if( tail )
+        {
+            word = _glfwAtomicLoadRelaxed( &sl->data[ count ] );
+            memcpy( dst + count * sizeof(int), &word, tail );
+        }
+
+        // The copy is good if no writer started while we made it
+        _glfwAtomicFenceAcquire();
+        if( _glfwAtomicLoadRelaxed( &sl->seq ) == seq )
+        {
+            return;
+        }
+    }
+}
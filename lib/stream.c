@@ -29,10 +29,27 @@
 //========================================================================
 
 #define _CRT_SECURE_NO_WARNINGS
+#define _FILE_OFFSET_BITS 64
 
 #include "internal.h"
 
 
+// Use 64-bit file positions wherever the C library provides them
+#if defined( _MSC_VER )
+ #define _glfw_fseek _fseeki64
+ #define _glfw_ftell _ftelli64
+#elif defined( __LCC__ ) || defined( __WATCOMC__ )
+ #define _glfw_fseek fseek
+ #define _glfw_ftell ftell
+#elif defined( _WIN32 )
+ #define _glfw_fseek fseeko64
+ #define _glfw_ftell ftello64
+#else
+ #define _glfw_fseek fseeko
+ #define _glfw_ftell ftello
+#endif
+
+
 //========================================================================
 // Opens a GLFW stream with a file
 //========================================================================
@@ -41,6 +58,12 @@ int _glfwOpenFileStream( _GLFWstream *stream, const char* name, const char* mode
 {
     memset( stream, 0, sizeof(_GLFWstream) );
 
+    // Names of the form "pack:<entry name>" refer to mounted packs
+    if( strncmp( name, "pack:", 5 ) == 0 )
+    {
+        return _glfwOpenPackStream( stream, name + 5 );
+    }
+
     stream->file = fopen( name, mode );
     if( stream->file == NULL )
     {
@@ -55,7 +78,7 @@ int _glfwOpenFileStream( _GLFWstream *stream, const char* name, const char* mode
 // Opens a GLFW stream with a memory block
 //========================================================================
 
-int _glfwOpenBufferStream( _GLFWstream *stream, void *data, long size )
+int _glfwOpenBufferStream( _GLFWstream *stream, void *data, _GLFWoffset size )
 {
     memset( stream, 0, sizeof(_GLFWstream) );
 
@@ -66,14 +89,43 @@ int _glfwOpenBufferStream( _GLFWstream *stream, void *data, long size )
 
 
 //========================================================================
-// Reads data from a GLFW stream
+// Opens a GLFW stream with user supplied I/O functions
+//========================================================================
+
+int _glfwOpenUserStream( _GLFWstream *stream, const GLFWstreamfuns *funs,
+                         void *user )
+{
+    memset( stream, 0, sizeof(_GLFWstream) );
+
+    if( funs == NULL || funs->Read == NULL || funs->Seek == NULL ||
+        funs->Tell == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    stream->funs = funs;
+    stream->user = user;
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Reads data from the underlying file, memory block or user stream
 //========================================================================
 
-long _glfwReadStream( _GLFWstream *stream, void *data, long size )
+static size_t ReadRawStream( _GLFWstream *stream, void *data, size_t size )
 {
+    long count;
+
+    if( stream->funs != NULL )
+    {
+        count = stream->funs->Read( stream->user, data, (long) size );
+        return count > 0 ? (size_t) count : 0;
+    }
+
     if( stream->file != NULL )
     {
-        return (long) fread( data, 1, size, stream->file );
+        return fread( data, 1, size, stream->file );
     }
 
     if( stream->data != NULL )
@@ -85,9 +137,9 @@ long _glfwReadStream( _GLFWstream *stream, void *data, long size )
         }
 
         // Clamp read size to available data
-        if( stream->position + size > stream->size )
+        if( (_GLFWoffset) size > stream->size - stream->position )
         {
-            size = stream->size - stream->position;
+            size = (size_t) (stream->size - stream->position);
         }
 
         // Perform data read
@@ -101,14 +153,20 @@ long _glfwReadStream( _GLFWstream *stream, void *data, long size )
 
 
 //========================================================================
-// Returns the current position of a GLFW stream
+// Returns the current position of the underlying file, memory block or
+// user stream
 //========================================================================
 
-long _glfwTellStream( _GLFWstream *stream )
+static _GLFWoffset TellRawStream( _GLFWstream *stream )
 {
+    if( stream->funs != NULL )
+    {
+        return (_GLFWoffset) stream->funs->Tell( stream->user );
+    }
+
     if( stream->file != NULL )
     {
-        return ftell( stream->file );
+        return (_GLFWoffset) _glfw_ftell( stream->file );
     }
 
     if( stream->data != NULL )
@@ -121,16 +179,23 @@ long _glfwTellStream( _GLFWstream *stream )
 
 
 //========================================================================
-// Sets the current position of a GLFW stream
+// Sets the current position of the underlying file, memory block or user
+// stream
 //========================================================================
 
-int _glfwSeekStream( _GLFWstream *stream, long offset, int whence )
+static int SeekRawStream( _GLFWstream *stream, _GLFWoffset offset,
+                          int whence )
 {
-    long position;
+    _GLFWoffset position;
+
+    if( stream->funs != NULL )
+    {
+        return stream->funs->Seek( stream->user, (long long) offset, whence );
+    }
 
     if( stream->file != NULL )
     {
-        if( fseek( stream->file, offset, whence ) != 0 )
+        if( _glfw_fseek( stream->file, offset, whence ) != 0 )
         {
             return GL_FALSE;
         }
@@ -177,18 +242,864 @@ int _glfwSeekStream( _GLFWstream *stream, long offset, int whence )
 }
 
 
+//========================================================================
+// Deflate (RFC 1951) decompression, used for gzip compressed streams.
+// Data is decompressed into a 64 KB ring buffer, which holds both the
+// 32 KB of history that matches may refer to and the data that has not
+// yet been read.
+//========================================================================
+
+#define _GLFW_INFLATE_WINDOW    65536
+#define _GLFW_INFLATE_HISTORY   32768
+#define _GLFW_INFLATE_INPUT     16384
+#define _GLFW_INFLATE_FAST_BITS 10
+
+// Ring buffer index of a decompressed byte
+#define WINDOW_INDEX( x ) ((size_t) (x) & (_GLFW_INFLATE_WINDOW - 1))
+
+// Block states
+#define _GLFW_INFLATE_HEADER    0
+#define _GLFW_INFLATE_STORED    1
+#define _GLFW_INFLATE_HUFFMAN   2
+#define _GLFW_INFLATE_DONE      3
+#define _GLFW_INFLATE_ERROR     4
+
+typedef struct {
+    short          count[ 16 ];
+    short          symbol[ 288 ];
+
+    // Symbols of codes no longer than _GLFW_INFLATE_FAST_BITS, indexed by
+    // the (bit reversed) code, as (length << 9) | symbol
+    unsigned short fast[ 1 << _GLFW_INFLATE_FAST_BITS ];
+} _GLFWhuffman;
+
+struct _GLFWinflater_struct {
+    int            state;
+    int            final;
+    int            stored;
+
+    // Bit buffer and compressed input
+    unsigned long  bitbuf;
+    int            bitcnt;
+    unsigned char  input[ _GLFW_INFLATE_INPUT ];
+    int            inpos, inlen;
+
+    // Position of the deflate data in the underlying stream
+    _GLFWoffset    start;
+
+    // Number of bytes decompressed, and read by the user
+    _GLFWoffset    produced, consumed;
+
+    _GLFWhuffman   lencode, distcode;
+    unsigned char  window[ _GLFW_INFLATE_WINDOW ];
+};
+
+static const short lengthBase[ 29 ] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short lengthExtra[ 29 ] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short distBase[ 30 ] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const short distExtra[ 30 ] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+//========================================================================
+// Top up the bit buffer from the underlying stream (there may be fewer
+// bits than asked for at the end of the stream)
+//========================================================================
+
+static void FillBits( _GLFWstream *stream, _GLFWinflater *inf )
+{
+    while( inf->bitcnt <= 24 )
+    {
+        if( inf->inpos == inf->inlen )
+        {
+            inf->inlen = (int) ReadRawStream( stream, inf->input,
+                                              _GLFW_INFLATE_INPUT );
+            inf->inpos = 0;
+            if( inf->inlen == 0 )
+            {
+                return;
+            }
+        }
+
+        inf->bitbuf |= (unsigned long) inf->input[ inf->inpos ++ ] <<
+                       inf->bitcnt;
+        inf->bitcnt += 8;
+    }
+}
+
+
+//========================================================================
+// Read a number of bits (at most 16), or -1 at the end of the stream
+//========================================================================
+
+static int GetBits( _GLFWstream *stream, _GLFWinflater *inf, int count )
+{
+    int bits;
+
+    if( inf->bitcnt < count )
+    {
+        FillBits( stream, inf );
+        if( inf->bitcnt < count )
+        {
+            return -1;
+        }
+    }
+
+    bits = (int) (inf->bitbuf & ((1UL << count) - 1));
+    inf->bitbuf >>= count;
+    inf->bitcnt -= count;
+
+    return bits;
+}
+
+
+//========================================================================
+// Build a canonical Huffman decoding table from code lengths
+//========================================================================
+
+static int BuildHuffman( _GLFWhuffman *h, const unsigned char *lengths,
+                         int count )
+{
+    short offsets[ 16 ];
+    int i, len, left, code, rev, fill;
+
+    memset( h->count, 0, sizeof(h->count) );
+    memset( h->fast, 0, sizeof(h->fast) );
+
+    for( i = 0; i < count; i ++ )
+    {
+        h->count[ lengths[ i ] ] ++;
+    }
+    h->count[ 0 ] = 0;
+
+    // Refuse over-subscribed code sets (incomplete ones are allowed)
+    left = 1;
+    for( len = 1; len < 16; len ++ )
+    {
+        left <<= 1;
+        left -= h->count[ len ];
+        if( left < 0 )
+        {
+            return GL_FALSE;
+        }
+    }
+
+    offsets[ 1 ] = 0;
+    for( len = 1; len < 15; len ++ )
+    {
+        offsets[ len + 1 ] = offsets[ len ] + h->count[ len ];
+    }
+
+    for( i = 0; i < count; i ++ )
+    {
+        if( lengths[ i ] )
+        {
+            h->symbol[ offsets[ lengths[ i ] ] ++ ] = (short) i;
+        }
+    }
+
+    // Fill in the fast table, walking the codes in canonical order
+    code = 0;
+    i = 0;
+    for( len = 1; len <= _GLFW_INFLATE_FAST_BITS; len ++ )
+    {
+        for( left = 0; left < h->count[ len ]; left ++, i ++, code ++ )
+        {
+            // Codes are stored most significant bit first
+            rev = 0;
+            for( fill = 0; fill < len; fill ++ )
+            {
+                rev |= ((code >> fill) & 1) << (len - 1 - fill);
+            }
+
+            for( fill = rev; fill < (1 << _GLFW_INFLATE_FAST_BITS);
+                 fill += 1 << len )
+            {
+                h->fast[ fill ] = (unsigned short) ((len << 9) |
+                                                    h->symbol[ i ]);
+            }
+        }
+        code <<= 1;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Decode a Huffman coded symbol, or return -1 on error
+//========================================================================
+
+static int DecodeSymbol( _GLFWstream *stream, _GLFWinflater *inf,
+                         const _GLFWhuffman *h )
+{
+    unsigned long bits;
+    int entry, len, code, first, count, index;
+
+    if( inf->bitcnt < 15 )
+    {
+        FillBits( stream, inf );
+    }
+
+    entry = h->fast[ inf->bitbuf & ((1 << _GLFW_INFLATE_FAST_BITS) - 1) ];
+    if( entry )
+    {
+        len = entry >> 9;
+        if( len > inf->bitcnt )
+        {
+            return -1;
+        }
+        inf->bitbuf >>= len;
+        inf->bitcnt -= len;
+        return entry & 511;
+    }
+
+    // Longer codes are decoded one bit at a time
+    bits  = inf->bitbuf;
+    code  = 0;
+    first = 0;
+    index = 0;
+    for( len = 1; len < 16 && len <= inf->bitcnt; len ++ )
+    {
+        code |= (int) (bits & 1);
+        bits >>= 1;
+        count = h->count[ len ];
+        if( code - count < first )
+        {
+            inf->bitbuf >>= len;
+            inf->bitcnt -= len;
+            return h->symbol[ index + (code - first) ];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code  <<= 1;
+    }
+
+    return -1;
+}
+
+
+//========================================================================
+// Read the code length tables of a dynamic Huffman block
+//========================================================================
+
+static int ReadDynamicTables( _GLFWstream *stream, _GLFWinflater *inf )
+{
+    static const unsigned char order[ 19 ] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    unsigned char lengths[ 320 ];
+    int nlen, ndist, ncode, i, symbol, repeat, value;
+
+    nlen  = GetBits( stream, inf, 5 ) + 257;
+    ndist = GetBits( stream, inf, 5 ) + 1;
+    ncode = GetBits( stream, inf, 4 ) + 4;
+    if( nlen < 257 || nlen > 286 || ndist < 1 || ndist > 30 || ncode < 4 )
+    {
+        return GL_FALSE;
+    }
+
+    // Code lengths for the code length alphabet
+    memset( lengths, 0, 19 );
+    for( i = 0; i < ncode; i ++ )
+    {
+        value = GetBits( stream, inf, 3 );
+        if( value < 0 )
+        {
+            return GL_FALSE;
+        }
+        lengths[ order[ i ] ] = (unsigned char) value;
+    }
+    if( !BuildHuffman( &inf->lencode, lengths, 19 ) )
+    {
+        return GL_FALSE;
+    }
+
+    // Literal/length and distance code lengths
+    i = 0;
+    while( i < nlen + ndist )
+    {
+        symbol = DecodeSymbol( stream, inf, &inf->lencode );
+        if( symbol < 0 )
+        {
+            return GL_FALSE;
+        }
+
+        if( symbol < 16 )
+        {
+            lengths[ i ++ ] = (unsigned char) symbol;
+            continue;
+        }
+
+        if( symbol == 16 )
+        {
+            if( i == 0 )
+            {
+                return GL_FALSE;
+            }
+            value  = lengths[ i - 1 ];
+            repeat = GetBits( stream, inf, 2 );
+            repeat = repeat < 0 ? -1 : repeat + 3;
+        }
+        else if( symbol == 17 )
+        {
+            value  = 0;
+            repeat = GetBits( stream, inf, 3 );
+            repeat = repeat < 0 ? -1 : repeat + 3;
+        }
+        else
+        {
+            value  = 0;
+            repeat = GetBits( stream, inf, 7 );
+            repeat = repeat < 0 ? -1 : repeat + 11;
+        }
+
+        if( repeat < 0 || i + repeat > nlen + ndist )
+        {
+            return GL_FALSE;
+        }
+        while( repeat -- )
+        {
+            lengths[ i ++ ] = (unsigned char) value;
+        }
+    }
+
+    // There must be an end of block code
+    if( lengths[ 256 ] == 0 )
+    {
+        return GL_FALSE;
+    }
+
+    return BuildHuffman( &inf->lencode, lengths, nlen ) &&
+           BuildHuffman( &inf->distcode, lengths + nlen, ndist );
+}
+
+
+//========================================================================
+// Start a new deflate block
+//========================================================================
+
+static int ReadBlockHeader( _GLFWstream *stream, _GLFWinflater *inf )
+{
+    unsigned char lengths[ 288 ];
+    int type, len, nlen, i;
+
+    inf->final = GetBits( stream, inf, 1 );
+    type = GetBits( stream, inf, 2 );
+
+    if( type == 0 )
+    {
+        // Stored block; skip to a byte boundary
+        GetBits( stream, inf, inf->bitcnt & 7 );
+        len  = GetBits( stream, inf, 16 );
+        nlen = GetBits( stream, inf, 16 );
+        if( len < 0 || nlen < 0 || len != (~nlen & 0xffff) )
+        {
+            return GL_FALSE;
+        }
+        inf->stored = len;
+        inf->state  = _GLFW_INFLATE_STORED;
+        return GL_TRUE;
+    }
+
+    if( type == 1 )
+    {
+        // Fixed Huffman codes
+        for( i = 0; i < 144; i ++ )
+        {
+            lengths[ i ] = 8;
+        }
+        for( ; i < 256; i ++ )
+        {
+            lengths[ i ] = 9;
+        }
+        for( ; i < 280; i ++ )
+        {
+            lengths[ i ] = 7;
+        }
+        for( ; i < 288; i ++ )
+        {
+            lengths[ i ] = 8;
+        }
+        BuildHuffman( &inf->lencode, lengths, 288 );
+
+        for( i = 0; i < 30; i ++ )
+        {
+            lengths[ i ] = 5;
+        }
+        BuildHuffman( &inf->distcode, lengths, 30 );
+    }
+    else if( type != 2 || !ReadDynamicTables( stream, inf ) )
+    {
+        return GL_FALSE;
+    }
+
+    inf->state = _GLFW_INFLATE_HUFFMAN;
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Decompress until half the window holds unread data, or the stream ends
+//========================================================================
+
+static void Inflate( _GLFWstream *stream, _GLFWinflater *inf )
+{
+    int symbol, len, dist, extra, count;
+    size_t pos, out;
+
+    while( inf->produced - inf->consumed < _GLFW_INFLATE_HISTORY )
+    {
+        if( inf->state == _GLFW_INFLATE_HEADER )
+        {
+            if( !ReadBlockHeader( stream, inf ) )
+            {
+                inf->state = _GLFW_INFLATE_ERROR;
+            }
+        }
+        else if( inf->state == _GLFW_INFLATE_STORED )
+        {
+            if( inf->stored == 0 )
+            {
+                inf->state = inf->final ? _GLFW_INFLATE_DONE :
+                                          _GLFW_INFLATE_HEADER;
+                continue;
+            }
+
+            // The bit buffer is byte aligned here, and may still hold a
+            // few bytes of the block
+            if( inf->bitcnt )
+            {
+                inf->window[ WINDOW_INDEX( inf->produced ++ ) ] =
+                    (unsigned char) inf->bitbuf;
+                inf->bitbuf >>= 8;
+                inf->bitcnt -= 8;
+                inf->stored --;
+                continue;
+            }
+
+            if( inf->inpos == inf->inlen )
+            {
+                inf->inlen = (int) ReadRawStream( stream, inf->input,
+                                                  _GLFW_INFLATE_INPUT );
+                inf->inpos = 0;
+                if( inf->inlen == 0 )
+                {
+                    inf->state = _GLFW_INFLATE_ERROR;
+                    break;
+                }
+            }
+
+            // Copy as much as possible in one go
+            count = inf->inlen - inf->inpos;
+            if( count > inf->stored )
+            {
+                count = inf->stored;
+            }
+            pos = WINDOW_INDEX( inf->produced );
+            if( count > (int) (_GLFW_INFLATE_WINDOW - pos) )
+            {
+                count = (int) (_GLFW_INFLATE_WINDOW - pos);
+            }
+            memcpy( inf->window + pos, inf->input + inf->inpos, count );
+            inf->inpos    += count;
+            inf->produced += count;
+            inf->stored   -= count;
+        }
+        else if( inf->state == _GLFW_INFLATE_HUFFMAN )
+        {
+            symbol = DecodeSymbol( stream, inf, &inf->lencode );
+            if( symbol < 256 )
+            {
+                if( symbol < 0 )
+                {
+                    inf->state = _GLFW_INFLATE_ERROR;
+                    break;
+                }
+                inf->window[ WINDOW_INDEX( inf->produced ++ ) ] =
+                    (unsigned char) symbol;
+                continue;
+            }
+
+            if( symbol == 256 )
+            {
+                inf->state = inf->final ? _GLFW_INFLATE_DONE :
+                                          _GLFW_INFLATE_HEADER;
+                continue;
+            }
+
+            // Length/distance pair
+            symbol -= 257;
+            if( symbol >= 29 )
+            {
+                inf->state = _GLFW_INFLATE_ERROR;
+                break;
+            }
+            extra = GetBits( stream, inf, lengthExtra[ symbol ] );
+            len   = lengthBase[ symbol ] + extra;
+
+            symbol = DecodeSymbol( stream, inf, &inf->distcode );
+            if( extra < 0 || symbol < 0 || symbol >= 30 )
+            {
+                inf->state = _GLFW_INFLATE_ERROR;
+                break;
+            }
+            extra = GetBits( stream, inf, distExtra[ symbol ] );
+            dist  = distBase[ symbol ] + extra;
+            if( extra < 0 || dist > inf->produced )
+            {
+                inf->state = _GLFW_INFLATE_ERROR;
+                break;
+            }
+
+            pos = WINDOW_INDEX( inf->produced - dist );
+            out = WINDOW_INDEX( inf->produced );
+            inf->produced += len;
+            if( dist >= len && pos + len <= _GLFW_INFLATE_WINDOW &&
+                out + len <= _GLFW_INFLATE_WINDOW )
+            {
+                memcpy( inf->window + out, inf->window + pos, len );
+            }
+            else
+            {
+                // Overlapping or wrapping match
+                while( len -- )
+                {
+                    inf->window[ out ] = inf->window[ pos ];
+                    out = (out + 1) & (_GLFW_INFLATE_WINDOW - 1);
+                    pos = (pos + 1) & (_GLFW_INFLATE_WINDOW - 1);
+                }
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
+//========================================================================
+// Read (or skip, if data is NULL) decompressed data
+//========================================================================
+
+static size_t ReadInflatedStream( _GLFWstream *stream, unsigned char *data,
+                                  size_t size )
+{
+    _GLFWinflater *inf = stream->inflater;
+    size_t count, total, pos;
+
+    total = 0;
+    while( total < size )
+    {
+        if( inf->produced == inf->consumed )
+        {
+            Inflate( stream, inf );
+            if( inf->produced == inf->consumed )
+            {
+                break;
+            }
+        }
+
+        // Copy up to the end of the unread data or the ring buffer
+        pos   = WINDOW_INDEX( inf->consumed );
+        count = (size_t) (inf->produced - inf->consumed);
+        if( count > _GLFW_INFLATE_WINDOW - pos )
+        {
+            count = _GLFW_INFLATE_WINDOW - pos;
+        }
+        if( count > size - total )
+        {
+            count = size - total;
+        }
+
+        if( data != NULL )
+        {
+            memcpy( data + total, inf->window + pos, count );
+        }
+        inf->consumed += count;
+        total         += count;
+    }
+
+    return total;
+}
+
+
+//========================================================================
+// Restart decompression from the beginning of the deflate data
+//========================================================================
+
+static int RewindInflatedStream( _GLFWstream *stream )
+{
+    _GLFWinflater *inf = stream->inflater;
+
+    if( !SeekRawStream( stream, inf->start, SEEK_SET ) )
+    {
+        return GL_FALSE;
+    }
+
+    inf->state    = _GLFW_INFLATE_HEADER;
+    inf->bitbuf   = 0;
+    inf->bitcnt   = 0;
+    inf->inpos    = 0;
+    inf->inlen    = 0;
+    inf->produced = 0;
+    inf->consumed = 0;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Skip a zero terminated string in a gzip header
+//========================================================================
+
+static int SkipGzipString( _GLFWstream *stream )
+{
+    unsigned char c;
+
+    do
+    {
+        if( ReadRawStream( stream, &c, 1 ) != 1 )
+        {
+            return GL_FALSE;
+        }
+    }
+    while( c != 0 );
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// If a GLFW stream holds gzip compressed data, make all further reads
+// return the decompressed data. Returns GL_FALSE if the gzip header is
+// invalid.
+//========================================================================
+
+int _glfwDetectGzipStream( _GLFWstream *stream )
+{
+    unsigned char header[ 10 ];
+    _GLFWoffset start;
+    int flags, extra;
+
+    if( stream->inflater != NULL )
+    {
+        return GL_TRUE;
+    }
+
+    start = TellRawStream( stream );
+    if( ReadRawStream( stream, header, 10 ) != 10 ||
+        header[ 0 ] != 0x1f || header[ 1 ] != 0x8b )
+    {
+        // Not gzip compressed (or too short to be); read it as is
+        return SeekRawStream( stream, start, SEEK_SET );
+    }
+
+    // Only the deflate method exists
+    flags = header[ 3 ];
+    if( header[ 2 ] != 8 || (flags & 0xe0) )
+    {
+        return GL_FALSE;
+    }
+
+    // Skip optional extra field, file name, comment and header CRC
+    if( flags & 4 )
+    {
+        if( ReadRawStream( stream, header, 2 ) != 2 )
+        {
+            return GL_FALSE;
+        }
+        extra = header[ 0 ] | (header[ 1 ] << 8);
+        SeekRawStream( stream, extra, SEEK_CUR );
+    }
+    if( ((flags & 8) && !SkipGzipString( stream )) ||
+        ((flags & 16) && !SkipGzipString( stream )) )
+    {
+        return GL_FALSE;
+    }
+    if( flags & 2 )
+    {
+        SeekRawStream( stream, 2, SEEK_CUR );
+    }
+
+    stream->inflater = (_GLFWinflater *) malloc( sizeof(_GLFWinflater) );
+    if( stream->inflater == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    stream->inflater->start = TellRawStream( stream );
+    return RewindInflatedStream( stream );
+}
+
+
+//========================================================================
+// Reads data from a GLFW stream
+//========================================================================
+
+size_t _glfwReadStream( _GLFWstream *stream, void *data, size_t size )
+{
+    if( stream->inflater != NULL )
+    {
+        return ReadInflatedStream( stream, (unsigned char *) data, size );
+    }
+
+    return ReadRawStream( stream, data, size );
+}
+
+
+//========================================================================
+// Returns the current position of a GLFW stream
+//========================================================================
+
+_GLFWoffset _glfwTellStream( _GLFWstream *stream )
+{
+    if( stream->inflater != NULL )
+    {
+        return stream->inflater->consumed;
+    }
+
+    return TellRawStream( stream );
+}
+
+
+//========================================================================
+// Sets the current position of a GLFW stream
+//========================================================================
+
+int _glfwSeekStream( _GLFWstream *stream, _GLFWoffset offset, int whence )
+{
+    _GLFWoffset target;
+
+    if( stream->inflater == NULL )
+    {
+        return SeekRawStream( stream, offset, whence );
+    }
+
+    // Compressed streams are seeked by decompressing up to the target,
+    // starting over for backward seeks (the size is not known, so seeking
+    // relative to the end is not supported)
+    if( whence == SEEK_SET )
+    {
+        target = offset;
+    }
+    else if( whence == SEEK_CUR )
+    {
+        target = stream->inflater->consumed + offset;
+    }
+    else
+    {
+        return GL_FALSE;
+    }
+
+    if( target < 0 )
+    {
+        target = 0;
+    }
+
+    if( target < stream->inflater->consumed &&
+        !RewindInflatedStream( stream ) )
+    {
+        return GL_FALSE;
+    }
+
+    while( stream->inflater->consumed < target )
+    {
+        if( ReadInflatedStream( stream, NULL, (size_t)
+                (target - stream->inflater->consumed) ) == 0 )
+        {
+            break;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Returns a pointer to the next size bytes of a GLFW stream and skips
+// past them, without copying them. Returns NULL if the stream can not do
+// this, in which case the data must be read with _glfwReadStream. The
+// pointer is only valid until the next operation on the stream.
+//========================================================================
+
+const void *_glfwBorrowStream( _GLFWstream *stream, size_t size )
+{
+    const void *data;
+
+    // Decompressed data is never contiguous in memory
+    if( stream->inflater != NULL )
+    {
+        return NULL;
+    }
+
+    if( stream->funs != NULL )
+    {
+        if( stream->funs->Borrow == NULL )
+        {
+            return NULL;
+        }
+        return stream->funs->Borrow( stream->user, (long) size );
+    }
+
+    if( stream->data != NULL )
+    {
+        if( (_GLFWoffset) size > stream->size - stream->position )
+        {
+            return NULL;
+        }
+
+        data = (unsigned char*) stream->data + stream->position;
+        stream->position += size;
+        return data;
+    }
+
+    return NULL;
+}
+
+
 //========================================================================
 // Closes a GLFW stream
 //========================================================================
 
 void _glfwCloseStream( _GLFWstream *stream )
 {
+    if( stream->funs != NULL && stream->funs->Close != NULL )
+    {
+        stream->funs->Close( stream->user );
+    }
+
     if( stream->file != NULL )
     {
         fclose( stream->file );
     }
 
-    // Nothing to be done about (user allocated) memory blocks
+    if( stream->inflater != NULL )
+    {
+        free( stream->inflater );
+    }
+
+    // Memory blocks are only freed if they were allocated by GLFW
+    if( stream->freeData )
+    {
+        free( stream->data );
+    }
+
+    // Data read straight from a pack may have been the last thing keeping
+    // an unmounted pack mapped
+    if( stream->pack != NULL )
+    {
+        _glfwReleasePack( stream->pack );
+    }
 
     memset( stream, 0, sizeof(_GLFWstream) );
 }
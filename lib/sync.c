@@ -0,0 +1,356 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Any
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+//========================================================================
+// Description:
+//
+// Counting semaphores and reusable barriers, built directly on atomic
+// operations and address waits (futexes where available) rather than on
+// a mutex and a condition variable.
+//
+// A semaphore is a single count, taken with a compare-and-exchange and
+// given back with an add. A barrier counts down the threads still to
+// arrive, so arriving is a single add; the last thread to arrive resets
+// the count and bumps a generation number, which is what the others
+// wait on. Threads only make a system call to wake sleepers when there
+// are any.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Number of times a blocked waiter checks again before going to sleep
+#define _GLFW_SYNC_SPIN         100
+
+
+//========================================================================
+// Semaphore
+//========================================================================
+
+typedef struct {
+    volatile int  count;
+    volatile int  waiters;      // Threads sleeping until count is non-zero
+    int           spinLimit;
+} _GLFWsemaphore;
+
+
+//========================================================================
+// Barrier
+//========================================================================
+
+typedef struct {
+    volatile int  remaining;    // Threads still to arrive in this phase
+    volatile int  generation;   // Bumped by the last thread to arrive
+    volatile int  waiters;      // Threads sleeping until generation changes
+    int           count;
+    int           spinLimit;
+} _GLFWbarrier;
+
+
+//========================================================================
+// Take one from a semaphore, unless it is zero
+//========================================================================
+
+static int TakeSemaphore( _GLFWsemaphore *s )
+{
+    int count;
+
+    for( ;; )
+    {
+        count = _glfwAtomicLoad( &s->count );
+        if( count <= 0 )
+        {
+            return GL_FALSE;
+        }
+
+        if( _glfwAtomicCompareExchange( &s->count, count, count - 1 ) )
+        {
+            return GL_TRUE;
+        }
+    }
+}
+
+
+
+//************************************************************************
+//****                     GLFW user functions                        ****
+//************************************************************************
+
+//========================================================================
+// Create a counting semaphore with the given initial count
+//========================================================================
+
+GLFWAPI GLFWsemaphore GLFWAPIENTRY glfwCreateSemaphore( int count )
+{
+    _GLFWsemaphore *s;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || count < 0 )
+    {
+        return NULL;
+    }
+
+    s = (_GLFWsemaphore *) calloc( 1, sizeof(_GLFWsemaphore) );
+    if( s == NULL )
+    {
+        return NULL;
+    }
+
+    s->count = count;
+
+    // Spinning only helps if the thread we wait for can run meanwhile
+    s->spinLimit = _glfwPlatformGetNumberOfProcessors() > 1 ?
+                   _GLFW_SYNC_SPIN : 0;
+
+    return (GLFWsemaphore) s;
+}
+
+
+//========================================================================
+// Destroy a semaphore
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroySemaphore( GLFWsemaphore semaphore )
+{
+    _GLFWsemaphore *s = (_GLFWsemaphore *) semaphore;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || s == NULL )
+    {
+        return;
+    }
+
+    free( s );
+}
+
+
+//========================================================================
+// Add count to a semaphore, waking up to as many waiting threads
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwPostSemaphore( GLFWsemaphore semaphore,
+                                             int count )
+{
+    _GLFWsemaphore *s = (_GLFWsemaphore *) semaphore;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || s == NULL || count < 1 )
+    {
+        return;
+    }
+
+    // The add is a full barrier, so a waiter that is about to sleep has
+    // either been counted here or will see the new count
+    (void) _glfwAtomicAdd( &s->count, count );
+    if( _glfwAtomicLoad( &s->waiters ) > 0 )
+    {
+        _glfwPlatformWakeAddress( &s->count, count );
+    }
+}
+
+
+//========================================================================
+// Take one from a semaphore, waiting up to timeout seconds for it to
+// become non-zero. Returns GL_TRUE if the semaphore was taken.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwWaitSemaphore( GLFWsemaphore semaphore,
+                                            double timeout )
+{
+    _GLFWsemaphore *s = (_GLFWsemaphore *) semaphore;
+    double         deadline = 0.0, remaining = timeout;
+    int            spins, done;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || s == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // Do not bother with the clock unless we have to wait
+    if( TakeSemaphore( s ) )
+    {
+        return GL_TRUE;
+    }
+
+    if( timeout < GLFW_INFINITY )
+    {
+        deadline = _glfwPlatformGetTime() + timeout;
+    }
+
+    for( ;; )
+    {
+        for( spins = 0;  ;  spins ++ )
+        {
+            if( TakeSemaphore( s ) )
+            {
+                return GL_TRUE;
+            }
+
+            if( spins >= s->spinLimit )
+            {
+                break;
+            }
+            _glfwAtomicPause();
+        }
+
+        if( timeout < GLFW_INFINITY )
+        {
+            remaining = deadline - _glfwPlatformGetTime();
+            if( remaining <= 0.0 )
+            {
+                return GL_FALSE;
+            }
+        }
+
+        // Announce that we are going to sleep, then try once more, so
+        // that a post made after our last try is not missed
+        (void) _glfwAtomicAdd( &s->waiters, 1 );
+        done = TakeSemaphore( s );
+        if( !done )
+        {
+            _glfwPlatformWaitAddress( &s->count, 0, remaining );
+        }
+        (void) _glfwAtomicAdd( &s->waiters, -1 );
+
+        if( done )
+        {
+            return GL_TRUE;
+        }
+    }
+}
+
+
+//========================================================================
+// Create a barrier for the given number of threads
+//========================================================================
+
+GLFWAPI GLFWbarrier GLFWAPIENTRY glfwCreateBarrier( int count )
+{
+    _GLFWbarrier *b;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || count < 1 )
+    {
+        return NULL;
+    }
+
+    b = (_GLFWbarrier *) calloc( 1, sizeof(_GLFWbarrier) );
+    if( b == NULL )
+    {
+        return NULL;
+    }
+
+    b->count     = count;
+    b->remaining = count;
+    b->spinLimit = _glfwPlatformGetNumberOfProcessors() > 1 ?
+                   _GLFW_SYNC_SPIN : 0;
+
+    return (GLFWbarrier) b;
+}
+
+
+//========================================================================
+// Destroy a barrier
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwDestroyBarrier( GLFWbarrier barrier )
+{
+    _GLFWbarrier *b = (_GLFWbarrier *) barrier;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || b == NULL )
+    {
+        return;
+    }
+
+    free( b );
+}
+
+
+//========================================================================
+// Wait until all threads of a barrier have arrived. Returns GL_TRUE in
+// the last thread to arrive, and GL_FALSE in all others.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwWaitBarrier( GLFWbarrier barrier )
+{
+    _GLFWbarrier *b = (_GLFWbarrier *) barrier;
+    int          generation, spins;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || b == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // The generation must be read before arriving, as the last thread to
+    // arrive may bump it at any time after that
+    generation = _glfwAtomicLoad( &b->generation );
+
+    if( _glfwAtomicAdd( &b->remaining, -1 ) == 1 )
+    {
+        // We are the last to arrive; nobody touches the count until we
+        // start the next phase, so it can be reset before that
+        _glfwAtomicStoreRelaxed( &b->remaining, b->count );
+        (void) _glfwAtomicExchange( &b->generation, generation + 1 );
+
+        if( _glfwAtomicLoad( &b->waiters ) > 0 )
+        {
+            _glfwPlatformWakeAddress( &b->generation, 0 );
+        }
+
+        return GL_TRUE;
+    }
+
+    for( spins = 0;  spins < b->spinLimit;  spins ++ )
+    {
+        if( _glfwAtomicLoad( &b->generation ) != generation )
+        {
+            return GL_FALSE;
+        }
+        _glfwAtomicPause();
+    }
+
+    (void) _glfwAtomicAdd( &b->waiters, 1 );
+    while( _glfwAtomicLoad( &b->generation ) == generation )
+    {
+        _glfwPlatformWaitAddress( &b->generation, generation,
+                                  GLFW_INFINITY );
+    }
+    (void) _glfwAtomicAdd( &b->waiters, -1 );
+
+    return GL_FALSE;
+}
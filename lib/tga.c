@@ -96,7 +96,7 @@ typedef struct {
 static int ReadTGAHeader( _GLFWstream *s, _tga_header_t *h )
 {
     unsigned char buf[ 18 ];
-    int pos;
+    _GLFWoffset pos;
 
     // Read TGA file header from file
     pos = _glfwTellStream( s );
@@ -149,10 +149,11 @@ static int ReadTGAHeader( _GLFWstream *s, _tga_header_t *h )
 // Read Run-Length Encoded data
 //========================================================================
 
-static void ReadTGA_RLE( unsigned char *buf, int size, int bpp,
+static void ReadTGA_RLE( unsigned char *buf, size_t size, int bpp,
                          _GLFWstream *s )
 {
-    int repcount, bytes, k, n;
+    int repcount, k, n;
+    size_t bytes;
     unsigned char pixel[ 4 ];
     char c;
 
@@ -177,7 +178,7 @@ static void ReadTGA_RLE( unsigned char *buf, int size, int bpp,
         if( repcount & 128 )
         {
             _glfwReadStream( s, pixel, bpp );
-            for( n = 0; n < (repcount & 127) + 1; n ++ )
+            for( n = 0; n < (int) bytes / bpp; n ++ )
             {
                 for( k = 0; k < bpp; k ++ )
                 {
@@ -205,8 +206,9 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
 {
     _tga_header_t h;
     unsigned char *cmap, *pix, tmp, *src, *dst;
-    int cmapsize, pixsize, pixsize2;
-    int bpp, bpp2, k, m, n, swapx, swapy;
+    int cmapsize;
+    size_t pixsize, pixsize2, rowsize, count, i, m;
+    int bpp, bpp2, k, n, swapx, swapy;
 
     // Read TGA header
     if( !ReadTGAHeader( s, &h ) )
@@ -241,12 +243,14 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
         cmap = NULL;
     }
 
-    // Size of pixel data
-    pixsize = h.width * h.height * ((h.bitsperpixel + 7) / 8);
-
     // Bytes per pixel (pixel data - unexpanded)
     bpp = (h.bitsperpixel + 7) / 8;
 
+    // Size of pixel data (may well exceed the range of an int)
+    count   = (size_t) h.width * (size_t) h.height;
+    rowsize = (size_t) h.width * bpp;
+    pixsize = count * bpp;
+
     // Bytes per pixel (expanded pixels - not colormap indeces)
     if( cmap )
     {
@@ -259,7 +263,7 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
 
     // For colormaped images, the RGB/RGBA image data may use more memory
     // than the stored pixel data
-    pixsize2 = h.width * h.height * bpp2;
+    pixsize2 = count * bpp2;
 
     // Allocate memory for pixel data
     pix = (unsigned char *) malloc( pixsize2 );
@@ -310,19 +314,16 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
         (!swapy && (flags & GLFW_ORIGIN_UL_BIT)) )
     {
         src = pix;
-        dst = &pix[ (h.height-1)*h.width*bpp ];
+        dst = &pix[ (h.height-1)*rowsize ];
         for( n = 0; n < h.height/2; n ++ )
         {
-            for( m = 0; m < h.width ; m ++ )
+            for( i = 0; i < rowsize; i ++ )
             {
-                for( k = 0; k < bpp; k ++ )
-                {
-                    tmp     = *src;
-                    *src ++ = *dst;
-                    *dst ++ = tmp;
-                }
+                tmp     = *src;
+                *src ++ = *dst;
+                *dst ++ = tmp;
             }
-            dst -= 2*h.width*bpp;
+            dst -= 2*rowsize;
         }
     }
     if( swapx )
@@ -331,7 +332,7 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
         dst = &pix[ (h.width-1)*bpp ];
         for( n = 0; n < h.height; n ++ )
         {
-            for( m = 0; m < h.width/2 ; m ++ )
+            for( m = 0; m < (size_t) (h.width/2) ; m ++ )
             {
                 for( k = 0; k < bpp; k ++ )
                 {
@@ -342,7 +343,7 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
                 dst -= 2*bpp;
             }
             src += ((h.width+1)/2)*bpp;
-            dst += ((3*h.width+1)/2)*bpp;
+            dst += ((3*h.width)/2)*bpp;
         }
     }
 
@@ -361,9 +362,11 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
             }
         }
 
-        // Convert pixel data to RGB/RGBA data
-        for( m = h.width * h.height - 1; m >= 0; m -- )
+        // Convert pixel data to RGB/RGBA data (backwards, as the expanded
+        // pixels overwrite the indices)
+        for( i = count; i > 0; i -- )
         {
+            m = i - 1;
             n = pix[ m ];
             for( k = 0; k < bpp2; k ++ )
             {
@@ -381,7 +384,7 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
         {
             src = pix;
             dst = &pix[ 2 ];
-            for( n = 0; n < h.height * h.width; n ++ )
+            for( i = 0; i < count; i ++ )
             {
                 tmp  = *src;
                 *src = *dst;
@@ -402,3 +405,513 @@ int _glfwReadTGA( _GLFWstream *s, GLFWimage *img, int flags )
     return 1;
 }
 
+
+
+//========================================================================
+// Build the row index of a RLE image, so that any row can be decoded
+// without decoding the rows before it
+//========================================================================
+
+static int IndexTGARows( _GLFWtiles *t )
+{
+    unsigned char c, buf[ 128*4 ];
+    _GLFWoffset pos, pixels, rowstart;
+    int row, count, bytes;
+
+    t->rowOffset = (_GLFWoffset *) malloc( t->height * sizeof(_GLFWoffset) );
+    t->rowSkip   = (int *) malloc( t->height * sizeof(int) );
+    if( t->rowOffset == NULL || t->rowSkip == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // Walk through all packets once, noting the packet in which each row
+    // starts (packets may span row boundaries). The position is tracked
+    // by hand, as asking the stream for it may cost a system call.
+    pos    = t->dataStart;
+    pixels = 0;
+    row    = 0;
+    while( row < t->height )
+    {
+        if( _glfwReadStream( &t->stream, &c, 1 ) != 1 )
+        {
+            return GL_FALSE;
+        }
+        count = (c & 127) + 1;
+        bytes = (c & 128) ? t->bpp : count * t->bpp;
+
+        rowstart = (_GLFWoffset) row * t->width;
+        while( row < t->height && rowstart < pixels + count )
+        {
+            t->rowOffset[ row ] = pos;
+            t->rowSkip[ row ]   = (int) (rowstart - pixels);
+            row ++;
+            rowstart += t->width;
+        }
+
+        if( _glfwReadStream( &t->stream, buf, bytes ) != (size_t) bytes )
+        {
+            return GL_FALSE;
+        }
+        pos    += 1 + bytes;
+        pixels += count;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Decode the next count pixels of a RLE image into buf, continuing where
+// the previous call left off (pixels are skipped if buf is NULL)
+//========================================================================
+
+static int DecodeTGAPixels( _GLFWtiles *t, unsigned char *buf, int count )
+{
+    unsigned char c;
+    int n, k;
+
+    while( count > 0 )
+    {
+        // Start a new packet?
+        if( t->runCount == 0 )
+        {
+            if( _glfwReadStream( &t->stream, &c, 1 ) != 1 )
+            {
+                return GL_FALSE;
+            }
+            t->runCount = (c & 127) + 1;
+            t->runRaw   = !(c & 128);
+            if( !t->runRaw &&
+                _glfwReadStream( &t->stream, t->runPixel, t->bpp ) !=
+                (size_t) t->bpp )
+            {
+                return GL_FALSE;
+            }
+        }
+
+        n = t->runCount < count ? t->runCount : count;
+
+        if( t->runRaw )
+        {
+            if( buf )
+            {
+                if( _glfwReadStream( &t->stream, buf, (size_t) n * t->bpp ) !=
+                    (size_t) n * t->bpp )
+                {
+                    return GL_FALSE;
+                }
+                buf += n * t->bpp;
+            }
+            else
+            {
+                _glfwSeekStream( &t->stream, n * t->bpp, SEEK_CUR );
+            }
+        }
+        else if( buf )
+        {
+            for( k = 0; k < n * t->bpp; k ++ )
+            {
+                buf[ k ] = t->runPixel[ k % t->bpp ];
+            }
+            buf += n * t->bpp;
+        }
+
+        t->runCount -= n;
+        count       -= n;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Read pixels [first, first+count) of a stored row into the row buffer
+// (unexpanded), and return a pointer to the first of them
+//========================================================================
+
+static const unsigned char * ReadTGAStoredRow( _GLFWtiles *t, int row,
+                                               int first, int count )
+{
+    const unsigned char *data;
+
+    if( !t->rle )
+    {
+        // Uncompressed - seek straight to the first wanted pixel, and
+        // expand directly from the stream data if it can be borrowed
+        _glfwSeekStream( &t->stream, t->dataStart +
+                         ((_GLFWoffset) row * t->width + first) * t->bpp,
+                         SEEK_SET );
+        data = (const unsigned char *)
+               _glfwBorrowStream( &t->stream, (size_t) count * t->bpp );
+        if( data != NULL )
+        {
+            return data;
+        }
+        if( _glfwReadStream( &t->stream, t->row, (size_t) count * t->bpp ) !=
+            (size_t) count * t->bpp )
+        {
+            return NULL;
+        }
+        return t->row;
+    }
+
+    if( t->rowOffset )
+    {
+        // Indexed RLE - start at the packet holding the first pixel of the
+        // row, dropping the pixels belonging to the previous row
+        _glfwSeekStream( &t->stream, t->rowOffset[ row ], SEEK_SET );
+        t->runCount = 0;
+        if( !DecodeTGAPixels( t, NULL, t->rowSkip[ row ] + first ) ||
+            !DecodeTGAPixels( t, t->row, count ) )
+        {
+            return NULL;
+        }
+        return t->row;
+    }
+
+    // Sequential RLE - rows can only be read in stored order
+    if( row < t->nextRow )
+    {
+        return NULL;
+    }
+    for( ; t->nextRow < row; t->nextRow ++ )
+    {
+        if( !DecodeTGAPixels( t, NULL, t->width ) )
+        {
+            return NULL;
+        }
+    }
+    if( !DecodeTGAPixels( t, NULL, first ) ||
+        !DecodeTGAPixels( t, t->row, count ) ||
+        !DecodeTGAPixels( t, NULL, t->width - first - count ) )
+    {
+        return NULL;
+    }
+    t->nextRow ++;
+
+    return t->row;
+}
+
+
+//========================================================================
+// Prepare a TGA image for reading tiles from it. Unless random access is
+// requested, the rows of RLE images must be read in stored order (as
+// _glfwReadTGATile does for a single tile).
+//========================================================================
+
+int _glfwOpenTGATiles( _GLFWtiles *t, int flags, int random )
+{
+    _tga_header_t h;
+    unsigned char tmp;
+    int cmapsize, n;
+
+    t->cmap      = NULL;
+    t->rowOffset = NULL;
+    t->rowSkip   = NULL;
+    t->row       = NULL;
+    t->target    = NULL;
+    t->rle       = GL_FALSE;
+    t->nextRow   = 0;
+    t->runCount  = 0;
+
+    // Read TGA header
+    if( !ReadTGAHeader( &t->stream, &h ) )
+    {
+        return GL_FALSE;
+    }
+
+    t->width  = h.width;
+    t->height = h.height;
+    t->flags  = flags;
+    t->bpp    = (h.bitsperpixel + 7) / 8;
+    t->bpp2   = t->bpp;
+
+    // Read the colormap, and convert it to RGB/RGBA up front
+    cmapsize = (h.cmaptype == _TGA_CMAPTYPE_PRESENT ? 1 : 0) * h.cmaplen *
+               ((h.cmapentrysize+7) / 8);
+    if( cmapsize > 0 )
+    {
+        if( (h.cmapentrysize != 24 && h.cmapentrysize != 32) ||
+            h.cmaplen == 0 || h.cmaplen > 256 )
+        {
+            return GL_FALSE;
+        }
+
+        // Always allocate a full colormap, as indices are not checked
+        t->bpp2 = (h.cmapentrysize + 7) / 8;
+        t->cmap = (unsigned char *) calloc( 256, t->bpp2 );
+        if( t->cmap == NULL )
+        {
+            return GL_FALSE;
+        }
+        _glfwReadStream( &t->stream, t->cmap, cmapsize );
+
+        for( n = 0; n < h.cmaplen; n ++ )
+        {
+            tmp                      = t->cmap[ n*t->bpp2 ];
+            t->cmap[ n*t->bpp2 ]     = t->cmap[ n*t->bpp2 + 2 ];
+            t->cmap[ n*t->bpp2 + 2 ] = tmp;
+        }
+    }
+
+    switch( h._origin )
+    {
+    default:
+    case _TGA_ORIGIN_UL:
+        t->swapx = 0;
+        t->swapy = 1;
+        break;
+
+    case _TGA_ORIGIN_BL:
+        t->swapx = 0;
+        t->swapy = 0;
+        break;
+
+    case _TGA_ORIGIN_UR:
+        t->swapx = 1;
+        t->swapy = 1;
+        break;
+
+    case _TGA_ORIGIN_BR:
+        t->swapx = 1;
+        t->swapy = 0;
+        break;
+    }
+
+    t->row = (unsigned char *) malloc( (size_t) t->width * t->bpp );
+    if( t->row == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    t->dataStart = _glfwTellStream( &t->stream );
+
+    if( h.imagetype >= _TGA_IMAGETYPE_CMAP_RLE )
+    {
+        t->rle = GL_TRUE;
+        if( random )
+        {
+            return IndexTGARows( t );
+        }
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Expand stored pixels (colormap lookup and BGR/BGRA to RGB/RGBA), writing
+// them backwards if the image is mirrored
+//========================================================================
+
+static void ExpandTGAPixels( _GLFWtiles *t, const unsigned char *src,
+                             unsigned char *dst, int count )
+{
+    int m, k, step;
+
+    step = t->bpp2;
+    if( t->swapx )
+    {
+        dst += (count - 1) * t->bpp2;
+        step = -step;
+    }
+
+    for( m = 0; m < count; m ++ )
+    {
+        if( t->cmap )
+        {
+            for( k = 0; k < t->bpp2; k ++ )
+            {
+                dst[ k ] = t->cmap[ src[ 0 ] * t->bpp2 + k ];
+            }
+        }
+        else if( t->bpp2 >= 3 )
+        {
+            dst[ 0 ] = src[ 2 ];
+            dst[ 1 ] = src[ 1 ];
+            dst[ 2 ] = src[ 0 ];
+            if( t->bpp2 == 4 )
+            {
+                dst[ 3 ] = src[ 3 ];
+            }
+        }
+        else
+        {
+            dst[ 0 ] = src[ 0 ];
+        }
+        src += t->bpp;
+        dst += step;
+    }
+}
+
+
+//========================================================================
+// Read a rectangular tile of a TGA image. The tile position is given in
+// the same coordinate system as the image returned by _glfwReadTGA would
+// have, i.e. with the origin in the lower left corner unless
+// GLFW_ORIGIN_UL_BIT was given.
+//
+// If shift is non-zero, the tile is subsampled by 2^shift in both
+// directions while it is decoded, by averaging blocks of pixels (blocks
+// at the right and top edges may be partial).
+//
+// The pixels are written to t->target if it is set (it must be large
+// enough for the tile), and to a newly allocated buffer otherwise.
+//========================================================================
+
+int _glfwReadTGATile( _GLFWtiles *t, int x, int y, int width, int height,
+                      int shift, GLFWimage *img )
+{
+    unsigned char *pix, *dst, *line;
+    const unsigned char *src;
+    unsigned int *sum;
+    int n, m, k, row, first, flip, width2, height2, linesize;
+    int ty, block, rows, cols;
+
+    if( x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > t->width || y + height > t->height )
+    {
+        return GL_FALSE;
+    }
+
+    // Size of the resulting image
+    width2   = (width + (1 << shift) - 1) >> shift;
+    height2  = (height + (1 << shift) - 1) >> shift;
+    linesize = width2 * t->bpp2;
+
+    pix = t->target;
+    if( pix == NULL )
+    {
+        pix = (unsigned char *) malloc( (size_t) linesize * height2 );
+    }
+    if( pix == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    // When subsampling, full resolution rows are expanded into a line
+    // buffer and summed up per block
+    line = NULL;
+    sum  = NULL;
+    if( shift )
+    {
+        line = (unsigned char *) malloc( (size_t) width * t->bpp2 );
+        sum  = (unsigned int *) calloc( linesize, sizeof(unsigned int) );
+        if( line == NULL || sum == NULL )
+        {
+            free( line );
+            free( sum );
+            if( pix != t->target )
+            {
+                free( pix );
+            }
+            return GL_FALSE;
+        }
+    }
+
+    // Columns as stored in the file (mirrored if the origin is at the
+    // right edge)
+    first = t->swapx ? t->width - x - width : x;
+
+    // Are tile rows stored bottom-up relative to the requested origin?
+    flip = (t->swapy && !(t->flags & GLFW_ORIGIN_UL_BIT)) ||
+           (!t->swapy && (t->flags & GLFW_ORIGIN_UL_BIT));
+
+    // Visit the rows in stored order, so that RLE data is only decoded
+    // once
+    rows = 0;
+    for( n = 0; n < height; n ++ )
+    {
+        ty  = flip ? height - 1 - n : n;
+        row = flip ? t->height - 1 - (y + ty) : y + ty;
+
+        src = ReadTGAStoredRow( t, row, first, width );
+        if( src == NULL )
+        {
+            free( line );
+            free( sum );
+            if( pix != t->target )
+            {
+                free( pix );
+            }
+            return GL_FALSE;
+        }
+
+        if( !shift )
+        {
+            ExpandTGAPixels( t, src, &pix[ (size_t) ty * linesize ], width );
+            continue;
+        }
+
+        ExpandTGAPixels( t, src, line, width );
+        for( m = 0; m < width; m ++ )
+        {
+            for( k = 0; k < t->bpp2; k ++ )
+            {
+                sum[ (m >> shift) * t->bpp2 + k ] += line[ m * t->bpp2 + k ];
+            }
+        }
+
+        // Emit the output row once its block is complete
+        block = ty >> shift;
+        rows ++;
+        if( rows == (1 << shift) || rows == height - (block << shift) )
+        {
+            dst = &pix[ (size_t) block * linesize ];
+            for( m = 0; m < width2; m ++ )
+            {
+                cols = width - (m << shift);
+                if( cols > (1 << shift) )
+                {
+                    cols = 1 << shift;
+                }
+                for( k = 0; k < t->bpp2; k ++ )
+                {
+                    *dst ++ = (unsigned char)
+                              ((sum[ m * t->bpp2 + k ] + rows*cols/2) /
+                               (rows*cols));
+                    sum[ m * t->bpp2 + k ] = 0;
+                }
+            }
+            rows = 0;
+        }
+    }
+
+    free( line );
+    free( sum );
+
+    // Fill out GLFWimage struct (the Format field will be set by the
+    // caller)
+    img->Width         = width2;
+    img->Height        = height2;
+    img->BytesPerPixel = t->bpp2;
+    img->Data          = pix;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Free the tile reader state (but do not close the stream)
+//========================================================================
+
+void _glfwCloseTGATiles( _GLFWtiles *t )
+{
+    if( t->cmap )
+    {
+        free( t->cmap );
+    }
+    if( t->rowOffset )
+    {
+        free( t->rowOffset );
+    }
+    if( t->rowSkip )
+    {
+        free( t->rowSkip );
+    }
+    if( t->row )
+    {
+        free( t->row );
+    }
+}
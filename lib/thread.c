@@ -30,12 +30,28 @@
 
 #include "internal.h"
 
+#include <stddef.h>
+
 
 
 //************************************************************************
 //****                  GLFW internal functions                       ****
 //************************************************************************
 
+//========================================================================
+// Hash table of threads, indexed by GLFW thread ID. Thread IDs are handed
+// out sequentially, so the low bits spread them evenly over the buckets.
+// The main thread is not in the table (it is always _glfwThrd.First).
+// All access is protected by the thread critical section.
+//========================================================================
+
+#define _GLFW_THREAD_TABLE_SIZE 1024
+
+static _GLFWthread *_glfwThreadTable[ _GLFW_THREAD_TABLE_SIZE ];
+
+#define THREAD_BUCKET( ID ) ((ID) & (_GLFW_THREAD_TABLE_SIZE - 1))
+
+
 //========================================================================
 // Find pointer to thread with a matching ID
 //========================================================================
@@ -44,7 +60,17 @@ _GLFWthread * _glfwGetThreadPointer( int ID )
 {
     _GLFWthread *t;
 
-    for( t = &_glfwThrd.First; t != NULL; t = t->Next )
+    if( ID == _glfwThrd.First.ID )
+    {
+        return &_glfwThrd.First;
+    }
+    if( ID < 0 )
+    {
+        return NULL;
+    }
+
+    for( t = _glfwThreadTable[ THREAD_BUCKET( ID ) ]; t != NULL;
+         t = t->HashNext )
     {
         if( t->ID == ID )
         {
@@ -62,16 +88,21 @@ _GLFWthread * _glfwGetThreadPointer( int ID )
 
 void _glfwAppendThread( _GLFWthread * t )
 {
-    _GLFWthread *t_tmp;
+    _GLFWthread **bucket;
 
-    t_tmp = &_glfwThrd.First;
-    while( t_tmp->Next != NULL )
+    // The list order carries no meaning, so link the new thread in right
+    // after the main thread instead of walking to the end of the list
+    t->Previous = &_glfwThrd.First;
+    t->Next     = _glfwThrd.First.Next;
+    if( t->Next != NULL )
     {
-        t_tmp = t_tmp->Next;
+        t->Next->Previous = t;
     }
-    t_tmp->Next = t;
-    t->Previous = t_tmp;
-    t->Next     = NULL;
+    _glfwThrd.First.Next = t;
+
+    bucket = &_glfwThreadTable[ THREAD_BUCKET( t->ID ) ];
+    t->HashNext = *bucket;
+    *bucket = t;
 }
 
 
@@ -81,6 +112,8 @@ void _glfwAppendThread( _GLFWthread * t )
 
 void _glfwRemoveThread( _GLFWthread * t )
 {
+    _GLFWthread **link;
+
     if( t->Previous != NULL )
     {
         t->Previous->Next = t->Next;
@@ -89,10 +122,323 @@ void _glfwRemoveThread( _GLFWthread * t )
     {
         t->Next->Previous = t->Previous;
     }
+
+    for( link = &_glfwThreadTable[ THREAD_BUCKET( t->ID ) ]; *link != NULL;
+         link = &(*link)->HashNext )
+    {
+        if( *link == t )
+        {
+            *link = t->HashNext;
+            break;
+        }
+    }
+
     free( (void *) t );
 }
 
 
+//========================================================================
+// Make a copy of thread creation attributes, including the affinity list
+// and name, for a new thread to apply once it runs. The copy is a single
+// allocation, to be freed with free(). Returns NULL if attribs is NULL or
+// memory runs out.
+//========================================================================
+
+GLFWthreadattribs * _glfwCopyThreadAttribs( const GLFWthreadattribs *attribs )
+{
+    GLFWthreadattribs *copy;
+    size_t            size, affinitySize = 0, nameSize = 0;
+    char              *extra;
+
+    if( attribs == NULL )
+    {
+        return NULL;
+    }
+
+    if( attribs->Affinity != NULL && attribs->AffinityCount > 0 )
+    {
+        affinitySize = attribs->AffinityCount * sizeof(int);
+    }
+    if( attribs->Name != NULL )
+    {
+        nameSize = strlen( attribs->Name ) + 1;
+    }
+
+    size = sizeof(GLFWthreadattribs) + affinitySize + nameSize;
+    copy = (GLFWthreadattribs *) malloc( size );
+    if( copy == NULL )
+    {
+        return NULL;
+    }
+
+    *copy = *attribs;
+    extra = (char *) (copy + 1);
+
+    if( affinitySize )
+    {
+        memcpy( extra, attribs->Affinity, affinitySize );
+        copy->Affinity = (const int *) extra;
+        extra += affinitySize;
+    }
+    else
+    {
+        copy->Affinity = NULL;
+        copy->AffinityCount = 0;
+    }
+
+    if( nameSize )
+    {
+        memcpy( extra, attribs->Name, nameSize );
+        copy->Name = extra;
+    }
+
+    return copy;
+}
+
+
+//========================================================================
+// Number of processors worth using, as found by _glfwGetUsableProcessors
+//========================================================================
+
+static volatile int _glfwUsableProcessors = 0;
+
+
+//========================================================================
+// Replace the platform's keys in one field of a processor list (such as
+// the lowest numbered processor sharing a cache) with group indices
+// counting from zero, and return the number of groups
+//========================================================================
+
+static int NumberGroups( GLFWprocessor *processors, int count,
+                         size_t offset, int *keys )
+{
+    int i, j, groups = 0;
+
+#define FIELD( i ) (*(int *) ((char *) &processors[ i ] + offset))
+
+    for( i = 0;  i < count;  i ++ )
+    {
+        keys[ i ] = FIELD( i );
+
+        for( j = 0;  j < i;  j ++ )
+        {
+            if( keys[ j ] == keys[ i ] )
+            {
+                FIELD( i ) = FIELD( j );
+                break;
+            }
+        }
+
+        if( j == i )
+        {
+            FIELD( i ) = groups ++;
+        }
+    }
+
+#undef FIELD
+
+    return groups;
+}
+
+
+//========================================================================
+// Fill in a CPU topology, falling back to one core per processor if the
+// platform can not tell
+//========================================================================
+
+static int GetTopology( GLFWcputopology *topology )
+{
+    int *keys, i;
+
+    memset( topology, 0, sizeof(GLFWcputopology) );
+
+    if( !_glfwPlatformGetCPUTopology( topology ) )
+    {
+        topology->Count = _glfwPlatformGetNumberOfProcessors();
+        if( topology->Count < 1 )
+        {
+            topology->Count = 1;
+        }
+
+        topology->Processors = (GLFWprocessor *)
+            calloc( topology->Count, sizeof(GLFWprocessor) );
+        if( topology->Processors == NULL )
+        {
+            return GL_FALSE;
+        }
+
+        for( i = 0;  i < topology->Count;  i ++ )
+        {
+            topology->Processors[ i ].ID      = i;
+            topology->Processors[ i ].Core    = i;
+            topology->Processors[ i ].L2Group = i;
+        }
+    }
+
+    keys = (int *) malloc( topology->Count * sizeof(int) );
+    if( keys == NULL )
+    {
+        free( topology->Processors );
+        memset( topology, 0, sizeof(GLFWcputopology) );
+        return GL_FALSE;
+    }
+
+    topology->Cores    = NumberGroups( topology->Processors, topology->Count,
+                             offsetof( GLFWprocessor, Core ), keys );
+    topology->Packages = NumberGroups( topology->Processors, topology->Count,
+                             offsetof( GLFWprocessor, Package ), keys );
+    topology->Nodes    = NumberGroups( topology->Processors, topology->Count,
+                             offsetof( GLFWprocessor, Node ), keys );
+    topology->L2Groups = NumberGroups( topology->Processors, topology->Count,
+                             offsetof( GLFWprocessor, L2Group ), keys );
+    topology->L3Groups = NumberGroups( topology->Processors, topology->Count,
+                             offsetof( GLFWprocessor, L3Group ), keys );
+
+    free( keys );
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Return the number of processors the process can actually use, taking
+// its affinity mask and any CPU time quota into account. This is what
+// the library sizes its own worker threads by. The answer is looked up
+// once, as reading the topology is not cheap.
+//========================================================================
+
+int _glfwGetUsableProcessors( void )
+{
+    GLFWcputopology topology;
+    int             count;
+
+    count = _glfwAtomicLoadRelaxed( &_glfwUsableProcessors );
+    if( count > 0 )
+    {
+        return count;
+    }
+
+    if( GetTopology( &topology ) )
+    {
+        count = topology.Count;
+        if( topology.Quota > 0 && topology.Quota < count )
+        {
+            count = topology.Quota;
+        }
+        free( topology.Processors );
+    }
+    else
+    {
+        count = _glfwPlatformGetNumberOfProcessors();
+    }
+
+    if( count < 1 )
+    {
+        count = 1;
+    }
+
+    _glfwAtomicStoreRelaxed( &_glfwUsableProcessors, count );
+    return count;
+}
+
+
+//========================================================================
+// Claim the next item of a work set, or return -1 when all are claimed
+//========================================================================
+
+int _glfwClaimWorkItem( _GLFWworkset *work )
+{
+    int i;
+
+    i = _glfwAtomicAdd( &work->next, 1 );
+    return i < work->count ? i : -1;
+}
+
+
+//========================================================================
+// Flag that an item of a work set failed
+//========================================================================
+
+void _glfwFailWorkItem( _GLFWworkset *work )
+{
+    _glfwAtomicStore( &work->failed, GL_TRUE );
+}
+
+
+//========================================================================
+// Helper thread entry point for _glfwRunWorkset
+//========================================================================
+
+static void GLFWCALL WorksetThread( void *arg )
+{
+    _GLFWworkset *work = (_GLFWworkset *) arg;
+
+    work->worker( work );
+}
+
+
+//========================================================================
+// Run the worker of a work set on up to numthreads threads, the calling
+// thread included, and wait for all of them to return. The workers claim
+// items with _glfwClaimWorkItem until there are none left. If no helper
+// thread can be started, the calling thread does all the work. Returns
+// GL_FALSE if any item was flagged as failed.
+//
+// The helpers are plain threads rather than thread pool jobs, as callers
+// doing blocking reads want more of them than there are processors, and
+// as workers may take locks that a fiber must not hold while parked.
+// Every helper is joined before returning, so nothing outlives the call.
+//========================================================================
+
+int _glfwRunWorkset( _GLFWworkset *work, int numthreads )
+{
+    GLFWthread *threads;
+    int        i;
+
+    work->next   = 0;
+    work->failed = GL_FALSE;
+
+    if( numthreads > work->count )
+    {
+        numthreads = work->count;
+    }
+    numthreads --;
+
+    threads = NULL;
+    if( numthreads > 0 )
+    {
+        threads = (GLFWthread *) malloc( numthreads * sizeof(GLFWthread) );
+    }
+    if( threads == NULL )
+    {
+        numthreads = 0;
+    }
+
+    for( i = 0; i < numthreads; i ++ )
+    {
+        threads[ i ] = _glfwPlatformCreateThread( WorksetThread, work, NULL );
+        if( threads[ i ] < 0 )
+        {
+            break;
+        }
+    }
+    numthreads = i;
+
+    work->worker( work );
+
+    // Waiting joins each helper, which frees its stack
+    for( i = 0; i < numthreads; i ++ )
+    {
+        (void) _glfwPlatformWaitThread( threads[ i ], GLFW_WAIT );
+    }
+
+    if( threads )
+    {
+        free( threads );
+    }
+
+    return _glfwAtomicLoad( &work->failed ) ? GL_FALSE : GL_TRUE;
+}
+
 
 //************************************************************************
 //****                     GLFW user functions                        ****
@@ -112,7 +458,35 @@ GLFWAPI GLFWthread GLFWAPIENTRY glfwCreateThread( GLFWthreadfun fun,
     }
 
     // Return the GLFW thread ID
-    return _glfwPlatformCreateThread( fun, arg );
+    return _glfwPlatformCreateThread( fun, arg, NULL );
+}
+
+
+//========================================================================
+// Create a new thread with the given stack size, scheduling priority,
+// processor affinity and name. Attributes the system refuses to apply
+// (such as real-time scheduling without the privilege for it) are left
+// at their defaults.
+//========================================================================
+
+GLFWAPI GLFWthread GLFWAPIENTRY glfwCreateThreadEx( GLFWthreadfun fun,
+    void *arg, const GLFWthreadattribs *attribs )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return -1;
+    }
+
+    if( attribs != NULL &&
+        (attribs->StackSize < 0 || attribs->AffinityCount < 0 ||
+         (attribs->AffinityCount > 0 && attribs->Affinity == NULL)) )
+    {
+        return -1;
+    }
+
+    // Return the GLFW thread ID
+    return _glfwPlatformCreateThread( fun, arg, attribs );
 }
 
 
@@ -177,6 +551,54 @@ GLFWAPI GLFWthread GLFWAPIENTRY glfwGetThreadID( void )
 }
 
 
+//========================================================================
+// Return the processor time used by a thread so far, in seconds, or a
+// negative value if it can not be found
+//========================================================================
+
+GLFWAPI double GLFWAPIENTRY glfwGetThreadCPUTime( GLFWthread ID )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized || ID < 0 )
+    {
+        return -1.0;
+    }
+
+    return _glfwPlatformGetThreadCPUTime( ID );
+}
+
+
+//========================================================================
+// Get the number of voluntary and involuntary context switches of a
+// thread so far. Returns GL_TRUE if they could be found.
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwGetThreadContextSwitches( GLFWthread ID,
+                                                       int *voluntary,
+                                                       int *involuntary )
+{
+    int dummy1, dummy2;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized || ID < 0 )
+    {
+        return GL_FALSE;
+    }
+
+    // Either count may be left out
+    if( voluntary == NULL )
+    {
+        voluntary = &dummy1;
+    }
+    if( involuntary == NULL )
+    {
+        involuntary = &dummy2;
+    }
+
+    return _glfwPlatformGetThreadContextSwitches( ID, voluntary, involuntary );
+}
+
+
 //========================================================================
 // Create a mutual exclusion object
 //========================================================================
@@ -189,7 +611,28 @@ GLFWAPI GLFWmutex GLFWAPIENTRY glfwCreateMutex( void )
         return (GLFWmutex) 0;
     }
 
-    return _glfwPlatformCreateMutex();
+    return _glfwPlatformCreateMutex( GLFW_MUTEX_ADAPTIVE );
+}
+
+
+//========================================================================
+// Create a mutual exclusion object of the given kind
+//========================================================================
+
+GLFWAPI GLFWmutex GLFWAPIENTRY glfwCreateMutexEx( int mode )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return (GLFWmutex) 0;
+    }
+
+    if( mode != GLFW_MUTEX_ADAPTIVE && mode != GLFW_MUTEX_SYSTEM )
+    {
+        return (GLFWmutex) 0;
+    }
+
+    return _glfwPlatformCreateMutex( mode );
 }
 
 
@@ -205,6 +648,7 @@ GLFWAPI void GLFWAPIENTRY glfwDestroyMutex( GLFWmutex mutex )
         return;
     }
 
+    _glfwForgetLockStats( mutex );
     _glfwPlatformDestroyMutex( mutex );
 }
 
@@ -221,6 +665,12 @@ GLFWAPI void GLFWAPIENTRY glfwLockMutex( GLFWmutex mutex )
         return;
     }
 
+    if( _glfwLockProfiling )
+    {
+        _glfwProfileLockMutex( mutex );
+        return;
+    }
+
     _glfwPlatformLockMutex( mutex );
 }
 
@@ -269,6 +719,7 @@ GLFWAPI void GLFWAPIENTRY glfwDestroyCond( GLFWcond cond )
         return;
     }
 
+    _glfwForgetLockStats( cond );
     _glfwPlatformDestroyCond( cond );
 }
 
@@ -286,6 +737,49 @@ GLFWAPI void GLFWAPIENTRY glfwWaitCond( GLFWcond cond, GLFWmutex mutex,
         return;
     }
 
+    if( _glfwLockProfiling )
+    {
+        _glfwProfileWaitCond( cond, mutex, timeout );
+        return;
+    }
+
+    _glfwPlatformWaitCond( cond, mutex, timeout );
+}
+
+
+//========================================================================
+// Wait for a condition to be raised, or until the timer (as returned by
+// glfwGetTime) reaches the given time
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwWaitCondUntil( GLFWcond cond, GLFWmutex mutex,
+                                             double time )
+{
+    double timeout = GLFW_INFINITY;
+
+    // Initialized & valid condition variable and mutex?
+    if( !_glfwInitialized || !cond || !mutex )
+    {
+        return;
+    }
+
+    // The remaining time is taken as late as possible, so a waiter that
+    // loops on its condition keeps the same deadline across wake-ups
+    if( time < GLFW_INFINITY )
+    {
+        timeout = time - _glfwPlatformGetTime();
+        if( timeout < 0.0 )
+        {
+            timeout = 0.0;
+        }
+    }
+
+    if( _glfwLockProfiling )
+    {
+        _glfwProfileWaitCond( cond, mutex, timeout );
+        return;
+    }
+
     _glfwPlatformWaitCond( cond, mutex, timeout );
 }
 
@@ -339,3 +833,41 @@ GLFWAPI int GLFWAPIENTRY glfwGetNumberOfProcessors( void )
     return _glfwPlatformGetNumberOfProcessors();
 }
 
+
+//========================================================================
+// Get the layout of the processors the calling process may run on: which
+// of them share a core, a cache, a package or a memory node
+//========================================================================
+
+GLFWAPI int GLFWAPIENTRY glfwGetCPUTopology( GLFWcputopology *topology )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized || topology == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    return GetTopology( topology );
+}
+
+
+//========================================================================
+// Free the processor list of a CPU topology
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwFreeCPUTopology( GLFWcputopology *topology )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized || topology == NULL )
+    {
+        return;
+    }
+
+    if( topology->Processors != NULL )
+    {
+        free( topology->Processors );
+    }
+
+    memset( topology, 0, sizeof(GLFWcputopology) );
+}
+
@@ -31,6 +31,56 @@
 #include "internal.h"
 
 
+//************************************************************************
+//****                  GLFW internal functions                       ****
+//************************************************************************
+
+// Bounds, in microseconds, for how much earlier than the deadline a
+// precise sleep wakes up, to spin away the rest
+#define _GLFW_SLEEP_MARGIN_MIN     20
+#define _GLFW_SLEEP_MARGIN_MAX  16000
+
+// Recent worst oversleep of the system sleep, in microseconds. It rises
+// at once to a larger oversleep and decays slowly, so an occasional late
+// wake-up costs a little spinning rather than a missed deadline.
+static volatile int _glfwSleepMargin = 200;
+
+
+//========================================================================
+// Fold a measured oversleep into the sleep margin
+//========================================================================
+
+static void UpdateSleepMargin( double oversleep )
+{
+    int margin, sample;
+
+    margin = _glfwAtomicLoadRelaxed( &_glfwSleepMargin );
+
+    sample = oversleep > 0.0 ? (int) (oversleep * 1e6) : 0;
+    if( sample > margin )
+    {
+        margin = sample;
+    }
+    else
+    {
+        margin -= (margin - sample) / 16;
+    }
+
+    if( margin < _GLFW_SLEEP_MARGIN_MIN )
+    {
+        margin = _GLFW_SLEEP_MARGIN_MIN;
+    }
+    if( margin > _GLFW_SLEEP_MARGIN_MAX )
+    {
+        margin = _GLFW_SLEEP_MARGIN_MAX;
+    }
+
+    // Sleeping threads may race here, but any of their values will do
+    _glfwAtomicStoreRelaxed( &_glfwSleepMargin, margin );
+}
+
+
+
 //************************************************************************
 //****                    GLFW user functions                         ****
 //************************************************************************
@@ -82,3 +132,59 @@ GLFWAPI void GLFWAPIENTRY glfwSleep( double time )
     _glfwPlatformSleep( time );
 }
 
+
+//========================================================================
+// Put a thread to sleep until the timer reaches the given time, waking
+// up as close to it as possible
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwSleepUntil( double time )
+{
+    double now, wake;
+    int    state;
+
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return;
+    }
+
+    now = _glfwPlatformGetTime();
+
+    // Sleep until a margin before the deadline, with the system timer as
+    // precise as we can make it
+    wake = time - _glfwAtomicLoadRelaxed( &_glfwSleepMargin ) * 1e-6;
+    if( wake > now )
+    {
+        state = _glfwPlatformBeginPreciseSleep();
+        _glfwPlatformSleep( wake - now );
+        now = _glfwPlatformGetTime();
+        _glfwPlatformEndPreciseSleep( state );
+
+        UpdateSleepMargin( now - wake );
+    }
+
+    // Yield the processor until the deadline, so other threads can run
+    while( now < time )
+    {
+        _glfwPlatformSleep( 0.0 );
+        now = _glfwPlatformGetTime();
+    }
+}
+
+
+//========================================================================
+// Put a thread to sleep for a specified amount of time, waking up as
+// close to the end of it as possible
+//========================================================================
+
+GLFWAPI void GLFWAPIENTRY glfwSleepPrecise( double time )
+{
+    // Is GLFW initialized?
+    if( !_glfwInitialized )
+    {
+        return;
+    }
+
+    glfwSleepUntil( _glfwPlatformGetTime() + time );
+}
@@ -244,6 +244,8 @@ typedef MMRESULT (WINAPI * JOYGETDEVCAPSA_T) (UINT,LPJOYCAPSA,UINT);
 typedef MMRESULT (WINAPI * JOYGETPOS_T) (UINT,LPJOYINFO);
 typedef MMRESULT (WINAPI * JOYGETPOSEX_T) (UINT,LPJOYINFOEX);
 typedef DWORD (WINAPI * TIMEGETTIME_T) (void);
+typedef MMRESULT (WINAPI * TIMEBEGINPERIOD_T) (UINT);
+typedef MMRESULT (WINAPI * TIMEENDPERIOD_T) (UINT);
 #endif // _GLFW_NO_DLOAD_WINMM
 
 
@@ -268,11 +270,15 @@ typedef DWORD (WINAPI * TIMEGETTIME_T) (void);
 #define _glfw_joyGetPos     _glfwLibrary.Libs.joyGetPos
 #define _glfw_joyGetPosEx   _glfwLibrary.Libs.joyGetPosEx
 #define _glfw_timeGetTime   _glfwLibrary.Libs.timeGetTime
+#define _glfw_timeBeginPeriod _glfwLibrary.Libs.timeBeginPeriod
+#define _glfw_timeEndPeriod   _glfwLibrary.Libs.timeEndPeriod
 #else
 #define _glfw_joyGetDevCaps joyGetDevCapsA
 #define _glfw_joyGetPos     joyGetPos
 #define _glfw_joyGetPosEx   joyGetPosEx
 #define _glfw_timeGetTime   timeGetTime
+#define _glfw_timeBeginPeriod timeBeginPeriod
+#define _glfw_timeEndPeriod   timeEndPeriod
 #endif // _GLFW_NO_DLOAD_WINMM
 
 
@@ -458,6 +464,8 @@ GLFWGLOBAL struct {
       JOYGETPOS_T           joyGetPos;
       JOYGETPOSEX_T         joyGetPosEx;
       TIMEGETTIME_T         timeGetTime;
+      TIMEBEGINPERIOD_T     timeBeginPeriod;
+      TIMEENDPERIOD_T       timeEndPeriod;
 #endif // _GLFW_NO_DLOAD_WINMM
   } Libs;
 #endif
@@ -477,9 +485,13 @@ struct _GLFWthread_struct {
     // Pointer to previous and next threads in linked list
     _GLFWthread   *Previous, *Next;
 
+    // Next thread in the same thread table bucket
+    _GLFWthread   *HashNext;
+
     // GLFW user side thread information
     GLFWthread    ID;
     GLFWthreadfun Function;
+    void          *Arg;
 
 // ========= PLATFORM SPECIFIC PART ======================================
 
@@ -508,6 +520,12 @@ GLFWGLOBAL struct {
     // Critical section lock
     CRITICAL_SECTION CriticalSection;
 
+    // TLS slot holding the calling thread's GLFW ID plus one
+    DWORD            IDIndex;
+
+    // TLS slot holding the calling thread's internal data
+    DWORD            DataIndex;
+
 } _glfwThrd;
 
 
@@ -524,6 +542,54 @@ GLFWGLOBAL struct {
         LeaveCriticalSection( &_glfwThrd.CriticalSection );
 
 
+//========================================================================
+// Atomic operations (Interlocked functions, which both MSVC and MinGW
+// provide). The plain variants work on int sized variables and the 64
+// variants on long long variables; all of them are full barriers, except
+// for the relaxed load and store.
+//========================================================================
+
+#define _glfwAtomicLoad( p ) \
+        InterlockedCompareExchange( (volatile LONG *) (p), 0, 0 )
+#define _glfwAtomicLoadRelaxed( p )         (*(p))
+#define _glfwAtomicStore( p, v ) \
+        (void) InterlockedExchange( (volatile LONG *) (p), (LONG) (v) )
+#define _glfwAtomicStoreRelaxed( p, v )     (*(p) = (v))
+#define _glfwAtomicAdd( p, v ) \
+        InterlockedExchangeAdd( (volatile LONG *) (p), (LONG) (v) )
+#define _glfwAtomicExchange( p, v ) \
+        InterlockedExchange( (volatile LONG *) (p), (LONG) (v) )
+#define _glfwAtomicCompareExchange( p, e, d ) \
+        (InterlockedCompareExchange( (volatile LONG *) (p), (LONG) (d), \
+                                     (LONG) (e) ) == (LONG) (e))
+#define _glfwAtomicLoadPtr( p ) \
+        InterlockedCompareExchangePointer( (PVOID volatile *) (p), NULL, NULL )
+#define _glfwAtomicStorePtr( p, v ) \
+        (void) InterlockedExchangePointer( (PVOID volatile *) (p), (PVOID) (v) )
+#define _glfwAtomicCompareExchangePtr( p, e, d ) \
+        (InterlockedCompareExchangePointer( (PVOID volatile *) (p), \
+                                            (PVOID) (d), (PVOID) (e) ) == (PVOID) (e))
+#define _glfwAtomicExchangePtr( p, v ) \
+        InterlockedExchangePointer( (PVOID volatile *) (p), (PVOID) (v) )
+#define _glfwAtomicLoad64( p ) \
+        InterlockedCompareExchange64( (volatile LONGLONG *) (p), 0, 0 )
+#define _glfwAtomicStore64( p, v ) \
+        (void) InterlockedExchange64( (volatile LONGLONG *) (p), (LONGLONG) (v) )
+#define _glfwAtomicAdd64( p, v ) \
+        InterlockedExchangeAdd64( (volatile LONGLONG *) (p), (LONGLONG) (v) )
+#define _glfwAtomicExchange64( p, v ) \
+        InterlockedExchange64( (volatile LONGLONG *) (p), (LONGLONG) (v) )
+#define _glfwAtomicCompareExchange64( p, e, d ) \
+        (InterlockedCompareExchange64( (volatile LONGLONG *) (p), \
+                                       (LONGLONG) (d), (LONGLONG) (e) ) == (LONGLONG) (e))
+#define _glfwAtomicFence()                  MemoryBarrier()
+#define _glfwAtomicFenceAcquire()           MemoryBarrier()
+#define _glfwAtomicFenceRelease()           MemoryBarrier()
+
+// Spin-wait hint
+#define _glfwAtomicPause()                  YieldProcessor()
+
+
 //========================================================================
 // Various Windows version constants
 //========================================================================
@@ -544,6 +610,11 @@ GLFWGLOBAL struct {
 // Prototypes for platform specific internal functions
 //========================================================================
 
+// Threads
+void _glfwSetThreadID( GLFWthread ID );
+void _glfwInitAddressWaits( void );
+void _glfwTerminateAddressWaits( void );
+
 // Time
 void _glfwInitTimer( void );
 
@@ -0,0 +1,222 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    Win32/WGL
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+
+//************************************************************************
+//****               Platform implementation functions                ****
+//************************************************************************
+
+//========================================================================
+// Map a whole file into memory for reading
+//========================================================================
+
+void * _glfwPlatformMapFile( const char *name, _GLFWoffset *size )
+{
+    HANDLE file, mapping;
+    DWORD low, high;
+    void *data;
+
+    file = CreateFileA( name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE )
+    {
+        return NULL;
+    }
+
+    low = GetFileSize( file, &high );
+    if( (low == INVALID_FILE_SIZE && GetLastError() != NO_ERROR) ||
+        (low == 0 && high == 0) ||
+        (sizeof(size_t) < 8 && high != 0) )
+    {
+        CloseHandle( file );
+        return NULL;
+    }
+
+    mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    CloseHandle( file );
+    if( mapping == NULL )
+    {
+        return NULL;
+    }
+
+    // The view keeps the mapping alive after its handle is closed
+    data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( mapping );
+    if( data == NULL )
+    {
+        return NULL;
+    }
+
+    *size = ((_GLFWoffset) high << 32) | (_GLFWoffset) low;
+    return data;
+}
+
+
+//========================================================================
+// Unmap a file mapped with _glfwPlatformMapFile
+//========================================================================
+
+void _glfwPlatformUnmapFile( void *data, _GLFWoffset size )
+{
+    UnmapViewOfFile( data );
+}
+
+
+//========================================================================
+// Create a queue for reading whole files concurrently (not supported on
+// this platform, so image batches fall back on blocking reads)
+//========================================================================
+
+_GLFWfilequeue * _glfwPlatformOpenFileQueue( int depth )
+{
+    return NULL;
+}
+
+
+//========================================================================
+// Queue a whole file for reading
+//========================================================================
+
+int _glfwPlatformQueueFileRead( _GLFWfilequeue *queue, const char *name,
+                                int index )
+{
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Wait for any queued file to finish
+//========================================================================
+
+int _glfwPlatformWaitFileRead( _GLFWfilequeue *queue, int *index,
+                               void **data, _GLFWoffset *size )
+{
+    *index = -1;
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Destroy a file queue
+//========================================================================
+
+void _glfwPlatformCloseFileQueue( _GLFWfilequeue *queue )
+{
+}
+
+
+//========================================================================
+// Ask the system to start reading a file into the file cache (there is
+// no such hint on Windows, so only decoding prefetched images helps)
+//========================================================================
+
+void _glfwPlatformPrefetchFile( const char *name )
+{
+}
+
+
+//========================================================================
+// Create a block of memory that can be shared with other processes
+// through the returned handle (a file mapping handle, which only ever
+// uses the low 32 bits, even in 64-bit processes)
+//========================================================================
+
+void * _glfwPlatformCreateSharedMemory( size_t size, int *handle )
+{
+    HANDLE mapping;
+    void *data;
+
+    mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                  (DWORD) ((_GLFWoffset) size >> 32),
+                                  (DWORD) size, NULL );
+    if( mapping == NULL )
+    {
+        return NULL;
+    }
+
+    data = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size );
+    if( data == NULL )
+    {
+        CloseHandle( mapping );
+        return NULL;
+    }
+
+    *handle = (int) (INT_PTR) mapping;
+    return data;
+}
+
+
+//========================================================================
+// Map shared memory created by another process. The view is copy on
+// write, so it may be modified without affecting the other process
+//========================================================================
+
+void * _glfwPlatformMapSharedMemory( int handle, size_t *size )
+{
+    MEMORY_BASIC_INFORMATION info;
+    void *data;
+
+    data = MapViewOfFile( (HANDLE) (INT_PTR) handle, FILE_MAP_COPY, 0, 0, 0 );
+    if( data == NULL )
+    {
+        return NULL;
+    }
+
+    if( VirtualQuery( data, &info, sizeof(info) ) == 0 )
+    {
+        UnmapViewOfFile( data );
+        return NULL;
+    }
+
+    *size = info.RegionSize;
+    return data;
+}
+
+
+//========================================================================
+// Unmap shared memory
+//========================================================================
+
+void _glfwPlatformUnmapSharedMemory( void *data, size_t size )
+{
+    UnmapViewOfFile( data );
+}
+
+
+//========================================================================
+// Close a shared memory handle
+//========================================================================
+
+void _glfwPlatformCloseSharedMemory( int handle )
+{
+    CloseHandle( (HANDLE) (INT_PTR) handle );
+}
@@ -92,10 +92,16 @@ static int _glfwInitLibraries( void )
             GetProcAddress( _glfwLibrary.Libs.winmm, "joyGetPosEx" );
         _glfwLibrary.Libs.timeGetTime    = (TIMEGETTIME_T)
             GetProcAddress( _glfwLibrary.Libs.winmm, "timeGetTime" );
-        if( _glfwLibrary.Libs.joyGetDevCapsA == NULL ||
-            _glfwLibrary.Libs.joyGetPos      == NULL ||
-            _glfwLibrary.Libs.joyGetPosEx    == NULL ||
-            _glfwLibrary.Libs.timeGetTime    == NULL )
+        _glfwLibrary.Libs.timeBeginPeriod = (TIMEBEGINPERIOD_T)
+            GetProcAddress( _glfwLibrary.Libs.winmm, "timeBeginPeriod" );
+        _glfwLibrary.Libs.timeEndPeriod   = (TIMEENDPERIOD_T)
+            GetProcAddress( _glfwLibrary.Libs.winmm, "timeEndPeriod" );
+        if( _glfwLibrary.Libs.joyGetDevCapsA  == NULL ||
+            _glfwLibrary.Libs.joyGetPos       == NULL ||
+            _glfwLibrary.Libs.joyGetPosEx     == NULL ||
+            _glfwLibrary.Libs.timeGetTime     == NULL ||
+            _glfwLibrary.Libs.timeBeginPeriod == NULL ||
+            _glfwLibrary.Libs.timeEndPeriod   == NULL )
         {
             FreeLibrary( _glfwLibrary.Libs.winmm );
             _glfwLibrary.Libs.winmm = NULL;
@@ -157,6 +163,13 @@ static void _glfwInitThreads( void )
     _glfwThrd.First.WinID    = GetCurrentThreadId();
     _glfwThrd.First.Previous = NULL;
     _glfwThrd.First.Next     = NULL;
+
+    // Remember the main thread's ID for glfwGetThreadID
+    _glfwThrd.IDIndex = TlsAlloc();
+    _glfwThrd.DataIndex = TlsAlloc();
+    _glfwSetThreadID( _glfwThrd.First.ID );
+
+    _glfwInitAddressWaits();
 }
 
 
@@ -185,8 +198,8 @@ static void _glfwTerminateThreads( void )
             // Close thread handle
             CloseHandle( t->Handle );
 
-            // Free memory allocated for this thread
-            free( (void *) t );
+            // Remove thread from thread list and free its memory
+            _glfwRemoveThread( t );
         }
 
         // Select next thread in list
@@ -196,6 +209,12 @@ static void _glfwTerminateThreads( void )
     // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
 
+    // The main thread is no longer known to GLFW
+    TlsFree( _glfwThrd.IDIndex );
+    TlsFree( _glfwThrd.DataIndex );
+
+    _glfwTerminateAddressWaits();
+
     // Delete critical section handle
     DeleteCriticalSection( &_glfwThrd.CriticalSection );
 }
@@ -60,28 +60,80 @@ typedef struct {
 //************************************************************************
 
 //========================================================================
-// This is simply a "wrapper" for calling the user thread function.
+// Threads waiting on an address sleep on one of a small set of
+// condition variables, chosen by hashing the address
 //========================================================================
 
-DWORD WINAPI _glfwNewThread( LPVOID lpParam )
+#define _GLFW_WAIT_BUCKETS 16
+
+static struct {
+    CRITICAL_SECTION mutex;
+    GLFWcond         cond;
+} _glfwWaitBuckets[ _GLFW_WAIT_BUCKETS ];
+
+#define WAIT_BUCKET( address ) \
+    (&_glfwWaitBuckets[ ((size_t) (address) >> 2) % _GLFW_WAIT_BUCKETS ])
+
+
+//========================================================================
+// Create the address wait buckets
+//========================================================================
+
+void _glfwInitAddressWaits( void )
 {
-    GLFWthreadfun threadfun;
-    _GLFWthread   *t;
+    int i;
 
-    // Get pointer to thread information for current thread
-    t = _glfwGetThreadPointer( _glfwPlatformGetThreadID() );
-    if( t == NULL )
+    for( i = 0;  i < _GLFW_WAIT_BUCKETS;  i ++ )
     {
-        return 0;
+        InitializeCriticalSection( &_glfwWaitBuckets[ i ].mutex );
+        _glfwWaitBuckets[ i ].cond = _glfwPlatformCreateCond();
     }
+}
 
-    // Get user thread function pointer
-    threadfun = t->Function;
+
+//========================================================================
+// Destroy the address wait buckets
+//========================================================================
+
+void _glfwTerminateAddressWaits( void )
+{
+    int i;
+
+    for( i = 0;  i < _GLFW_WAIT_BUCKETS;  i ++ )
+    {
+        _glfwPlatformDestroyCond( _glfwWaitBuckets[ i ].cond );
+        DeleteCriticalSection( &_glfwWaitBuckets[ i ].mutex );
+    }
+}
+
+
+//========================================================================
+// Set the GLFW ID of the calling thread. The ID is stored offset by one,
+// so that the TLS slot's initial NULL value reads back as -1.
+//========================================================================
+
+void _glfwSetThreadID( GLFWthread ID )
+{
+    TlsSetValue( _glfwThrd.IDIndex, (LPVOID) (INT_PTR) (ID + 1) );
+}
+
+
+//========================================================================
+// This is simply a "wrapper" for calling the user thread function.
+//========================================================================
+
+DWORD WINAPI _glfwNewThread( LPVOID lpParam )
+{
+    _GLFWthread *t = (_GLFWthread *) lpParam;
+
+    // Publish our GLFW ID before any user code can ask for it
+    _glfwSetThreadID( t->ID );
 
     // Call the user thread function
-    threadfun( (void *) lpParam );
+    t->Function( t->Arg );
 
-    // Remove thread from thread list
+    // Remove thread from thread list (the creating thread holds the
+    // critical section until the thread has been appended)
     ENTER_THREAD_CRITICAL_SECTION
     _glfwRemoveThread( t );
     LEAVE_THREAD_CRITICAL_SECTION
@@ -92,6 +144,91 @@ DWORD WINAPI _glfwNewThread( LPVOID lpParam )
 
 
 
+//========================================================================
+// Apply thread creation attributes (other than the stack size) to a
+// suspended thread
+//========================================================================
+
+#ifndef STACK_SIZE_PARAM_IS_A_RESERVATION
+ #define STACK_SIZE_PARAM_IS_A_RESERVATION 0x00010000
+#endif
+
+typedef HRESULT (WINAPI * _GLFWsetthreaddescription)( HANDLE, const WCHAR * );
+
+static void ApplyThreadAttribs( HANDLE thread,
+                                const GLFWthreadattribs *attribs )
+{
+    _GLFWsetthreaddescription SetDescription;
+    DWORD_PTR mask = 0;
+    WCHAR     name[ 64 ];
+    int       i, cpu, priority;
+
+    if( attribs->AffinityCount > 0 )
+    {
+        // Only the processors of the thread's processor group can be named
+        for( i = 0;  i < attribs->AffinityCount;  i ++ )
+        {
+            cpu = attribs->Affinity[ i ];
+            if( cpu >= 0 && cpu < (int) (8 * sizeof(DWORD_PTR)) )
+            {
+                mask |= (DWORD_PTR) 1 << cpu;
+            }
+        }
+
+        if( mask )
+        {
+            (void) SetThreadAffinityMask( thread, mask );
+        }
+    }
+
+    // Map real-time scheduling and nice values to thread priorities
+    if( attribs->Realtime )
+    {
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    }
+    else if( attribs->Priority <= -15 )
+    {
+        priority = THREAD_PRIORITY_HIGHEST;
+    }
+    else if( attribs->Priority <= -5 )
+    {
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+    }
+    else if( attribs->Priority >= 15 )
+    {
+        priority = THREAD_PRIORITY_LOWEST;
+    }
+    else if( attribs->Priority >= 5 )
+    {
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    else
+    {
+        priority = THREAD_PRIORITY_NORMAL;
+    }
+
+    if( priority != THREAD_PRIORITY_NORMAL )
+    {
+        (void) SetThreadPriority( thread, priority );
+    }
+
+    // Thread descriptions are only available on Windows 10 and later
+    if( attribs->Name != NULL )
+    {
+        SetDescription = (_GLFWsetthreaddescription)
+            GetProcAddress( GetModuleHandleA( "kernel32.dll" ),
+                            "SetThreadDescription" );
+        if( SetDescription != NULL &&
+            MultiByteToWideChar( CP_UTF8, 0, attribs->Name, -1, name,
+                                 sizeof(name) / sizeof(WCHAR) ) > 0 )
+        {
+            (void) SetDescription( thread, name );
+        }
+    }
+}
+
+
+
 //************************************************************************
 //****                     GLFW user functions                        ****
 //************************************************************************
@@ -100,12 +237,13 @@ DWORD WINAPI _glfwNewThread( LPVOID lpParam )
 // Create a new thread
 //========================================================================
 
-GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
+GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg,
+                                      const GLFWthreadattribs *attribs )
 {
     GLFWthread  ID;
-    _GLFWthread *t, *t_tmp;
+    _GLFWthread *t;
     HANDLE      hThread;
-    DWORD       dwThreadId;
+    DWORD       dwThreadId, dwStackSize = 0, dwFlags = 0;
 
     // Enter critical section
     ENTER_THREAD_CRITICAL_SECTION
@@ -124,15 +262,27 @@ GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
 
     // Store thread information in the thread list
     t->Function = fun;
+    t->Arg      = arg;
     t->ID       = ID;
 
+    if( attribs != NULL )
+    {
+        // The thread is held until its attributes have been applied
+        dwFlags = CREATE_SUSPENDED;
+        if( attribs->StackSize > 0 )
+        {
+            dwStackSize = (DWORD) attribs->StackSize;
+            dwFlags |= STACK_SIZE_PARAM_IS_A_RESERVATION;
+        }
+    }
+
     // Create thread
     hThread = CreateThread(
         NULL,              // Default security attributes
-        0,                 // Default stack size (1 MB)
+        dwStackSize,       // Stack size (default is 1 MB)
         _glfwNewThread,    // Thread function (a wrapper function)
-        (LPVOID)arg,       // Argument to thread is the user argument
-        0,                 // Default creation flags
+        (LPVOID)t,         // Argument to thread is its own information
+        dwFlags,           // Creation flags
         &dwThreadId        // Returned thread identifier
     );
 
@@ -148,15 +298,14 @@ GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
     t->Handle = hThread;
     t->WinID  = dwThreadId;
 
-    // Append thread to thread list
-    t_tmp = &_glfwThrd.First;
-    while( t_tmp->Next != NULL )
+    if( attribs != NULL )
     {
-        t_tmp = t_tmp->Next;
+        ApplyThreadAttribs( hThread, attribs );
+        ResumeThread( hThread );
     }
-    t_tmp->Next = t;
-    t->Previous = t_tmp;
-    t->Next     = NULL;
+
+    // Append thread to thread list
+    _glfwAppendThread( t );
 
     // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
@@ -259,40 +408,93 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
 
 GLFWthread _glfwPlatformGetThreadID( void )
 {
-    _GLFWthread *t;
-    GLFWthread  ID = -1;
-    DWORD       WinID;
+    return (GLFWthread) ((INT_PTR) TlsGetValue( _glfwThrd.IDIndex ) - 1);
+}
 
-    // Get Windows thread ID
-    WinID = GetCurrentThreadId();
 
-    // Enter critical section (to avoid an inconsistent thread list)
+//========================================================================
+// Return the processor time used by a thread, in seconds, or a negative
+// value if it is not available
+//========================================================================
+
+double _glfwPlatformGetThreadCPUTime( GLFWthread ID )
+{
+    _GLFWthread *t;
+    HANDLE      handle;
+    FILETIME    creation, exit, kernel, user;
+    BOOL        result;
+
     ENTER_THREAD_CRITICAL_SECTION
 
-    // Loop through entire list of threads to find the matching Windows
-    // thread ID
-    for( t = &_glfwThrd.First; t != NULL; t = t->Next )
+    t = _glfwGetThreadPointer( ID );
+    if( t == NULL )
     {
-        if( t->WinID == WinID )
-        {
-            ID = t->ID;
-            break;
-        }
+        LEAVE_THREAD_CRITICAL_SECTION
+        return -1.0;
+    }
+
+    // The main thread's handle is the pseudo handle of whichever thread
+    // uses it, so other threads have to open a real one
+    handle = t->Handle;
+    if( t->WinID == GetCurrentThreadId() )
+    {
+        handle = GetCurrentThread();
+    }
+    else if( t == &_glfwThrd.First )
+    {
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0500
+        handle = OpenThread( THREAD_QUERY_INFORMATION, FALSE, t->WinID );
+#else
+        handle = NULL;
+#endif
+    }
+
+    // GetThreadTimes fails on Windows 9x
+    result = handle != NULL &&
+             GetThreadTimes( handle, &creation, &exit, &kernel, &user );
+
+    if( handle != NULL && handle != t->Handle &&
+        handle != GetCurrentThread() )
+    {
+        CloseHandle( handle );
     }
 
-    // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
 
-    // Return the found GLFW thread identifier
-    return ID;
+    if( !result )
+    {
+        return -1.0;
+    }
+
+    // Both times are in units of 100 ns
+    return ( (double) kernel.dwHighDateTime * 4294967296.0 +
+             (double) kernel.dwLowDateTime +
+             (double) user.dwHighDateTime * 4294967296.0 +
+             (double) user.dwLowDateTime ) * 1e-7;
+}
+
+
+//========================================================================
+// Get the number of voluntary and involuntary context switches of a
+// thread. Windows only counts context switches per thread through
+// undocumented interfaces, and does not tell the two kinds apart.
+//========================================================================
+
+int _glfwPlatformGetThreadContextSwitches( GLFWthread ID, int *voluntary,
+                                           int *involuntary )
+{
+    (void) ID;
+    *voluntary = *involuntary = 0;
+    return GL_FALSE;
 }
 
 
 //========================================================================
-// Create a mutual exclusion object
+// Create a mutual exclusion object. Adaptive mutexes are critical sections
+// that spin for a while before they sleep.
 //========================================================================
 
-GLFWmutex _glfwPlatformCreateMutex( void )
+GLFWmutex _glfwPlatformCreateMutex( int mode )
 {
     CRITICAL_SECTION *mutex;
 
@@ -304,7 +506,14 @@ GLFWmutex _glfwPlatformCreateMutex( void )
     }
 
     // Initialize mutex
-    InitializeCriticalSection( mutex );
+    if( mode == GLFW_MUTEX_ADAPTIVE )
+    {
+        (void) InitializeCriticalSectionAndSpinCount( mutex, 4000 );
+    }
+    else
+    {
+        InitializeCriticalSection( mutex );
+    }
 
     // Cast to GLFWmutex and return
     return (GLFWmutex) mutex;
@@ -345,6 +554,23 @@ void _glfwPlatformUnlockMutex( GLFWmutex mutex )
 }
 
 
+//========================================================================
+// Lock a mutex if it is free
+//========================================================================
+
+int _glfwPlatformTryLockMutex( GLFWmutex mutex )
+{
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0400
+    return TryEnterCriticalSection( (CRITICAL_SECTION *) mutex );
+#else
+    // Windows 9x cannot try a critical section, so report every lock as
+    // contended; lock profiling then still measures the waits
+    (void) mutex;
+    return GL_FALSE;
+#endif
+}
+
+
 //========================================================================
 // Create a new condition variable object
 //========================================================================
@@ -504,3 +730,341 @@ int _glfwPlatformGetNumberOfProcessors( void )
     return (int) si.dwNumberOfProcessors;
 }
 
+
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0501
+
+//========================================================================
+// Return the lowest numbered processor in an affinity mask
+//========================================================================
+
+static int LowestProcessor( ULONG_PTR mask )
+{
+    int cpu = 0;
+
+    while( mask && !(mask & 1) )
+    {
+        mask >>= 1;
+        cpu ++;
+    }
+
+    return cpu;
+}
+
+#endif
+
+
+//========================================================================
+// Get the processors the process may run on, and what they share. Groups
+// are identified by their lowest numbered member here; glfwGetCPUTopology
+// turns these into indices. Only the processor group the process runs in
+// (at most 64 processors) is seen.
+//========================================================================
+
+int _glfwPlatformGetCPUTopology( GLFWcputopology *topology )
+{
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0501
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *info;
+    DWORD_PTR     processMask, systemMask;
+    DWORD         size = 0;
+    ULONG_PTR     bit;
+    GLFWprocessor *p;
+    int           cpu, count = 0, entries, i;
+
+    if( !GetProcessAffinityMask( GetCurrentProcess(), &processMask,
+                                 &systemMask ) )
+    {
+        return GL_FALSE;
+    }
+
+    // The first call only asks for the size of the information
+    (void) GetLogicalProcessorInformation( NULL, &size );
+    if( size == 0 )
+    {
+        return GL_FALSE;
+    }
+
+    info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *) malloc( size );
+    if( info == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    if( !GetLogicalProcessorInformation( info, &size ) )
+    {
+        free( info );
+        return GL_FALSE;
+    }
+    entries = (int) (size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+    for( cpu = 0;  cpu < (int) (8 * sizeof(DWORD_PTR));  cpu ++ )
+    {
+        if( processMask & ((DWORD_PTR) 1 << cpu) )
+        {
+            count ++;
+        }
+    }
+
+    topology->Processors = (GLFWprocessor *)
+        calloc( count, sizeof(GLFWprocessor) );
+    if( topology->Processors == NULL || count == 0 )
+    {
+        free( topology->Processors );
+        free( info );
+        return GL_FALSE;
+    }
+
+    p = topology->Processors;
+    for( cpu = 0;  cpu < (int) (8 * sizeof(DWORD_PTR));  cpu ++ )
+    {
+        bit = (ULONG_PTR) 1 << cpu;
+        if( !(processMask & bit) )
+        {
+            continue;
+        }
+
+        p->ID      = cpu;
+        p->Core    = cpu;
+        p->L2Group = -1;
+        p->L3Group = -1;
+
+        for( i = 0;  i < entries;  i ++ )
+        {
+            if( !(info[ i ].ProcessorMask & bit) )
+            {
+                continue;
+            }
+
+            switch( info[ i ].Relationship )
+            {
+                case RelationProcessorCore:
+                    p->Core = LowestProcessor( info[ i ].ProcessorMask );
+                    break;
+
+                case RelationProcessorPackage:
+                    p->Package = LowestProcessor( info[ i ].ProcessorMask );
+                    break;
+
+                case RelationNumaNode:
+                    p->Node = (int) info[ i ].NumaNode.NodeNumber;
+                    break;
+
+                case RelationCache:
+                    if( info[ i ].Cache.Type == CacheInstruction )
+                    {
+                        break;
+                    }
+                    if( info[ i ].Cache.Level == 2 )
+                    {
+                        p->L2Group = LowestProcessor( info[ i ].ProcessorMask );
+                    }
+                    else if( info[ i ].Cache.Level == 3 )
+                    {
+                        p->L3Group = LowestProcessor( info[ i ].ProcessorMask );
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        // Without cache information, assume a private L2 per core and a
+        // shared L3 per package
+        if( p->L2Group < 0 )
+        {
+            p->L2Group = p->Core;
+        }
+        if( p->L3Group < 0 )
+        {
+            p->L3Group = -1 - p->Package;
+        }
+
+        p ++;
+    }
+
+    free( info );
+
+    topology->Count = count;
+    topology->Quota = 0;
+
+    return GL_TRUE;
+
+#else
+
+    (void) topology;
+    return GL_FALSE;
+
+#endif
+}
+
+
+//========================================================================
+// Wait until the int at the given address no longer holds the given value
+// (or until woken, or the timeout expires)
+//========================================================================
+
+void _glfwPlatformWaitAddress( volatile int *address, int value,
+    double timeout )
+{
+    EnterCriticalSection( &WAIT_BUCKET( address )->mutex );
+    if( *address == value )
+    {
+        _glfwPlatformWaitCond( WAIT_BUCKET( address )->cond,
+                               (GLFWmutex) &WAIT_BUCKET( address )->mutex,
+                               timeout );
+    }
+    LeaveCriticalSection( &WAIT_BUCKET( address )->mutex );
+}
+
+
+//========================================================================
+// Wake up threads waiting on the given address
+//========================================================================
+
+void _glfwPlatformWakeAddress( volatile int *address, int count )
+{
+    // Other addresses may share the bucket, so everyone must be woken
+    EnterCriticalSection( &WAIT_BUCKET( address )->mutex );
+    _glfwPlatformBroadcastCond( WAIT_BUCKET( address )->cond );
+    LeaveCriticalSection( &WAIT_BUCKET( address )->mutex );
+}
+
+
+//========================================================================
+// Set the internal data pointer of the calling thread
+//========================================================================
+
+void _glfwPlatformSetThreadData( void *data )
+{
+    TlsSetValue( _glfwThrd.DataIndex, data );
+}
+
+
+//========================================================================
+// Return the internal data pointer of the calling thread
+//========================================================================
+
+void * _glfwPlatformGetThreadData( void )
+{
+    return TlsGetValue( _glfwThrd.DataIndex );
+}
+
+
+//========================================================================
+// Fiber start data. Win32 fibers are plain handles, but GLFW fiber
+// functions take a void * argument, so the argument is kept alongside.
+//========================================================================
+
+typedef struct {
+    LPVOID handle;
+    void   (*fun)( void * );
+    void   *arg;
+} _GLFWfiber_win32;
+
+
+//========================================================================
+// Fiber entry point
+//========================================================================
+
+static VOID WINAPI FiberStart( LPVOID param )
+{
+    _GLFWfiber_win32 *fiber = (_GLFWfiber_win32 *) param;
+
+    fiber->fun( fiber->arg );
+
+    // Fiber functions must never return, as that would exit the thread
+    abort();
+}
+
+
+//========================================================================
+// Create a fiber that will call fun( arg ) when first switched to
+//========================================================================
+
+void * _glfwPlatformCreateFiber( void (*fun)( void * ), void *arg,
+                                 size_t stacksize )
+{
+    _GLFWfiber_win32 *fiber;
+
+    fiber = (_GLFWfiber_win32 *) malloc( sizeof(_GLFWfiber_win32) );
+    if( fiber == NULL )
+    {
+        return NULL;
+    }
+
+    fiber->fun = fun;
+    fiber->arg = arg;
+    fiber->handle = CreateFiber( (SIZE_T) stacksize, FiberStart, fiber );
+    if( fiber->handle == NULL )
+    {
+        free( fiber );
+        return NULL;
+    }
+
+    return fiber;
+}
+
+
+//========================================================================
+// Turn the calling thread into a fiber, so that it can be switched away
+// from and back to
+//========================================================================
+
+void * _glfwPlatformConvertThreadToFiber( void )
+{
+    _GLFWfiber_win32 *fiber;
+
+    fiber = (_GLFWfiber_win32 *) calloc( 1, sizeof(_GLFWfiber_win32) );
+    if( fiber == NULL )
+    {
+        return NULL;
+    }
+
+    fiber->handle = ConvertThreadToFiber( NULL );
+    if( fiber->handle == NULL )
+    {
+        free( fiber );
+        return NULL;
+    }
+
+    return fiber;
+}
+
+
+//========================================================================
+// Release a fiber created by _glfwPlatformConvertThreadToFiber (which
+// must be the one running)
+//========================================================================
+
+void _glfwPlatformConvertFiberToThread( void *fiber )
+{
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0501
+    ConvertFiberToThread();
+#endif
+    // Before Windows XP the fiber data is only released on thread exit
+    free( fiber );
+}
+
+
+//========================================================================
+// Continue with the fiber to (from must be the one running)
+//========================================================================
+
+void _glfwPlatformSwitchFiber( void *from, void *to )
+{
+    (void) from;
+    SwitchToFiber( ((_GLFWfiber_win32 *) to)->handle );
+}
+
+
+//========================================================================
+// Destroy a fiber created by _glfwPlatformCreateFiber (which must not be
+// running)
+//========================================================================
+
+void _glfwPlatformDestroyFiber( void *fiber )
+{
+    DeleteFiber( ((_GLFWfiber_win32 *) fiber)->handle );
+    free( fiber );
+}
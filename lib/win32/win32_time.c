@@ -144,3 +144,28 @@ void _glfwPlatformSleep( double time )
     Sleep( t );
 }
 
+
+//========================================================================
+// Make sleeps of the calling thread as precise as possible, until the
+// matching call to _glfwPlatformEndPreciseSleep. Sleep only wakes up on
+// system timer ticks, which are 10-16 ms apart unless a finer timer
+// resolution is requested.
+//========================================================================
+
+int _glfwPlatformBeginPreciseSleep( void )
+{
+    return _glfw_timeBeginPeriod( 1 ) == TIMERR_NOERROR;
+}
+
+
+//========================================================================
+// Release the timer resolution requested by _glfwPlatformBeginPreciseSleep
+//========================================================================
+
+void _glfwPlatformEndPreciseSleep( int state )
+{
+    if( state )
+    {
+        (void) _glfw_timeEndPeriod( 1 );
+    }
+}
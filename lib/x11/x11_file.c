@@ -0,0 +1,795 @@
+//========================================================================
+// GLFW - An OpenGL framework
+// Platform:    X11/GLX
+// API version: 2.7
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2010 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+// Files and shared images may be larger than a 32-bit off_t can describe
+#define _FILE_OFFSET_BITS 64
+
+#include "internal.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/syscall.h>
+
+#if defined( __linux__ )
+#include <linux/memfd.h>
+#endif
+
+// Shared images use sealed memfds where available (Linux 3.17 and later)
+// and unlinked POSIX shared memory objects elsewhere
+#if defined( __NR_memfd_create ) && defined( MFD_ALLOW_SEALING )
+ #define _GLFW_USE_MEMFD
+ #ifndef F_ADD_SEALS
+  #define F_ADD_SEALS   1033
+  #define F_GET_SEALS   1034
+  #define F_SEAL_SHRINK 0x0002
+  #define F_SEAL_GROW   0x0004
+ #endif
+#endif
+
+#ifdef _GLFW_HAS_IO_URING
+#include <linux/io_uring.h>
+
+
+//========================================================================
+// Batched file reading through io_uring. Each queued file goes through
+// an asynchronous open and one or more asynchronous reads; only the
+// fstat of the freshly opened descriptor is done synchronously. Kernels
+// that lack an operation (-EINVAL) get the blocking equivalent instead.
+//========================================================================
+
+// Largest single read, as the length of a read is only 32 bits wide;
+// larger files are read in several pieces
+#define _GLFW_FILE_READ_SIZE    (1 << 30)
+
+// File slot states
+#define _GLFW_FILE_FREE     0
+#define _GLFW_FILE_OPENING  1
+#define _GLFW_FILE_READING  2
+#define _GLFW_FILE_DONE     3
+#define _GLFW_FILE_FAILED   4
+
+typedef struct {
+    int            state;
+    const char     *name;
+    int            index;
+    int            fd;
+    unsigned char  *data;
+    _GLFWoffset    size, done;
+} _GLFWfileslot;
+
+struct _GLFWfilequeue_struct {
+    int            fd;
+    int            depth;
+
+    // Shared rings
+    void           *sqring, *cqring;
+    size_t         sqringsize, cqringsize;
+    struct io_uring_sqe *sqes;
+    unsigned       *sqhead, *sqtail, *sqmask, *sqarray;
+    unsigned       *cqhead, *cqtail, *cqmask;
+    struct io_uring_cqe *cqes;
+
+    // Number of entries not yet handed to the kernel
+    unsigned       pending;
+
+    // Set once io_uring_enter has failed for good
+    int            broken;
+
+    _GLFWfileslot  *slots;
+};
+
+
+//========================================================================
+// Thin wrappers for the io_uring system calls (glibc has none)
+//========================================================================
+
+static int SetupRing( unsigned entries, struct io_uring_params *params )
+{
+    return (int) syscall( __NR_io_uring_setup, entries, params );
+}
+
+static int EnterRing( int fd, unsigned submit, unsigned wait )
+{
+    return (int) syscall( __NR_io_uring_enter, fd, submit, wait,
+                          IORING_ENTER_GETEVENTS, NULL, 0 );
+}
+
+
+//========================================================================
+// Queue an operation for a file slot (there is always room, as each slot
+// has at most one operation in flight)
+//========================================================================
+
+static void QueueFileOp( _GLFWfilequeue *queue, int slot, int opcode )
+{
+    _GLFWfileslot *f = queue->slots + slot;
+    struct io_uring_sqe *sqe;
+    _GLFWoffset size;
+    unsigned tail, index;
+
+    tail  = *queue->sqtail;
+    index = tail & *queue->sqmask;
+    sqe   = queue->sqes + index;
+    memset( sqe, 0, sizeof(struct io_uring_sqe) );
+
+    sqe->opcode    = (unsigned char) opcode;
+    sqe->user_data = (unsigned long long) slot;
+
+    if( opcode == IORING_OP_OPENAT )
+    {
+        sqe->fd         = AT_FDCWD;
+        sqe->addr       = (unsigned long long) (size_t) f->name;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    else
+    {
+        size = f->size - f->done;
+        if( size > _GLFW_FILE_READ_SIZE )
+        {
+            size = _GLFW_FILE_READ_SIZE;
+        }
+
+        sqe->fd   = f->fd;
+        sqe->addr = (unsigned long long) (size_t) (f->data + f->done);
+        sqe->len  = (unsigned) size;
+        sqe->off  = (unsigned long long) f->done;
+    }
+
+    queue->sqarray[ index ] = index;
+    __atomic_store_n( queue->sqtail, tail + 1, __ATOMIC_RELEASE );
+    queue->pending ++;
+}
+
+
+//========================================================================
+// Start reading a file that has just been opened
+//========================================================================
+
+static void StartFileRead( _GLFWfilequeue *queue, int slot )
+{
+    _GLFWfileslot *f = queue->slots + slot;
+    struct stat st;
+
+    if( fstat( f->fd, &st ) != 0 || st.st_size <= 0 ||
+        (_GLFWoffset) (size_t) st.st_size != (_GLFWoffset) st.st_size )
+    {
+        f->state = _GLFW_FILE_FAILED;
+        return;
+    }
+
+    f->size = (_GLFWoffset) st.st_size;
+    f->done = 0;
+    f->data = (unsigned char *) malloc( (size_t) f->size );
+    if( f->data == NULL )
+    {
+        f->state = _GLFW_FILE_FAILED;
+        return;
+    }
+
+    f->state = _GLFW_FILE_READING;
+    QueueFileOp( queue, slot, IORING_OP_READ );
+}
+
+
+//========================================================================
+// Handle the completion of an operation for a file slot
+//========================================================================
+
+static void CompleteFileOp( _GLFWfilequeue *queue, int slot, int result )
+{
+    _GLFWfileslot *f = queue->slots + slot;
+    ssize_t count;
+
+    if( f->state == _GLFW_FILE_OPENING )
+    {
+        if( result == -EINVAL )
+        {
+            // Asynchronous open is not supported by this kernel
+            result = open( f->name, O_RDONLY | O_CLOEXEC );
+            if( result < 0 )
+            {
+                result = -errno;
+            }
+        }
+        if( result < 0 )
+        {
+            f->state = _GLFW_FILE_FAILED;
+            return;
+        }
+
+        f->fd = result;
+        StartFileRead( queue, slot );
+        return;
+    }
+
+    if( result == -EINTR || result == -EAGAIN )
+    {
+        QueueFileOp( queue, slot, IORING_OP_READ );
+        return;
+    }
+
+    if( result == -EINVAL )
+    {
+        // Asynchronous read is not supported by this kernel
+        while( f->done < f->size )
+        {
+            count = pread( f->fd, f->data + f->done,
+                           (size_t) (f->size - f->done), (off_t) f->done );
+            if( count <= 0 )
+            {
+                break;
+            }
+            f->done += count;
+        }
+        result = 0;
+    }
+    else if( result < 0 )
+    {
+        f->state = _GLFW_FILE_FAILED;
+        return;
+    }
+
+    f->done += result;
+    if( result > 0 && f->done < f->size )
+    {
+        // Short read, or the next piece of a large file; continue where
+        // it left off
+        QueueFileOp( queue, slot, IORING_OP_READ );
+        return;
+    }
+
+    // A file that shrank while being read is passed on truncated
+    f->size  = f->done;
+    f->state = _GLFW_FILE_DONE;
+}
+
+
+
+//========================================================================
+// Give up on a ring that io_uring_enter keeps failing on. Entries the
+// kernel has not consumed are taken back, and operations it has already
+// started are waited for, as they may still write into the file buffers.
+// Every file still in flight is then failed.
+//========================================================================
+
+static void DrainFileQueue( _GLFWfilequeue *queue )
+{
+    _GLFWfileslot *f;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail, index;
+    int i, busy;
+
+    // Take back the entries that were never submitted
+    head = __atomic_load_n( queue->sqhead, __ATOMIC_ACQUIRE );
+    tail = *queue->sqtail;
+    while( tail != head )
+    {
+        tail --;
+        index = queue->sqarray[ tail & *queue->sqmask ];
+        queue->slots[ (int) queue->sqes[ index ].user_data ].state =
+            _GLFW_FILE_FAILED;
+    }
+    __atomic_store_n( queue->sqtail, head, __ATOMIC_RELEASE );
+    queue->pending = 0;
+    queue->broken  = GL_TRUE;
+
+    // Any other file in flight has an operation in the kernel; reap their
+    // completions straight from the ring until none are left
+    for( ;; )
+    {
+        busy = GL_FALSE;
+        for( i = 0; i < queue->depth; i ++ )
+        {
+            if( queue->slots[ i ].state == _GLFW_FILE_OPENING ||
+                queue->slots[ i ].state == _GLFW_FILE_READING )
+            {
+                busy = GL_TRUE;
+            }
+        }
+        if( !busy )
+        {
+            break;
+        }
+
+        head = *queue->cqhead;
+        tail = __atomic_load_n( queue->cqtail, __ATOMIC_ACQUIRE );
+        if( head == tail )
+        {
+            _glfwPlatformSleep( 0.001 );
+            continue;
+        }
+
+        while( head != tail )
+        {
+            cqe = queue->cqes + (head & *queue->cqmask);
+            f = queue->slots + (int) cqe->user_data;
+            if( f->state == _GLFW_FILE_OPENING && cqe->res >= 0 )
+            {
+                f->fd = cqe->res;
+            }
+            f->state = _GLFW_FILE_FAILED;
+            head ++;
+        }
+        __atomic_store_n( queue->cqhead, head, __ATOMIC_RELEASE );
+    }
+}
+
+#endif // _GLFW_HAS_IO_URING
+
+
+//************************************************************************
+//****               Platform implementation functions                ****
+//************************************************************************
+
+//========================================================================
+// Map a whole file into memory for reading
+//========================================================================
+
+void * _glfwPlatformMapFile( const char *name, _GLFWoffset *size )
+{
+    struct stat st;
+    void *data;
+    int fd;
+
+    fd = open( name, O_RDONLY );
+    if( fd < 0 )
+    {
+        return NULL;
+    }
+
+    if( fstat( fd, &st ) != 0 || st.st_size <= 0 ||
+        (_GLFWoffset) (size_t) st.st_size != (_GLFWoffset) st.st_size )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    data = mmap( NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+    // The mapping stays valid after the descriptor is closed
+    close( fd );
+
+    if( data == MAP_FAILED )
+    {
+        return NULL;
+    }
+
+    *size = (_GLFWoffset) st.st_size;
+    return data;
+}
+
+
+//========================================================================
+// Unmap a file mapped with _glfwPlatformMapFile
+//========================================================================
+
+void _glfwPlatformUnmapFile( void *data, _GLFWoffset size )
+{
+    munmap( data, (size_t) size );
+}
+
+
+//========================================================================
+// Create a queue for reading up to depth whole files concurrently, or
+// return NULL if asynchronous file reading is unavailable
+//========================================================================
+
+_GLFWfilequeue * _glfwPlatformOpenFileQueue( int depth )
+{
+#ifdef _GLFW_HAS_IO_URING
+    _GLFWfilequeue *queue;
+    struct io_uring_params params;
+    int i;
+
+    queue = (_GLFWfilequeue *) calloc( 1, sizeof(_GLFWfilequeue) );
+    if( queue == NULL )
+    {
+        return NULL;
+    }
+
+    // The ring may also be refused at run time (old kernel, seccomp)
+    memset( &params, 0, sizeof(params) );
+    queue->fd = SetupRing( (unsigned) depth, &params );
+    if( queue->fd < 0 )
+    {
+        free( queue );
+        return NULL;
+    }
+    queue->depth = depth;
+
+    queue->sqringsize = params.sq_off.array +
+                        params.sq_entries * sizeof(unsigned);
+    queue->cqringsize = params.cq_off.cqes +
+                        params.cq_entries * sizeof(struct io_uring_cqe);
+    if( params.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        if( queue->cqringsize > queue->sqringsize )
+        {
+            queue->sqringsize = queue->cqringsize;
+        }
+        queue->cqringsize = 0;
+    }
+
+    queue->sqring = mmap( NULL, queue->sqringsize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, queue->fd,
+                          IORING_OFF_SQ_RING );
+    queue->cqring = queue->sqring;
+    if( queue->sqring != MAP_FAILED && queue->cqringsize )
+    {
+        queue->cqring = mmap( NULL, queue->cqringsize,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, queue->fd,
+                              IORING_OFF_CQ_RING );
+    }
+    queue->sqes = (struct io_uring_sqe *) mmap( NULL,
+                      params.sq_entries * sizeof(struct io_uring_sqe),
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      queue->fd, IORING_OFF_SQES );
+    queue->slots = (_GLFWfileslot *) calloc( depth, sizeof(_GLFWfileslot) );
+
+    if( queue->sqring == MAP_FAILED || queue->cqring == MAP_FAILED ||
+        queue->sqes == MAP_FAILED || queue->slots == NULL )
+    {
+        if( queue->sqring != MAP_FAILED )
+        {
+            if( queue->cqringsize && queue->cqring != MAP_FAILED )
+            {
+                munmap( queue->cqring, queue->cqringsize );
+            }
+            munmap( queue->sqring, queue->sqringsize );
+        }
+        if( queue->sqes != MAP_FAILED )
+        {
+            munmap( queue->sqes,
+                    params.sq_entries * sizeof(struct io_uring_sqe) );
+        }
+        free( queue->slots );
+        close( queue->fd );
+        free( queue );
+        return NULL;
+    }
+
+    queue->sqhead  = (unsigned *) ((char *) queue->sqring + params.sq_off.head);
+    queue->sqtail  = (unsigned *) ((char *) queue->sqring + params.sq_off.tail);
+    queue->sqmask  = (unsigned *) ((char *) queue->sqring + params.sq_off.ring_mask);
+    queue->sqarray = (unsigned *) ((char *) queue->sqring + params.sq_off.array);
+    queue->cqhead  = (unsigned *) ((char *) queue->cqring + params.cq_off.head);
+    queue->cqtail  = (unsigned *) ((char *) queue->cqring + params.cq_off.tail);
+    queue->cqmask  = (unsigned *) ((char *) queue->cqring + params.cq_off.ring_mask);
+    queue->cqes    = (struct io_uring_cqe *) ((char *) queue->cqring +
+                                              params.cq_off.cqes);
+
+    for( i = 0; i < depth; i ++ )
+    {
+        queue->slots[ i ].fd = -1;
+    }
+
+    return queue;
+#else
+    return NULL;
+#endif
+}
+
+
+//========================================================================
+// Queue a whole file for reading (returns GL_FALSE if the queue is full)
+//========================================================================
+
+int _glfwPlatformQueueFileRead( _GLFWfilequeue *queue, const char *name,
+                                int index )
+{
+#ifdef _GLFW_HAS_IO_URING
+    int i;
+
+    if( queue->broken )
+    {
+        return GL_FALSE;
+    }
+
+    for( i = 0; i < queue->depth; i ++ )
+    {
+        if( queue->slots[ i ].state == _GLFW_FILE_FREE )
+        {
+            queue->slots[ i ].state = _GLFW_FILE_OPENING;
+            queue->slots[ i ].name  = name;
+            queue->slots[ i ].index = index;
+            queue->slots[ i ].fd    = -1;
+            queue->slots[ i ].data  = NULL;
+            QueueFileOp( queue, i, IORING_OP_OPENAT );
+            return GL_TRUE;
+        }
+    }
+#endif
+
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Wait for any queued file to finish. On success the file contents are
+// returned in a buffer that the caller must free; on failure only the
+// index is returned
+//========================================================================
+
+int _glfwPlatformWaitFileRead( _GLFWfilequeue *queue, int *index,
+                               void **data, _GLFWoffset *size )
+{
+#ifdef _GLFW_HAS_IO_URING
+    _GLFWfileslot *f;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail;
+    int i, busy, result;
+
+    *index = -1;
+
+    for( ;; )
+    {
+        // Hand back a finished file, if there is one
+        busy = GL_FALSE;
+        for( i = 0; i < queue->depth; i ++ )
+        {
+            f = queue->slots + i;
+            if( f->state == _GLFW_FILE_DONE || f->state == _GLFW_FILE_FAILED )
+            {
+                *index = f->index;
+                *data  = NULL;
+                *size  = 0;
+                result = GL_FALSE;
+                if( f->state == _GLFW_FILE_DONE )
+                {
+                    *data = f->data;
+                    *size = f->size;
+                    result = GL_TRUE;
+                }
+                else
+                {
+                    free( f->data );
+                }
+                if( f->fd >= 0 )
+                {
+                    close( f->fd );
+                }
+                f->fd    = -1;
+                f->data  = NULL;
+                f->state = _GLFW_FILE_FREE;
+                return result;
+            }
+            if( f->state != _GLFW_FILE_FREE )
+            {
+                busy = GL_TRUE;
+            }
+        }
+
+        if( !busy )
+        {
+            return GL_FALSE;
+        }
+
+        // Submit new operations and wait for at least one completion
+        result = EnterRing( queue->fd, queue->pending, 1 );
+        if( result < 0 )
+        {
+            if( errno == EINTR || errno == EAGAIN || errno == EBUSY )
+            {
+                continue;
+            }
+
+            // This should never happen, but if it does the ring is of no
+            // further use
+            DrainFileQueue( queue );
+            continue;
+        }
+
+        // The kernel may consume only some of the entries; the rest stay
+        // in the ring for the next call
+        queue->pending -= (unsigned) result;
+
+        head = *queue->cqhead;
+        tail = __atomic_load_n( queue->cqtail, __ATOMIC_ACQUIRE );
+        while( head != tail )
+        {
+            cqe = queue->cqes + (head & *queue->cqmask);
+            CompleteFileOp( queue, (int) cqe->user_data, cqe->res );
+            head ++;
+        }
+        __atomic_store_n( queue->cqhead, head, __ATOMIC_RELEASE );
+    }
+#else
+    return GL_FALSE;
+#endif
+}
+
+
+//========================================================================
+// Destroy a file queue (it must not have any files in flight)
+//========================================================================
+
+void _glfwPlatformCloseFileQueue( _GLFWfilequeue *queue )
+{
+#ifdef _GLFW_HAS_IO_URING
+    munmap( queue->sqes, (*queue->sqmask + 1) * sizeof(struct io_uring_sqe) );
+    if( queue->cqringsize )
+    {
+        munmap( queue->cqring, queue->cqringsize );
+    }
+    munmap( queue->sqring, queue->sqringsize );
+    close( queue->fd );
+    free( queue->slots );
+    free( queue );
+#endif
+}
+
+
+//========================================================================
+// Ask the system to start reading a file into the page cache
+//========================================================================
+
+void _glfwPlatformPrefetchFile( const char *name )
+{
+    int fd;
+
+    fd = open( name, O_RDONLY | O_CLOEXEC );
+    if( fd < 0 )
+    {
+        return;
+    }
+
+    posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+    close( fd );
+}
+
+
+//========================================================================
+// Create a block of memory that can be shared with other processes
+// through the returned file descriptor
+//========================================================================
+
+void * _glfwPlatformCreateSharedMemory( size_t size, int *handle )
+{
+    void *data;
+    int fd;
+
+#ifdef _GLFW_USE_MEMFD
+    fd = (int) syscall( __NR_memfd_create, "glfw-image",
+                        MFD_CLOEXEC | MFD_ALLOW_SEALING );
+    if( fd < 0 )
+    {
+        return NULL;
+    }
+
+    // Once sealed, the size cannot change, so receivers can rely on it
+    if( ftruncate( fd, (off_t) size ) != 0 ||
+        fcntl( fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW ) != 0 )
+    {
+        close( fd );
+        return NULL;
+    }
+#else
+    static unsigned int counter = 0;
+    char name[ 64 ];
+    int tries;
+
+    // Create a uniquely named object, and unlink it right away so that
+    // only the descriptor refers to it
+    fd = -1;
+    for( tries = 0;  fd < 0 && tries < 16;  tries ++ )
+    {
+        sprintf( name, "/glfw-%d-%u", (int) getpid(), counter ++ );
+        fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+    }
+    if( fd < 0 )
+    {
+        return NULL;
+    }
+    shm_unlink( name );
+
+    if( ftruncate( fd, (off_t) size ) != 0 )
+    {
+        close( fd );
+        return NULL;
+    }
+#endif
+
+    data = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( data == MAP_FAILED )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    *handle = fd;
+    return data;
+}
+
+
+//========================================================================
+// Map shared memory created by another process. The mapping is copy on
+// write, so it may be modified without affecting the other process
+//========================================================================
+
+void * _glfwPlatformMapSharedMemory( int handle, size_t *size )
+{
+    struct stat st;
+    void *data;
+#ifdef _GLFW_USE_MEMFD
+    int seals;
+#endif
+
+    if( fstat( handle, &st ) != 0 || st.st_size <= 0 ||
+        (_GLFWoffset) (size_t) st.st_size != (_GLFWoffset) st.st_size )
+    {
+        return NULL;
+    }
+
+#ifdef _GLFW_USE_MEMFD
+    // Anything the sender could still shrink, be it an unsealed memfd or
+    // a regular file (which has no seals at all), would let it crash us
+    // with SIGBUS, so only memfds sealed against shrinking are accepted
+    seals = fcntl( handle, F_GET_SEALS );
+    if( seals < 0 || !(seals & F_SEAL_SHRINK) )
+    {
+        return NULL;
+    }
+#endif
+
+    data = mmap( NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE, handle, 0 );
+    if( data == MAP_FAILED )
+    {
+        return NULL;
+    }
+
+    *size = (size_t) st.st_size;
+    return data;
+}
+
+
+//========================================================================
+// Unmap shared memory
+//========================================================================
+
+void _glfwPlatformUnmapSharedMemory( void *data, size_t size )
+{
+    munmap( data, size );
+}
+
+
+//========================================================================
+// Close a shared memory handle
+//========================================================================
+
+void _glfwPlatformCloseSharedMemory( int handle )
+{
+    close( handle );
+}
@@ -30,6 +30,9 @@
 
 #include "internal.h"
 
+#ifdef _GLFW_HAS_GETTID
+ #include <sys/syscall.h>
+#endif
 
 
 //************************************************************************
@@ -57,6 +60,16 @@ static void initThreads( void )
     _glfwThrd.First.Next     = NULL;
 #ifdef _GLFW_HAS_PTHREAD
     _glfwThrd.First.PosixID  = pthread_self();
+#ifdef _GLFW_HAS_GETTID
+    _glfwThrd.First.KernelID = (int) syscall( SYS_gettid );
+#endif
+
+    // Remember the main thread's ID for glfwGetThreadID
+#ifndef _GLFW_HAS_TLS
+    (void) pthread_key_create( &_glfwThrd.IDKey, NULL );
+    (void) pthread_key_create( &_glfwThrd.DataKey, NULL );
+#endif
+    _glfwSetThreadID( _glfwThrd.First.ID );
 #endif
 }
 
@@ -82,11 +95,19 @@ static void terminateThreads( void )
         // Get pointer to next thread
         t_next = t->Next;
 
-        // Simply murder the process, no mercy!
-        pthread_kill( t->PosixID, SIGKILL );
+        // Threads that have finished only need to be joined; any others
+        // are simply murdered, no mercy!
+        if( t->Finished )
+        {
+            (void) pthread_join( t->PosixID, NULL );
+        }
+        else
+        {
+            pthread_kill( t->PosixID, SIGKILL );
+        }
 
-        // Free memory allocated for this thread
-        free( (void *) t );
+        // Remove thread from thread list and free its memory
+        _glfwRemoveThread( t );
 
         // Select next thread in list
         t = t_next;
@@ -95,6 +116,13 @@ static void terminateThreads( void )
     // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
 
+    // The main thread is no longer known to GLFW
+    _glfwSetThreadID( -1 );
+#ifndef _GLFW_HAS_TLS
+    pthread_key_delete( _glfwThrd.IDKey );
+    pthread_key_delete( _glfwThrd.DataKey );
+#endif
+
     // Delete critical section handle
     pthread_mutex_destroy( &_glfwThrd.CriticalSection );
 
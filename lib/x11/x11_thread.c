@@ -30,6 +30,41 @@
 
 #include "internal.h"
 
+#include <dirent.h>
+#include <limits.h>
+#include <time.h>
+
+#ifdef _GLFW_HAS_FUTEX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+#ifdef _GLFW_HAS_UCONTEXT
+ #include <ucontext.h>
+ #include <sys/mman.h>
+#endif
+
+#ifdef _GLFW_HAS_PRCTL
+ #include <sys/prctl.h>
+#endif
+
+#ifdef _GLFW_HAS_SCHED_SETAFFINITY
+ #include <sys/syscall.h>
+ #include <sys/resource.h>
+#endif
+
+#ifdef _GLFW_HAS_GETTID
+ #include <sys/syscall.h>
+#endif
+
+
+//========================================================================
+// Upper limit on the processor numbers looked for in /sys, and accepted
+// in affinity lists
+//========================================================================
+
+#define _GLFW_MAX_CPUS 4096
+
 
 
 //************************************************************************
@@ -39,54 +74,395 @@
 #ifdef _GLFW_HAS_PTHREAD
 
 //========================================================================
-// This is simply a "wrapper" for calling the user thread function.
+// GLFW ID of the calling thread, or -1 for threads not created by GLFW.
+// Without compiler support for __thread, the ID is kept in a pthread key
+// offset by one, so that the key's initial NULL value reads back as -1.
+//========================================================================
+
+#ifdef _GLFW_HAS_TLS
+static __thread GLFWthread _glfwCurrentThreadID = -1;
+static __thread void *_glfwCurrentThreadData = NULL;
+#endif
+
+
+//========================================================================
+// Set the GLFW ID of the calling thread
 //========================================================================
 
-void * _glfwNewThread( void * arg )
+void _glfwSetThreadID( GLFWthread ID )
 {
-    GLFWthreadfun threadfun;
-    _GLFWthread   *t;
-    pthread_t   posixID;
+#ifdef _GLFW_HAS_TLS
+    _glfwCurrentThreadID = ID;
+#else
+    (void) pthread_setspecific( _glfwThrd.IDKey, (void *) (ID + 1L) );
+#endif
+}
 
-    // Get current thread ID
-    posixID = pthread_self();
 
-    // Enter critical section
-    ENTER_THREAD_CRITICAL_SECTION
+//========================================================================
+// Apply the attributes a thread was created with to the calling thread.
+// Names, affinity and nice values can only be set per thread from the
+// thread itself on Linux.
+//========================================================================
+
+static void ApplyThreadAttribs( const GLFWthreadattribs *attribs )
+{
+#ifdef _GLFW_HAS_SCHED_SETAFFINITY
+    unsigned long      mask[ _GLFW_MAX_CPUS / (8 * sizeof(unsigned long)) ];
+    int                i, cpu, bits = 8 * sizeof(unsigned long);
+#endif
+    struct sched_param param;
+    int                low, high;
+
+#ifdef _GLFW_HAS_PRCTL
+    if( attribs->Name != NULL )
+    {
+        // The kernel keeps the first 15 characters
+        (void) prctl( PR_SET_NAME, (unsigned long) attribs->Name, 0, 0, 0 );
+    }
+#endif
 
-    // Loop through entire list of threads to find the matching POSIX
-    // thread ID
-    for( t = &_glfwThrd.First; t != NULL; t = t->Next )
+#ifdef _GLFW_HAS_SCHED_SETAFFINITY
+    if( attribs->AffinityCount > 0 )
     {
-        if( t->PosixID == posixID )
+        memset( mask, 0, sizeof(mask) );
+        for( i = 0;  i < attribs->AffinityCount;  i ++ )
         {
-            break;
+            cpu = attribs->Affinity[ i ];
+            if( cpu >= 0 && cpu < _GLFW_MAX_CPUS )
+            {
+                mask[ cpu / bits ] |= 1UL << (cpu % bits);
+            }
         }
+
+        (void) syscall( SYS_sched_setaffinity, syscall( SYS_gettid ),
+                        sizeof(mask), mask );
     }
-    if( t == NULL )
+
+    if( !attribs->Realtime && attribs->Priority != 0 )
     {
-        LEAVE_THREAD_CRITICAL_SECTION
-        return NULL;
+        // Nice values belong to threads, not processes, on Linux
+        (void) setpriority( PRIO_PROCESS, (id_t) syscall( SYS_gettid ),
+                            attribs->Priority );
     }
+#endif
 
-    // Get user thread function pointer
-    threadfun = t->Function;
+    if( attribs->Realtime )
+    {
+        low  = sched_get_priority_min( SCHED_FIFO );
+        high = sched_get_priority_max( SCHED_FIFO );
 
-    // Leave critical section
-    LEAVE_THREAD_CRITICAL_SECTION
+        param.sched_priority = attribs->Priority;
+        if( param.sched_priority < low )
+        {
+            param.sched_priority = low;
+        }
+        if( param.sched_priority > high )
+        {
+            param.sched_priority = high;
+        }
+
+        (void) pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+    }
+}
+
+
+//========================================================================
+// This is simply a "wrapper" for calling the user thread function.
+//========================================================================
+
+static void * _glfwNewThread( void * arg )
+{
+    _GLFWthread *t = (_GLFWthread *) arg;
+
+    // Publish our GLFW ID before any user code can ask for it
+    _glfwSetThreadID( t->ID );
+
+#ifdef _GLFW_HAS_GETTID
+    // Our kernel ID is what finds our statistics in /proc
+    _glfwAtomicStore( &t->KernelID, (int) syscall( SYS_gettid ) );
+#endif
+
+    // Apply any attributes before the user function runs
+    if( t->Attribs != NULL )
+    {
+        ApplyThreadAttribs( t->Attribs );
+        free( t->Attribs );
+        t->Attribs = NULL;
+    }
 
     // Call the user thread function
-    threadfun( arg );
+    t->Function( t->Arg );
 
-    // Remove thread from thread list
+    // Mark the thread as finished, but leave it in the thread list, as it
+    // has to be joined for its stack to be freed (the creating thread
+    // holds the critical section until the thread has been appended, so
+    // this can not race with _glfwPlatformCreateThread)
     ENTER_THREAD_CRITICAL_SECTION
-    _glfwRemoveThread( t );
+    t->Finished = GL_TRUE;
     LEAVE_THREAD_CRITICAL_SECTION
 
     // When the thread function returns, the thread will die...
     return NULL;
 }
 
+
+
+#ifdef _GLFW_HAS_PTHREAD
+
+//========================================================================
+// Mutex object, padded to a cache line of its own. Adaptive mutexes are
+// futex words, where 0 means unlocked, 1 locked and 2 locked with threads
+// (possibly) sleeping on it; all others are plain pthread mutexes.
+//========================================================================
+
+#define _GLFW_CACHE_LINE 64
+
+// Upper limit on the number of times a locker spins before sleeping
+#define _GLFW_MUTEX_SPIN 100
+
+typedef struct {
+    volatile int    state;
+    volatile int    spins;      // Running average of spins needed to lock
+    int             spinLimit;  // Zero on single processor systems
+    int             adaptive;
+    pthread_mutex_t mutex;
+} _GLFWmutex_x11;
+
+#ifdef _GLFW_HAS_FUTEX
+
+//========================================================================
+// Condition variable object, for use with either kind of mutex: waiters
+// sleep on a sequence number that is bumped by every signal
+//========================================================================
+
+typedef struct {
+    volatile int seq;
+    volatile int waiters;
+} _GLFWcond_x11;
+
+#endif // _GLFW_HAS_FUTEX
+
+
+//========================================================================
+// Lock an adaptive mutex: spin for about as long as it took to get the
+// lock the last few times, then sleep until an unlock wakes us up
+//========================================================================
+
+#ifdef _GLFW_HAS_FUTEX
+
+static void LockAdaptiveMutex( _GLFWmutex_x11 *m )
+{
+    int count, limit, spins;
+
+    if( _glfwAtomicCompareExchange( &m->state, 0, 1 ) )
+    {
+        return;
+    }
+
+    spins = _glfwAtomicLoadRelaxed( &m->spins );
+    limit = spins * 2 + 10;
+    if( limit > m->spinLimit )
+    {
+        limit = m->spinLimit;
+    }
+
+    for( count = 0;  count < limit;  count ++ )
+    {
+        _glfwAtomicPause();
+        if( _glfwAtomicLoadRelaxed( &m->state ) == 0 &&
+            _glfwAtomicCompareExchange( &m->state, 0, 1 ) )
+        {
+            break;
+        }
+    }
+
+    _glfwAtomicStoreRelaxed( &m->spins, spins + (count - spins) / 8 );
+    if( count < limit )
+    {
+        return;
+    }
+
+    // Mark the mutex as contended, so that the unlock wakes us up
+    while( _glfwAtomicExchange( &m->state, 2 ) != 0 )
+    {
+        _glfwPlatformWaitAddress( &m->state, 2, GLFW_INFINITY );
+    }
+}
+
+#endif // _GLFW_HAS_FUTEX
+
+#endif // _GLFW_HAS_PTHREAD
+
+
+#if defined(_GLFW_HAS_PTHREAD) && !defined(_GLFW_HAS_FUTEX)
+
+//========================================================================
+// Initialise a pthread condition variable. Where possible, its timed waits
+// use the monotonic clock, so that they are not affected when the wall
+// clock is set.
+//========================================================================
+
+static void InitCond( pthread_cond_t *cond )
+{
+#if defined(_GLFW_HAS_MONOTONIC_WAIT)
+    pthread_condattr_t attr;
+
+    (void) pthread_condattr_init( &attr );
+    (void) pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+    (void) pthread_cond_init( cond, &attr );
+    (void) pthread_condattr_destroy( &attr );
+#else
+    (void) pthread_cond_init( cond, NULL );
+#endif
+}
+
+
+//========================================================================
+// Wait for a pthread condition variable, for at most timeout seconds
+//========================================================================
+
+static void TimedWaitCond( pthread_cond_t *cond, pthread_mutex_t *mutex,
+                           double timeout )
+{
+    struct timespec wait;
+    long dt_sec, dt_nsec;
+
+    // Select infinite or timed wait
+    if( timeout >= GLFW_INFINITY )
+    {
+        // Wait for condition (infinite wait)
+        (void) pthread_cond_wait( cond, mutex );
+    }
+    else
+    {
+        if( timeout < 0.0 )
+        {
+            timeout = 0.0;
+        }
+
+        // Set timeout time, relative to current time on the same clock
+        // as the condition variable
+#if defined(_GLFW_HAS_MONOTONIC_WAIT)
+        clock_gettime( CLOCK_MONOTONIC, &wait );
+#else
+        {
+            struct timeval currenttime;
+
+            gettimeofday( &currenttime, NULL );
+            wait.tv_sec  = currenttime.tv_sec;
+            wait.tv_nsec = currenttime.tv_usec * 1000L;
+        }
+#endif
+        dt_sec  = (long) timeout;
+        dt_nsec = (long) ((timeout - (double)dt_sec) * 1000000000.0);
+        wait.tv_nsec += dt_nsec;
+        if( wait.tv_nsec >= 1000000000L )
+        {
+            wait.tv_nsec -= 1000000000L;
+            dt_sec ++;
+        }
+        wait.tv_sec += dt_sec;
+
+        // Wait for condition (timed wait)
+        (void) pthread_cond_timedwait( cond, mutex, &wait );
+    }
+}
+
+
+//========================================================================
+// Without futexes, threads waiting on an address sleep on one of a small
+// set of condition variables, chosen by hashing the address
+//========================================================================
+
+#define _GLFW_WAIT_BUCKETS 16
+
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+} _glfwWaitBuckets[ _GLFW_WAIT_BUCKETS ];
+
+static pthread_once_t _glfwWaitBucketsOnce = PTHREAD_ONCE_INIT;
+
+static void InitWaitBuckets( void )
+{
+    int i;
+
+    for( i = 0;  i < _GLFW_WAIT_BUCKETS;  i ++ )
+    {
+        (void) pthread_mutex_init( &_glfwWaitBuckets[ i ].mutex, NULL );
+        InitCond( &_glfwWaitBuckets[ i ].cond );
+    }
+}
+
+#define WAIT_BUCKET( address ) \
+    (&_glfwWaitBuckets[ ((size_t) (address) >> 2) % _GLFW_WAIT_BUCKETS ])
+
+#endif // _GLFW_HAS_PTHREAD && !_GLFW_HAS_FUTEX
+
+
+#ifdef _GLFW_HAS_UCONTEXT
+
+//========================================================================
+// Fiber: a user context with its own stack
+//========================================================================
+
+typedef struct {
+    ucontext_t context;
+    void       *stack;
+    size_t     size;
+    void       (*fun)( void * );
+    void       *arg;
+} _GLFWfiber_x11;
+
+
+//========================================================================
+// Fiber entry point. makecontext only passes int arguments, so the fiber
+// pointer is passed in two halves.
+//========================================================================
+
+static void FiberStart( unsigned int high, unsigned int low )
+{
+    _GLFWfiber_x11 *fiber;
+
+    fiber = (_GLFWfiber_x11 *) (((uintptr_t) high << 16 << 16) |
+                                (uintptr_t) low);
+    fiber->fun( fiber->arg );
+
+    // Fiber functions must never return, as there is nothing to return to
+    abort();
+}
+
+
+//========================================================================
+// Set up the context of a new fiber to start in FiberStart on the stack
+// above its guard page. This is kept apart from _glfwPlatformCreateFiber
+// as getcontext may return twice, which would leave the locals of its
+// caller in doubt.
+//========================================================================
+
+static int InitFiberContext( _GLFWfiber_x11 *fiber, size_t guard )
+{
+    uintptr_t ptr;
+
+    if( getcontext( &fiber->context ) != 0 )
+    {
+        return GL_FALSE;
+    }
+    fiber->context.uc_stack.ss_sp   = (char *) fiber->stack + guard;
+    fiber->context.uc_stack.ss_size = fiber->size - guard;
+    fiber->context.uc_link          = NULL;
+
+    ptr = (uintptr_t) fiber;
+    makecontext( &fiber->context, (void (*)( void )) FiberStart, 2,
+                 (unsigned int) (ptr >> 16 >> 16),
+                 (unsigned int) (ptr & 0xffffffffu) );
+
+    return GL_TRUE;
+}
+
+#endif // _GLFW_HAS_UCONTEXT
+
 #endif // _GLFW_HAS_PTHREAD
 
 
@@ -99,13 +475,16 @@ void * _glfwNewThread( void * arg )
 // Create a new thread
 //========================================================================
 
-GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
+GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg,
+                                      const GLFWthreadattribs *attribs )
 {
 #ifdef _GLFW_HAS_PTHREAD
 
-    GLFWthread  ID;
-    _GLFWthread *t;
-    int         result;
+    GLFWthread     ID;
+    _GLFWthread    *t;
+    pthread_attr_t attr;
+    size_t         stacksize, pagesize;
+    int            result;
 
     // Enter critical section
     ENTER_THREAD_CRITICAL_SECTION
@@ -124,19 +503,49 @@ GLFWthread _glfwPlatformCreateThread( GLFWthreadfun fun, void *arg )
 
     // Store thread information in the thread list
     t->Function = fun;
+    t->Arg      = arg;
     t->ID       = ID;
+    t->Attribs  = NULL;
+    t->Finished = GL_FALSE;
+#ifdef _GLFW_HAS_GETTID
+    t->KernelID = 0;
+#endif
+
+    (void) pthread_attr_init( &attr );
+
+    if( attribs != NULL )
+    {
+        // The stack size is the only attribute that has to be given to
+        // pthread_create; the thread applies the rest itself
+        if( attribs->StackSize > 0 )
+        {
+            pagesize = (size_t) sysconf( _SC_PAGESIZE );
+            stacksize = ((size_t) attribs->StackSize + pagesize - 1) &
+                        ~(pagesize - 1);
+            if( stacksize < PTHREAD_STACK_MIN )
+            {
+                stacksize = PTHREAD_STACK_MIN;
+            }
+            (void) pthread_attr_setstacksize( &attr, stacksize );
+        }
+
+        t->Attribs = _glfwCopyThreadAttribs( attribs );
+    }
 
     // Create thread
     result = pthread_create(
         &t->PosixID,      // Thread handle
-        NULL,             // Default thread attributes
+        &attr,            // Thread attributes
         _glfwNewThread,   // Thread function (a wrapper function)
-        (void *)arg       // Argument to thread is user argument
+        (void *)t         // Argument to thread is its own information
     );
 
+    (void) pthread_attr_destroy( &attr );
+
     // Did the thread creation fail?
     if( result != 0 )
     {
+        free( t->Attribs );
         free( (void *) t );
         LEAVE_THREAD_CRITICAL_SECTION
         return -1;
@@ -218,8 +627,8 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
         return GL_TRUE;
     }
 
-    // If got this far, the thread is alive => polling returns FALSE
-    if( waitmode == GLFW_NOWAIT )
+    // A thread that is still running makes polling return FALSE
+    if( waitmode == GLFW_NOWAIT && !t->Finished )
     {
         LEAVE_THREAD_CRITICAL_SECTION
         return GL_FALSE;
@@ -231,9 +640,18 @@ int _glfwPlatformWaitThread( GLFWthread ID, int waitmode )
     // Leave critical section
     LEAVE_THREAD_CRITICAL_SECTION
 
-    // Wait for thread to die
+    // Wait for thread to die, which also frees its stack
     (void) pthread_join( thread, NULL );
 
+    // Only now that it has been joined is the thread forgotten
+    ENTER_THREAD_CRITICAL_SECTION
+    t = _glfwGetThreadPointer( ID );
+    if( t != NULL )
+    {
+        _glfwRemoveThread( t );
+    }
+    LEAVE_THREAD_CRITICAL_SECTION
+
     return GL_TRUE;
 
 #else
@@ -252,32 +670,11 @@ GLFWthread _glfwPlatformGetThreadID( void )
 {
 #ifdef _GLFW_HAS_PTHREAD
 
-    _GLFWthread *t;
-    GLFWthread  ID = -1;
-    pthread_t   posixID;
-
-    // Get current thread ID
-    posixID = pthread_self();
-
-    // Enter critical section
-    ENTER_THREAD_CRITICAL_SECTION
-
-    // Loop through entire list of threads to find the matching POSIX
-    // thread ID
-    for( t = &_glfwThrd.First; t != NULL; t = t->Next )
-    {
-        if( t->PosixID == posixID )
-        {
-            ID = t->ID;
-            break;
-        }
-    }
-
-    // Leave critical section
-    LEAVE_THREAD_CRITICAL_SECTION
-
-    // Return the found GLFW thread identifier
-    return ID;
+#ifdef _GLFW_HAS_TLS
+    return _glfwCurrentThreadID;
+#else
+    return (GLFWthread) ((long) pthread_getspecific( _glfwThrd.IDKey ) - 1);
+#endif
 
 #else
 
@@ -288,64 +685,228 @@ GLFWthread _glfwPlatformGetThreadID( void )
 
 
 //========================================================================
-// Create a mutual exclusion object
+// Return the processor time used by a thread, in seconds, or a negative
+// value if it is not available
 //========================================================================
 
-GLFWmutex _glfwPlatformCreateMutex( void )
+double _glfwPlatformGetThreadCPUTime( GLFWthread ID )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_PTHREAD) && defined(_GLFW_HAS_THREAD_CPUTIME)
 
-    pthread_mutex_t *mutex;
+    _GLFWthread     *t;
+    clockid_t       clock;
+    struct timespec ts;
+    int             result;
 
-    // Allocate memory for mutex
-    mutex = (pthread_mutex_t *) malloc( sizeof( pthread_mutex_t ) );
-    if( !mutex )
+    // The calling thread needs no lookup
+    if( ID == _glfwPlatformGetThreadID() )
     {
-        return NULL;
+        if( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) != 0 )
+        {
+            return -1.0;
+        }
+        return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
     }
 
-    // Initialise a mutex object
-    (void) pthread_mutex_init( mutex, NULL );
-
-    // Cast to GLFWmutex and return
-    return (GLFWmutex) mutex;
-
-#else
+    // Threads stay in the list until they have been joined, so the
+    // thread handle stays valid while we hold the critical section
+    ENTER_THREAD_CRITICAL_SECTION
 
-    return (GLFWmutex) 0;
+    t = _glfwGetThreadPointer( ID );
+    if( t == NULL )
+    {
+        LEAVE_THREAD_CRITICAL_SECTION
+        return -1.0;
+    }
 
-#endif // _GLFW_HAS_PTHREAD
-}
+    result = pthread_getcpuclockid( t->PosixID, &clock );
+    if( result == 0 )
+    {
+        result = clock_gettime( clock, &ts );
+    }
 
+    LEAVE_THREAD_CRITICAL_SECTION
 
-//========================================================================
-// Destroy a mutual exclusion object
-//========================================================================
+    if( result != 0 )
+    {
+        return -1.0;
+    }
 
-void _glfwPlatformDestroyMutex( GLFWmutex mutex )
-{
-#ifdef _GLFW_HAS_PTHREAD
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
 
-    // Destroy the mutex object
-    pthread_mutex_destroy( (pthread_mutex_t *) mutex );
+#else
 
-    // Free memory for mutex object
-    free( (void *) mutex );
+    (void) ID;
+    return -1.0;
 
-#endif // _GLFW_HAS_PTHREAD
+#endif
 }
 
 
 //========================================================================
-// Request access to a mutex
+// Get the number of times a thread has given up the processor by
+// blocking (voluntary) and been preempted (involuntary), from its status
+// file in /proc. Returns GL_TRUE on success.
 //========================================================================
 
-void _glfwPlatformLockMutex( GLFWmutex mutex )
+int _glfwPlatformGetThreadContextSwitches( GLFWthread ID, int *voluntary,
+                                           int *involuntary )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_PTHREAD) && defined(_GLFW_HAS_GETTID)
+
+    _GLFWthread *t;
+    char        path[ 64 ], line[ 256 ];
+    FILE        *file;
+    int         kernelID, found = 0;
+
+    *voluntary = *involuntary = 0;
+
+    ENTER_THREAD_CRITICAL_SECTION
+
+    // The kernel ID of a thread that has finished may already belong to
+    // another thread
+    t = _glfwGetThreadPointer( ID );
+    if( t == NULL || t->Finished )
+    {
+        LEAVE_THREAD_CRITICAL_SECTION
+        return GL_FALSE;
+    }
+
+    // A thread that has not started yet has not been switched either
+    kernelID = _glfwAtomicLoad( &t->KernelID );
+    if( kernelID == 0 )
+    {
+        LEAVE_THREAD_CRITICAL_SECTION
+        return GL_TRUE;
+    }
+
+    // The file is read within the critical section, as the kernel ID of
+    // a thread that has exited may be given to a new one
+    sprintf( path, "/proc/self/task/%d/status", kernelID );
+    file = fopen( path, "r" );
+    if( file != NULL )
+    {
+        while( found < 2 && fgets( line, sizeof(line), file ) != NULL )
+        {
+            if( strncmp( line, "voluntary_ctxt_switches:", 24 ) == 0 )
+            {
+                *voluntary = atoi( line + 24 );
+                found ++;
+            }
+            else if( strncmp( line, "nonvoluntary_ctxt_switches:", 27 ) == 0 )
+            {
+                *involuntary = atoi( line + 27 );
+                found ++;
+            }
+        }
+        fclose( file );
+    }
+
+    LEAVE_THREAD_CRITICAL_SECTION
+
+    return found == 2;
+
+#else
+
+    (void) ID;
+    *voluntary = *involuntary = 0;
+    return GL_FALSE;
+
+#endif
+}
+
+
+//========================================================================
+// Create a mutual exclusion object. Adaptive mutexes need futexes; without
+// them, all mutexes are pthread mutexes.
+//========================================================================
+
+GLFWmutex _glfwPlatformCreateMutex( int mode )
+{
+#ifdef _GLFW_HAS_PTHREAD
+
+    _GLFWmutex_x11 *m;
+    size_t         size;
+
+    // Round the size up to whole cache lines, so that no other data
+    // shares the line with the lock
+    size = (sizeof(_GLFWmutex_x11) + _GLFW_CACHE_LINE - 1) &
+           ~(size_t) (_GLFW_CACHE_LINE - 1);
+    if( posix_memalign( (void **) &m, _GLFW_CACHE_LINE, size ) != 0 )
+    {
+        return NULL;
+    }
+
+    m->state    = 0;
+    m->spins    = 0;
+#ifdef _GLFW_HAS_FUTEX
+    m->adaptive = (mode == GLFW_MUTEX_ADAPTIVE);
+#else
+    (void) mode;
+    m->adaptive = GL_FALSE;
+#endif
+
+    // Spinning only helps if the lock holder can run at the same time
+    m->spinLimit = _glfwPlatformGetNumberOfProcessors() > 1 ?
+                   _GLFW_MUTEX_SPIN : 0;
+
+    if( !m->adaptive )
+    {
+        (void) pthread_mutex_init( &m->mutex, NULL );
+    }
+
+    return (GLFWmutex) m;
+
+#else
+
+    (void) mode;
+    return (GLFWmutex) 0;
+
+#endif // _GLFW_HAS_PTHREAD
+}
+
+
+//========================================================================
+// Destroy a mutual exclusion object
+//========================================================================
+
+void _glfwPlatformDestroyMutex( GLFWmutex mutex )
+{
+#ifdef _GLFW_HAS_PTHREAD
+
+    _GLFWmutex_x11 *m = (_GLFWmutex_x11 *) mutex;
+
+    if( !m->adaptive )
+    {
+        pthread_mutex_destroy( &m->mutex );
+    }
+
+    free( m );
+
+#endif // _GLFW_HAS_PTHREAD
+}
+
+
+//========================================================================
+// Request access to a mutex
+//========================================================================
+
+void _glfwPlatformLockMutex( GLFWmutex mutex )
+{
+#ifdef _GLFW_HAS_PTHREAD
+
+    _GLFWmutex_x11 *m = (_GLFWmutex_x11 *) mutex;
+
+#ifdef _GLFW_HAS_FUTEX
+    if( m->adaptive )
+    {
+        LockAdaptiveMutex( m );
+        return;
+    }
+#endif
 
     // Wait for mutex to be released
-    (void) pthread_mutex_lock( (pthread_mutex_t *) mutex );
+    (void) pthread_mutex_lock( &m->mutex );
 
 #endif // _GLFW_HAS_PTHREAD
 }
@@ -359,8 +920,49 @@ void _glfwPlatformUnlockMutex( GLFWmutex mutex )
 {
 #ifdef _GLFW_HAS_PTHREAD
 
+    _GLFWmutex_x11 *m = (_GLFWmutex_x11 *) mutex;
+
+#ifdef _GLFW_HAS_FUTEX
+    if( m->adaptive )
+    {
+        // Only make the system call if somebody may be sleeping
+        if( _glfwAtomicExchange( &m->state, 0 ) == 2 )
+        {
+            _glfwPlatformWakeAddress( &m->state, 1 );
+        }
+        return;
+    }
+#endif
+
     // Release mutex
-    pthread_mutex_unlock( (pthread_mutex_t *) mutex );
+    pthread_mutex_unlock( &m->mutex );
+
+#endif // _GLFW_HAS_PTHREAD
+}
+
+
+//========================================================================
+// Lock a mutex if it is free. Returns GL_TRUE if the mutex was locked.
+//========================================================================
+
+int _glfwPlatformTryLockMutex( GLFWmutex mutex )
+{
+#ifdef _GLFW_HAS_PTHREAD
+
+    _GLFWmutex_x11 *m = (_GLFWmutex_x11 *) mutex;
+
+#ifdef _GLFW_HAS_FUTEX
+    if( m->adaptive )
+    {
+        return _glfwAtomicCompareExchange( &m->state, 0, 1 );
+    }
+#endif
+
+    return pthread_mutex_trylock( &m->mutex ) == 0;
+
+#else
+
+    return GL_TRUE;
 
 #endif // _GLFW_HAS_PTHREAD
 }
@@ -372,7 +974,11 @@ void _glfwPlatformUnlockMutex( GLFWmutex mutex )
 
 GLFWcond _glfwPlatformCreateCond( void )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_FUTEX)
+
+    return (GLFWcond) calloc( 1, sizeof(_GLFWcond_x11) );
+
+#elif defined(_GLFW_HAS_PTHREAD)
 
     pthread_cond_t *cond;
 
@@ -384,7 +990,7 @@ GLFWcond _glfwPlatformCreateCond( void )
     }
 
     // Initialise condition variable
-    (void) pthread_cond_init( cond, NULL );
+    InitCond( cond );
 
     // Cast to GLFWcond and return
     return (GLFWcond) cond;
@@ -393,7 +999,7 @@ GLFWcond _glfwPlatformCreateCond( void )
 
     return (GLFWcond) 0;
 
-#endif // _GLFW_HAS_PTHREAD
+#endif
 }
 
 
@@ -403,7 +1009,11 @@ GLFWcond _glfwPlatformCreateCond( void )
 
 void _glfwPlatformDestroyCond( GLFWcond cond )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_FUTEX)
+
+    free( (void *) cond );
+
+#elif defined(_GLFW_HAS_PTHREAD)
 
     // Destroy the condition variable object
     (void) pthread_cond_destroy( (pthread_cond_t *) cond );
@@ -411,7 +1021,7 @@ void _glfwPlatformDestroyCond( GLFWcond cond )
     // Free memory for condition variable object
     free( (void *) cond );
 
-#endif // _GLFW_HAS_PTHREAD
+#endif
 }
 
 
@@ -422,39 +1032,27 @@ void _glfwPlatformDestroyCond( GLFWcond cond )
 void _glfwPlatformWaitCond( GLFWcond cond, GLFWmutex mutex,
     double timeout )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_FUTEX)
 
-    struct timeval  currenttime;
-    struct timespec wait;
-    long dt_sec, dt_usec;
+    _GLFWcond_x11 *c = (_GLFWcond_x11 *) cond;
+    int           seq;
 
-    // Select infinite or timed wait
-    if( timeout >= GLFW_INFINITY )
-    {
-        // Wait for condition (infinite wait)
-        (void) pthread_cond_wait( (pthread_cond_t *) cond,
-                  (pthread_mutex_t *) mutex );
-    }
-    else
-    {
-        // Set timeout time, relatvie to current time
-        gettimeofday( &currenttime, NULL );
-        dt_sec  = (long) timeout;
-        dt_usec = (long) ((timeout - (double)dt_sec) * 1000000.0);
-        wait.tv_nsec = (currenttime.tv_usec + dt_usec) * 1000L;
-        if( wait.tv_nsec > 1000000000L )
-        {
-            wait.tv_nsec -= 1000000000L;
-            dt_sec ++;
-        }
-        wait.tv_sec  = currenttime.tv_sec + dt_sec;
+    // A signal after this point changes the sequence number, so the wait
+    // below returns at once instead of missing it
+    (void) _glfwAtomicAdd( &c->waiters, 1 );
+    seq = _glfwAtomicLoad( &c->seq );
 
-        // Wait for condition (timed wait)
-        (void) pthread_cond_timedwait( (pthread_cond_t *) cond,
-                   (pthread_mutex_t *) mutex, &wait );
-    }
+    _glfwPlatformUnlockMutex( mutex );
+    _glfwPlatformWaitAddress( &c->seq, seq, timeout );
+    (void) _glfwAtomicAdd( &c->waiters, -1 );
+    _glfwPlatformLockMutex( mutex );
 
-#endif // _GLFW_HAS_PTHREAD
+#elif defined(_GLFW_HAS_PTHREAD)
+
+    TimedWaitCond( (pthread_cond_t *) cond,
+                   &((_GLFWmutex_x11 *) mutex)->mutex, timeout );
+
+#endif
 }
 
 
@@ -464,12 +1062,22 @@ void _glfwPlatformWaitCond( GLFWcond cond, GLFWmutex mutex,
 
 void _glfwPlatformSignalCond( GLFWcond cond )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_FUTEX)
+
+    _GLFWcond_x11 *c = (_GLFWcond_x11 *) cond;
+
+    (void) _glfwAtomicAdd( &c->seq, 1 );
+    if( _glfwAtomicLoad( &c->waiters ) > 0 )
+    {
+        _glfwPlatformWakeAddress( &c->seq, 1 );
+    }
+
+#elif defined(_GLFW_HAS_PTHREAD)
 
     // Signal condition
     (void) pthread_cond_signal( (pthread_cond_t *) cond );
 
-#endif // _GLFW_HAS_PTHREAD
+#endif
 }
 
 
@@ -479,12 +1087,22 @@ void _glfwPlatformSignalCond( GLFWcond cond )
 
 void _glfwPlatformBroadcastCond( GLFWcond cond )
 {
-#ifdef _GLFW_HAS_PTHREAD
+#if defined(_GLFW_HAS_FUTEX)
+
+    _GLFWcond_x11 *c = (_GLFWcond_x11 *) cond;
+
+    (void) _glfwAtomicAdd( &c->seq, 1 );
+    if( _glfwAtomicLoad( &c->waiters ) > 0 )
+    {
+        _glfwPlatformWakeAddress( &c->seq, 0 );
+    }
+
+#elif defined(_GLFW_HAS_PTHREAD)
 
     // Broadcast condition
     (void) pthread_cond_broadcast( (pthread_cond_t *) cond );
 
-#endif // _GLFW_HAS_PTHREAD
+#endif
 }
 
 
@@ -501,3 +1119,561 @@ int _glfwPlatformGetNumberOfProcessors( void )
     return n;
 }
 
+
+//========================================================================
+// Read the first number in a file, which may be a plain number or a list
+// of processors such as "0-3,8-11" (whose lowest member comes first)
+//========================================================================
+
+static int ReadFirstNumber( const char *path, int *value )
+{
+    FILE *file;
+    int  found;
+
+    file = fopen( path, "r" );
+    if( file == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    found = fscanf( file, "%d", value ) == 1;
+    fclose( file );
+
+    return found;
+}
+
+
+//========================================================================
+// Mark the processors in a list such as "0-3,8-11" in the set, and
+// return how many were marked
+//========================================================================
+
+static int ParseCPUList( const char *list, unsigned char *set )
+{
+    char *end;
+    long first, last;
+    int  count = 0;
+
+    for( ;; )
+    {
+        first = strtol( list, &end, 10 );
+        if( end == list )
+        {
+            break;
+        }
+
+        last = first;
+        if( *end == '-' )
+        {
+            list = end + 1;
+            last = strtol( list, &end, 10 );
+        }
+
+        for( ;  first <= last && first < _GLFW_MAX_CPUS;  first ++ )
+        {
+            if( first >= 0 && !set[ first ] )
+            {
+                set[ first ] = 1;
+                count ++;
+            }
+        }
+
+        if( *end != ',' )
+        {
+            break;
+        }
+        list = end + 1;
+    }
+
+    return count;
+}
+
+
+//========================================================================
+// Mark the processors the process may run on. This is the affinity mask,
+// which also reflects any cpuset the process was confined to.
+//========================================================================
+
+static int GetAllowedCPUs( unsigned char *set )
+{
+    char line[ 4096 ];
+    FILE *file;
+    int  count = 0;
+
+    file = fopen( "/proc/self/status", "r" );
+    if( file != NULL )
+    {
+        while( fgets( line, sizeof(line), file ) != NULL )
+        {
+            if( strncmp( line, "Cpus_allowed_list:", 18 ) == 0 )
+            {
+                count = ParseCPUList( line + 18, set );
+                break;
+            }
+        }
+        fclose( file );
+    }
+
+    if( count == 0 )
+    {
+        // Without procfs, settle for the processors that are online
+        file = fopen( "/sys/devices/system/cpu/online", "r" );
+        if( file != NULL )
+        {
+            if( fgets( line, sizeof(line), file ) != NULL )
+            {
+                count = ParseCPUList( line, set );
+            }
+            fclose( file );
+        }
+    }
+
+    return count;
+}
+
+
+//========================================================================
+// Read a cgroup v2 cpu.max file, which holds either "max" or the quota,
+// followed by the period (both in microseconds)
+//========================================================================
+
+static int ReadQuota( const char *path, long long *quota, long long *period )
+{
+    FILE *file;
+    int  found;
+
+    file = fopen( path, "r" );
+    if( file == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    found = fscanf( file, "%lld %lld", quota, period ) == 2 &&
+            *quota > 0 && *period > 0;
+    fclose( file );
+
+    return found;
+}
+
+
+//========================================================================
+// Return the number of processors' worth of CPU time the process may use
+// according to its control group (as set by container runtimes), or zero
+// if there is no such limit
+//========================================================================
+
+static int GetCPUQuota( void )
+{
+    char      line[ 512 ], path[ 600 ], *slash;
+    FILE      *file;
+    long long quota, period;
+    int       count, result = 0;
+
+    // With cgroup v2, every group along the path may have a limit
+    file = fopen( "/proc/self/cgroup", "r" );
+    if( file != NULL )
+    {
+        while( fgets( line, sizeof(line), file ) != NULL )
+        {
+            if( strncmp( line, "0::", 3 ) != 0 )
+            {
+                continue;
+            }
+
+            line[ strcspn( line, "\n" ) ] = '\0';
+            if( strcmp( line + 3, "/" ) == 0 )
+            {
+                line[ 3 ] = '\0';
+            }
+
+            for( ;; )
+            {
+                sprintf( path, "/sys/fs/cgroup%s/cpu.max", line + 3 );
+                if( ReadQuota( path, &quota, &period ) )
+                {
+                    count = (int) ((quota + period - 1) / period);
+                    if( result == 0 || count < result )
+                    {
+                        result = count;
+                    }
+                }
+
+                slash = strrchr( line + 3, '/' );
+                if( slash == NULL )
+                {
+                    break;
+                }
+                *slash = '\0';
+            }
+            break;
+        }
+        fclose( file );
+    }
+
+    // With cgroup v1, only look at the group we can see
+    if( result == 0 &&
+        ReadFirstNumber( "/sys/fs/cgroup/cpu/cpu.cfs_quota_us", &count ) &&
+        count > 0 )
+    {
+        quota = count;
+        if( ReadFirstNumber( "/sys/fs/cgroup/cpu/cpu.cfs_period_us", &count ) &&
+            count > 0 )
+        {
+            result = (int) ((quota + count - 1) / count);
+        }
+    }
+
+    return result;
+}
+
+
+//========================================================================
+// Get the processors the process may run on, and what they share, from
+// /proc and /sys. Groups are identified by their lowest numbered member
+// here; glfwGetCPUTopology turns these into indices.
+//========================================================================
+
+int _glfwPlatformGetCPUTopology( GLFWcputopology *topology )
+{
+    unsigned char *allowed;
+    char          path[ 128 ];
+    DIR           *dir;
+    struct dirent *entry;
+    GLFWprocessor *p;
+    int           cpu, count, index, level, key;
+
+    allowed = (unsigned char *) calloc( _GLFW_MAX_CPUS, 1 );
+    if( allowed == NULL )
+    {
+        return GL_FALSE;
+    }
+
+    count = GetAllowedCPUs( allowed );
+    if( count == 0 )
+    {
+        free( allowed );
+        return GL_FALSE;
+    }
+
+    topology->Processors = (GLFWprocessor *)
+        calloc( count, sizeof(GLFWprocessor) );
+    if( topology->Processors == NULL )
+    {
+        free( allowed );
+        return GL_FALSE;
+    }
+
+    p = topology->Processors;
+    for( cpu = 0;  cpu < _GLFW_MAX_CPUS;  cpu ++ )
+    {
+        if( !allowed[ cpu ] )
+        {
+            continue;
+        }
+
+        p->ID = cpu;
+
+        // SMT siblings share a core
+        sprintf( path, "/sys/devices/system/cpu/cpu%d/topology/"
+                 "thread_siblings_list", cpu );
+        if( !ReadFirstNumber( path, &p->Core ) )
+        {
+            p->Core = cpu;
+        }
+
+        sprintf( path, "/sys/devices/system/cpu/cpu%d/topology/"
+                 "physical_package_id", cpu );
+        if( !ReadFirstNumber( path, &p->Package ) )
+        {
+            p->Package = 0;
+        }
+
+        // Without cache information, assume a private L2 per core and a
+        // shared L3 per package
+        p->L2Group = p->Core;
+        p->L3Group = -1 - p->Package;
+
+        for( index = 0;  ;  index ++ )
+        {
+            sprintf( path, "/sys/devices/system/cpu/cpu%d/cache/index%d/"
+                     "level", cpu, index );
+            if( !ReadFirstNumber( path, &level ) )
+            {
+                break;
+            }
+
+            if( level != 2 && level != 3 )
+            {
+                continue;
+            }
+
+            sprintf( path, "/sys/devices/system/cpu/cpu%d/cache/index%d/"
+                     "shared_cpu_list", cpu, index );
+            if( ReadFirstNumber( path, &key ) )
+            {
+                if( level == 2 )
+                {
+                    p->L2Group = key;
+                }
+                else
+                {
+                    p->L3Group = key;
+                }
+            }
+        }
+
+        // The processor directory links to its NUMA node
+        p->Node = 0;
+        sprintf( path, "/sys/devices/system/cpu/cpu%d", cpu );
+        dir = opendir( path );
+        if( dir != NULL )
+        {
+            while( (entry = readdir( dir )) != NULL )
+            {
+                if( sscanf( entry->d_name, "node%d", &key ) == 1 )
+                {
+                    p->Node = key;
+                    break;
+                }
+            }
+            closedir( dir );
+        }
+
+        p ++;
+    }
+
+    free( allowed );
+
+    topology->Count = count;
+    topology->Quota = GetCPUQuota();
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Wait until the int at the given address no longer holds the given value
+// (or until woken, or the timeout expires). Callers must re-check their
+// condition, as spurious wake-ups are allowed.
+//========================================================================
+
+void _glfwPlatformWaitAddress( volatile int *address, int value,
+    double timeout )
+{
+#if defined(_GLFW_HAS_FUTEX)
+
+    struct timespec wait, *waitp = NULL;
+
+    if( timeout < GLFW_INFINITY )
+    {
+        if( timeout <= 0.0 )
+        {
+            return;
+        }
+        wait.tv_sec  = (time_t) timeout;
+        wait.tv_nsec = (long) ((timeout - (double) wait.tv_sec) * 1e9);
+        waitp = &wait;
+    }
+
+    (void) syscall( SYS_futex, address, FUTEX_WAIT_PRIVATE, value, waitp,
+                    NULL, 0 );
+
+#elif defined(_GLFW_HAS_PTHREAD)
+
+    (void) pthread_once( &_glfwWaitBucketsOnce, InitWaitBuckets );
+
+    pthread_mutex_lock( &WAIT_BUCKET( address )->mutex );
+    if( *address == value )
+    {
+        TimedWaitCond( &WAIT_BUCKET( address )->cond,
+                       &WAIT_BUCKET( address )->mutex, timeout );
+    }
+    pthread_mutex_unlock( &WAIT_BUCKET( address )->mutex );
+
+#endif
+}
+
+
+//========================================================================
+// Wake up to count threads waiting on the given address (the waker must
+// change the value at the address before calling this)
+//========================================================================
+
+void _glfwPlatformWakeAddress( volatile int *address, int count )
+{
+#if defined(_GLFW_HAS_FUTEX)
+
+    (void) syscall( SYS_futex, address, FUTEX_WAKE_PRIVATE,
+                    count < 1 ? INT_MAX : count, NULL, NULL, 0 );
+
+#elif defined(_GLFW_HAS_PTHREAD)
+
+    (void) count;
+    (void) pthread_once( &_glfwWaitBucketsOnce, InitWaitBuckets );
+
+    // Other addresses may share the bucket, so everyone must be woken
+    pthread_mutex_lock( &WAIT_BUCKET( address )->mutex );
+    (void) pthread_cond_broadcast( &WAIT_BUCKET( address )->cond );
+    pthread_mutex_unlock( &WAIT_BUCKET( address )->mutex );
+
+#endif
+}
+
+
+//========================================================================
+// Set the internal data pointer of the calling thread
+//========================================================================
+
+void _glfwPlatformSetThreadData( void *data )
+{
+#if defined(_GLFW_HAS_TLS)
+    _glfwCurrentThreadData = data;
+#elif defined(_GLFW_HAS_PTHREAD)
+    (void) pthread_setspecific( _glfwThrd.DataKey, data );
+#else
+    (void) data;
+#endif
+}
+
+
+//========================================================================
+// Return the internal data pointer of the calling thread
+//========================================================================
+
+void * _glfwPlatformGetThreadData( void )
+{
+#if defined(_GLFW_HAS_TLS)
+    return _glfwCurrentThreadData;
+#elif defined(_GLFW_HAS_PTHREAD)
+    return pthread_getspecific( _glfwThrd.DataKey );
+#else
+    return NULL;
+#endif
+}
+
+
+//========================================================================
+// Create a fiber that will call fun( arg ) when first switched to. The
+// stack gets a guard page, so that overflows fault instead of silently
+// corrupting memory.
+//========================================================================
+
+void * _glfwPlatformCreateFiber( void (*fun)( void * ), void *arg,
+                                 size_t stacksize )
+{
+#ifdef _GLFW_HAS_UCONTEXT
+
+    _GLFWfiber_x11 *fiber;
+    size_t         page;
+
+    fiber = (_GLFWfiber_x11 *) malloc( sizeof(_GLFWfiber_x11) );
+    if( fiber == NULL )
+    {
+        return NULL;
+    }
+
+    page = (size_t) sysconf( _SC_PAGESIZE );
+    fiber->size  = (stacksize + page - 1) / page * page + page;
+    fiber->stack = mmap( NULL, fiber->size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( fiber->stack == MAP_FAILED )
+    {
+        free( fiber );
+        return NULL;
+    }
+    (void) mprotect( fiber->stack, page, PROT_NONE );
+
+    fiber->fun = fun;
+    fiber->arg = arg;
+
+    if( !InitFiberContext( fiber, page ) )
+    {
+        munmap( fiber->stack, fiber->size );
+        free( fiber );
+        return NULL;
+    }
+
+    return fiber;
+
+#else
+
+    (void) fun;
+    (void) arg;
+    (void) stacksize;
+    return NULL;
+
+#endif // _GLFW_HAS_UCONTEXT
+}
+
+
+//========================================================================
+// Turn the calling thread's own context into a fiber, so that it can be
+// switched away from and back to
+//========================================================================
+
+void * _glfwPlatformConvertThreadToFiber( void )
+{
+#ifdef _GLFW_HAS_UCONTEXT
+
+    // The context is filled in when we first switch away from it
+    return calloc( 1, sizeof(_GLFWfiber_x11) );
+
+#else
+
+    return NULL;
+
+#endif // _GLFW_HAS_UCONTEXT
+}
+
+
+//========================================================================
+// Release a fiber created by _glfwPlatformConvertThreadToFiber (which
+// must be the one running)
+//========================================================================
+
+void _glfwPlatformConvertFiberToThread( void *fiber )
+{
+    free( fiber );
+}
+
+
+//========================================================================
+// Save the running context in from and continue with to
+//========================================================================
+
+void _glfwPlatformSwitchFiber( void *from, void *to )
+{
+#ifdef _GLFW_HAS_UCONTEXT
+
+    (void) swapcontext( &((_GLFWfiber_x11 *) from)->context,
+                        &((_GLFWfiber_x11 *) to)->context );
+
+#else
+
+    (void) from;
+    (void) to;
+
+#endif // _GLFW_HAS_UCONTEXT
+}
+
+
+//========================================================================
+// Destroy a fiber created by _glfwPlatformCreateFiber (which must not be
+// running)
+//========================================================================
+
+void _glfwPlatformDestroyFiber( void *handle )
+{
+#ifdef _GLFW_HAS_UCONTEXT
+
+    _GLFWfiber_x11 *fiber = (_GLFWfiber_x11 *) handle;
+
+    munmap( fiber->stack, fiber->size );
+    free( fiber );
+
+#else
+
+    (void) handle;
+
+#endif // _GLFW_HAS_UCONTEXT
+}
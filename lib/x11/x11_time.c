@@ -30,8 +30,13 @@
 
 #include "internal.h"
 
+#include <errno.h>
 #include <time.h>
 
+#if defined(_GLFW_HAS_PRCTL)
+ #include <sys/prctl.h>
+#endif
+
 
 //========================================================================
 // Return raw time
@@ -114,61 +119,87 @@ void _glfwPlatformSetTime( double time )
 
 void _glfwPlatformSleep( double time )
 {
-#ifdef _GLFW_HAS_PTHREAD
+    struct timespec wait;
 
-    if( time == 0.0 )
+    if( time <= 0.0 )
     {
 #ifdef _GLFW_HAS_SCHED_YIELD
-	sched_yield();
+        sched_yield();
 #endif
-	return;
+        return;
     }
 
-    struct timeval  currenttime;
-    struct timespec wait;
-    pthread_mutex_t mutex;
-    pthread_cond_t  cond;
-    long dt_sec, dt_usec;
-
-    // Not all pthread implementations have a pthread_sleep() function. We
-    // do it the portable way, using a timed wait for a condition that we
-    // will never signal. NOTE: The unistd functions sleep/usleep suspends
-    // the entire PROCESS, not a signle thread, which is why we can not
-    // use them to implement glfwSleep.
-
-    // Set timeout time, relatvie to current time
-    gettimeofday( &currenttime, NULL );
-    dt_sec  = (long) time;
-    dt_usec = (long) ((time - (double)dt_sec) * 1000000.0);
-    wait.tv_nsec = (currenttime.tv_usec + dt_usec) * 1000L;
-    if( wait.tv_nsec > 1000000000L )
+    // Unlike sleep and usleep, the nanosleep functions are required to
+    // suspend only the calling thread, and they need no mutex or condition
+    // variable to do so
+#if defined(_GLFW_HAS_MONOTONIC_WAIT)
+
+    // Sleep until an absolute time on the monotonic clock, so that a
+    // signal handler interrupting the sleep does not make it drift, and
+    // setting the wall clock does not affect it
+    clock_gettime( CLOCK_MONOTONIC, &wait );
+    wait.tv_sec  += (time_t) time;
+    wait.tv_nsec += (long) ((time - (double) (time_t) time) * 1e9);
+    if( wait.tv_nsec >= 1000000000L )
     {
         wait.tv_nsec -= 1000000000L;
-        dt_sec++;
+        wait.tv_sec ++;
     }
-    wait.tv_sec  = currenttime.tv_sec + dt_sec;
 
-    // Initialize condition and mutex objects
-    pthread_mutex_init( &mutex, NULL );
-    pthread_cond_init( &cond, NULL );
+    while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &wait,
+                            NULL ) == EINTR )
+    {
+    }
 
-    // Do a timed wait
-    pthread_mutex_lock( &mutex );
-    pthread_cond_timedwait( &cond, &mutex, &wait );
-    pthread_mutex_unlock( &mutex );
+#else
 
-    // Destroy condition and mutex objects
-    pthread_mutex_destroy( &mutex );
-    pthread_cond_destroy( &cond );
+    wait.tv_sec  = (time_t) time;
+    wait.tv_nsec = (long) ((time - (double) wait.tv_sec) * 1e9);
 
-#else
+    while( nanosleep( &wait, &wait ) == -1 && errno == EINTR )
+    {
+    }
+
+#endif
+}
+
+
+//========================================================================
+// Make sleeps of the calling thread as precise as possible, until the
+// matching call to _glfwPlatformEndPreciseSleep. By default, Linux lets
+// the wake-up of a thread slip by up to 50 microseconds, so that timers
+// can be batched; the timer slack of the thread is lowered meanwhile.
+//========================================================================
+
+int _glfwPlatformBeginPreciseSleep( void )
+{
+#if defined(_GLFW_HAS_PRCTL) && defined(PR_SET_TIMERSLACK)
+    int slack;
 
-    // For systems without PTHREAD, use unistd usleep
-    if( time > 0 )
+    slack = prctl( PR_GET_TIMERSLACK, 0, 0, 0, 0 );
+    if( slack > 1 )
     {
-        usleep( (unsigned int) (time*1000000) );
+        (void) prctl( PR_SET_TIMERSLACK, 1, 0, 0, 0 );
+        return slack;
     }
+#endif
 
-#endif // _GLFW_HAS_PTHREAD
+    return 0;
 }
 
+
+//========================================================================
+// Restore the timer slack saved by _glfwPlatformBeginPreciseSleep
+//========================================================================
+
+void _glfwPlatformEndPreciseSleep( int state )
+{
+#if defined(_GLFW_HAS_PRCTL) && defined(PR_SET_TIMERSLACK)
+    if( state > 0 )
+    {
+        (void) prctl( PR_SET_TIMERSLACK, state, 0, 0, 0 );
+    }
+#else
+    (void) state;
+#endif
+}
@@ -0,0 +1,123 @@
+//========================================================================
+// Sleep precision benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test measures how late glfwSleep and glfwSleepPrecise wake up for
+// a range of sleep times, and how much a frame limiter built on
+// glfwSleepUntil jitters. All errors are reported in microseconds.
+//
+//========================================================================
+
+#include <GL/glfw.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLES 200
+
+static const double durations[] = { 0.0005, 0.001, 0.002, 0.005, 0.0166667 };
+
+static int compare_doubles(const void* a, const void* b)
+{
+    const double x = *(const double*) a;
+    const double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+static void report(const char* name, double duration, double* errors, int count)
+{
+    int i;
+    double sum = 0.0;
+
+    qsort(errors, count, sizeof(double), compare_doubles);
+
+    for (i = 0;  i < count;  i++)
+        sum += errors[i];
+
+    printf("%-8s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n",
+           name,
+           duration * 1e6,
+           errors[0] * 1e6,
+           errors[count / 2] * 1e6,
+           sum / count * 1e6,
+           errors[count * 99 / 100] * 1e6,
+           errors[count - 1] * 1e6);
+}
+
+static void measure(const char* name, void (GLFWAPIENTRY *sleep_fun)(double))
+{
+    int i, j;
+    double start, errors[SAMPLES];
+
+    for (i = 0;  (size_t) i < sizeof(durations) / sizeof(durations[0]);  i++)
+    {
+        for (j = 0;  j < SAMPLES;  j++)
+        {
+            start = glfwGetTime();
+            sleep_fun(durations[i]);
+            errors[j] = glfwGetTime() - start - durations[i];
+        }
+
+        report(name, durations[i], errors, SAMPLES);
+    }
+}
+
+static void measure_frames(double period)
+{
+    int i;
+    double deadline, errors[SAMPLES];
+
+    // Deadlines are a fixed period apart, so lateness does not accumulate
+    deadline = glfwGetTime();
+
+    for (i = 0;  i < SAMPLES;  i++)
+    {
+        deadline += period;
+        glfwSleepUntil(deadline);
+        errors[i] = glfwGetTime() - deadline;
+    }
+
+    report("until", period, errors, SAMPLES);
+}
+
+int main(void)
+{
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-8s %8s %8s %8s %8s %8s %8s\n",
+           "function", "sleep", "min", "median", "mean", "99%", "max");
+
+    measure("sleep", glfwSleep);
+    measure("precise", glfwSleepPrecise);
+
+    measure_frames(0.0166667);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}